@@ -0,0 +1,441 @@
+/* Virtual M68000 Toolkit
+   Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307
+   USA.  */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+#include <vm68k/aot>
+
+#include <ltdl.h>
+#include <algorithm>
+#include <cassert>
+
+using std::FILE;
+using std::fprintf;
+using std::size_t;
+using std::vector;
+
+namespace
+{
+  using namespace vx68k;
+
+  /* Function codes that may write code.  */
+  const int CODE_WRITERS =
+    1 << vm68k_bus::USER_DATA | 1 << vm68k_bus::SUPER_DATA;
+
+  /* Returns the hash of the code of block B on BUS.  Throws a bus
+     error if the code cannot be read.  */
+  unsigned long long
+  block_hash (const vm68k_bus *bus, vm68k_bus::function_code func,
+              const vm68k_compiled_block_entry &b, unsigned long long h)
+  {
+    vector<unsigned char> data (b.end - b.start);
+    if (!data.empty ())
+      {
+        bus->read (func, b.start, &data[0], data.size ());
+        h = vm68k_compiled_code::hash (&data[0], data.size (), h);
+      }
+    return h;
+  }
+
+  /* Writes the function of block B in CODE.  */
+  void write_block (FILE *stream, const vm68k_disassembler *d,
+                    const vm68k_code_image &code,
+                    const vm68k_control_flow_graph::block &b)
+  {
+    fprintf (stream, "  vm68k_address_t\n"
+             "  block_%08lx (vm68k_context *c, const vm68k_instruction *h,\n"
+             "                  vm68k_compiled_frame *f)\n"
+             "  {\n"
+             "    vm68k_address_t pc;\n",
+             (unsigned long) b.start);
+
+    vm68k_address_t a = b.start;
+    for (;;)
+      {
+        char text[vm68k_disassembler::TEXT_MAX + 1];
+        char *p = text;
+        vm68k_address_t next = d->write (code, a, p);
+        *p = '\0';
+
+        unsigned int w = code.fetch_word (a);
+        fprintf (stream, "    // %08lx\t%s\n", (unsigned long) a, text);
+        if (a == b.start)
+          {
+            fprintf (stream, "    f->begin (c, %#lx, %#x);\n",
+                     (unsigned long) a, w);
+          }
+        else
+          {
+            fprintf (stream, "    if (!f->start (c, %#lx, %#x))\n"
+                     "      return %#lx;\n",
+                     (unsigned long) a, w, (unsigned long) a);
+          }
+
+        // The last instruction may go anywhere.  Any other goes to
+        // the next unless its handler is replaced by a stub or a fused
+        // one.
+        fprintf (stream, "    pc = h[%#x] (%#lx, %#x, c);\n",
+                 w, (unsigned long) (a + 2), w);
+        if (a == b.last)
+          {
+            break;
+          }
+        fprintf (stream, "    if (pc != %#lx)\n"
+                 "      return pc;\n", (unsigned long) next);
+        a = next;
+      }
+
+    fprintf (stream, "    return pc;\n"
+             "  }\n"
+             "\n");
+  }
+}
+
+namespace vx68k
+{
+  const char *const vm68k_compiled_code::SYMBOL = "vm68k_compiled_blocks";
+
+  unsigned long long vm68k_compiled_code::hash (const unsigned char *data,
+                                                size_t size,
+                                                unsigned long long h)
+  {
+    // This is the 64-bit FNV-1a hash.
+    for (size_t i = 0; i != size; ++i)
+      {
+        h ^= data[i];
+        h *= 0x100000001b3ULL;
+      }
+    return h;
+  }
+
+  void vm68k_compiled_code::write_source (FILE *stream,
+                                          const vm68k_control_flow_graph &g)
+  {
+    typedef vm68k_control_flow_graph::block_map block_map;
+    const block_map &blocks = g.blocks ();
+
+    fprintf (stream, "/* Generated from %lu blocks of guest code.  */\n"
+             "\n"
+             "#include <vm68k/aot>\n"
+             "\n"
+             "using namespace vx68k;\n"
+             "\n"
+             "namespace\n"
+             "{\n", (unsigned long) blocks.size ());
+    for (block_map::const_iterator i = blocks.begin ();
+         i != blocks.end (); ++i)
+      {
+        const vm68k_control_flow_graph::block &b = i->second;
+        write_block (stream, g.disassembler (), g.find_image (b.start), b);
+      }
+
+    // The tables end with a null entry so that they are never empty.
+    fprintf (stream, "  const vm68k_compiled_block_entry blocks[] =\n"
+             "  {\n");
+    for (block_map::const_iterator i = blocks.begin ();
+         i != blocks.end (); ++i)
+      {
+        const vm68k_control_flow_graph::block &b = i->second;
+        fprintf (stream, "    {%#lx, %#lx, &block_%08lx},\n",
+                 (unsigned long) b.start, (unsigned long) b.end,
+                 (unsigned long) b.start);
+      }
+    fprintf (stream, "    {0, 0, 0}\n"
+             "  };\n"
+             "\n"
+             "  const vm68k_compiled_page_entry pages[] =\n"
+             "  {\n");
+
+    // The blocks are in address order, so those of a page are
+    // together.
+    unsigned long page_count = 0;
+    block_map::const_iterator i = blocks.begin ();
+    unsigned long first = 0;
+    while (i != blocks.end ())
+      {
+        vm68k_address_t page = i->first & ~(vm68k_address_t) (PAGE_SIZE - 1);
+        unsigned long count = 0;
+        unsigned long long h = INITIAL_HASH;
+        for (; i != blocks.end ()
+               && (i->first & ~(vm68k_address_t) (PAGE_SIZE - 1)) == page;
+             ++i)
+          {
+            const vm68k_control_flow_graph::block &b = i->second;
+            vm68k_code_image code = g.find_image (b.start);
+            for (vm68k_address_t a = b.start; a != b.end; a += 2)
+              {
+                uint_fast16_t w = code.fetch_word (a);
+                unsigned char data[2];
+                data[0] = w >> 8;
+                data[1] = w;
+                h = hash (data, 2, h);
+              }
+            ++count;
+          }
+
+        fprintf (stream, "    {%#lx, %#018llxULL, %lu, %lu},\n",
+                 (unsigned long) page, h, first, count);
+        first += count;
+        ++page_count;
+      }
+    fprintf (stream, "    {0, 0, 0, 0}\n"
+             "  };\n"
+             "}\n"
+             "\n"
+             "extern \"C\" const vm68k_compiled_image %s =\n"
+             "{\n"
+             "  vm68k_compiled_image::VERSION, %lu, pages, blocks\n"
+             "};\n", SYMBOL, page_count);
+  }
+
+  vm68k_compiled_code::vm68k_compiled_code ()
+  {
+    _handle = NULL;
+    _image = NULL;
+    _bus = NULL;
+    _drops = 0;
+  }
+
+  vm68k_compiled_code::~vm68k_compiled_code ()
+  {
+    this->close ();
+  }
+
+  bool vm68k_compiled_code::open (const char *name)
+  {
+    this->close ();
+
+    if (lt_dlinit () != 0)
+      {
+        return false;
+      }
+
+    lt_dlhandle handle = lt_dlopenext (name);
+    if (handle == NULL)
+      {
+        lt_dlexit ();
+        return false;
+      }
+
+    const vm68k_compiled_image *image =
+      static_cast<const vm68k_compiled_image *> (lt_dlsym (handle, SYMBOL));
+    if (image == NULL || image->version != vm68k_compiled_image::VERSION)
+      {
+        lt_dlclose (handle);
+        lt_dlexit ();
+        return false;
+      }
+
+    _handle = handle;
+    _image = image;
+    return true;
+  }
+
+  void vm68k_compiled_code::open (const vm68k_compiled_image *image)
+  {
+    assert (image != NULL);
+    assert (image->version == vm68k_compiled_image::VERSION);
+    this->close ();
+
+    _image = image;
+  }
+
+  void vm68k_compiled_code::close ()
+  {
+    this->unbind ();
+    if (_handle != NULL)
+      {
+        lt_dlclose (static_cast<lt_dlhandle> (_handle));
+        lt_dlexit ();
+        _handle = NULL;
+      }
+    _image = NULL;
+  }
+
+  size_t vm68k_compiled_code::bind (vm68k_bus *bus,
+                                    vm68k_bus::function_code func)
+  {
+    assert (bus != NULL);
+    this->unbind ();
+    if (_image == NULL)
+      {
+        return 0;
+      }
+
+    for (uint_fast32_t i = 0; i != _image->page_count; ++i)
+      {
+        const vm68k_compiled_page_entry &page = _image->pages[i];
+        const vm68k_compiled_block_entry *first = _image->blocks + page.first;
+        const vm68k_compiled_block_entry *last = first + page.count;
+
+        unsigned long long h = INITIAL_HASH;
+        try
+          {
+            for (const vm68k_compiled_block_entry *b = first; b != last; ++b)
+              {
+                h = block_hash (bus, func, *b, h);
+              }
+          }
+        catch (const vm68k_bus_error &)
+          {
+            continue;
+          }
+        if (h != page.hash)
+          {
+            continue;
+          }
+
+        _enabled.push_back (i);
+        for (const vm68k_compiled_block_entry *b = first; b != last; ++b)
+          {
+            bus->mark_code (CODE_WRITERS, b->start, b->end - b->start,
+                            this);
+          }
+      }
+
+    _bus = bus;
+    _bus->add_code_listener (this);
+    this->rehash ();
+    return _enabled.size ();
+  }
+
+  void vm68k_compiled_code::unbind ()
+  {
+    if (_bus != NULL)
+      {
+        // Only the marks of this code are cleared, including those
+        // left by the pages that were dropped.
+        for (uint_fast32_t i = 0; i != _image->page_count; ++i)
+          {
+            const vm68k_compiled_page_entry &page = _image->pages[i];
+            const vm68k_compiled_block_entry *first =
+              _image->blocks + page.first;
+            const vm68k_compiled_block_entry *last = first + page.count;
+            for (const vm68k_compiled_block_entry *b = first; b != last;
+                 ++b)
+              {
+                _bus->unmark_code (CODE_WRITERS, b->start,
+                                   b->end - b->start, this);
+              }
+          }
+        _bus->remove_code_listener (this);
+        _bus = NULL;
+      }
+    _enabled.clear ();
+    _table.clear ();
+  }
+
+  void vm68k_compiled_code::code_written (vm68k_bus::function_code,
+                                          vm68k_address_t addr, int size)
+  {
+    // A page is dropped as a whole as its hash no longer holds.
+    vm68k_address_t end = addr + size;
+    vector<uint_least32_t>::iterator k = _enabled.begin ();
+    bool dropped = false;
+    while (k != _enabled.end ())
+      {
+        const vm68k_compiled_page_entry &page = _image->pages[*k];
+        const vm68k_compiled_block_entry *first = _image->blocks + page.first;
+        const vm68k_compiled_block_entry *last = first + page.count;
+
+        bool written = false;
+        for (const vm68k_compiled_block_entry *b = first; b != last; ++b)
+          {
+            if (b->start < end && addr < b->end)
+              {
+                written = true;
+                break;
+              }
+          }
+
+        if (written)
+          {
+            k = _enabled.erase (k);
+            dropped = true;
+          }
+        else
+          {
+            ++k;
+          }
+      }
+
+    if (dropped)
+      {
+        // A block that is running returns before its next instruction.
+        ++_drops;
+        this->rehash ();
+      }
+  }
+
+  void vm68k_compiled_code::rehash ()
+  {
+    size_t n = 0;
+    for (vector<uint_least32_t>::const_iterator k = _enabled.begin ();
+         k != _enabled.end (); ++k)
+      {
+        n += _image->pages[*k].count;
+      }
+
+    _table.clear ();
+    if (n == 0)
+      {
+        return;
+      }
+
+    // The table is kept at most half full.
+    size_t size = 16;
+    while (size < 2 * n)
+      {
+        size *= 2;
+      }
+    slot empty = {0, NULL};
+    _table.resize (size, empty);
+
+    size_t mask = size - 1;
+    for (vector<uint_least32_t>::const_iterator k = _enabled.begin ();
+         k != _enabled.end (); ++k)
+      {
+        const vm68k_compiled_page_entry &page = _image->pages[*k];
+        const vm68k_compiled_block_entry *first = _image->blocks + page.first;
+        const vm68k_compiled_block_entry *last = first + page.count;
+        for (const vm68k_compiled_block_entry *b = first; b != last; ++b)
+          {
+            size_t i = (b->start >> 1) * 0x9e3779b1U & mask;
+            while (_table[i].func != NULL)
+              {
+                i = (i + 1) & mask;
+              }
+            _table[i].addr = b->start;
+            _table[i].func = b->func;
+          }
+      }
+  }
+}
@@ -0,0 +1,72 @@
+/* Virtual M68000 Toolkit
+   Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307
+   USA.  */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/arena>
+
+#include <cassert>
+
+using std::size_t;
+
+namespace vx68k
+{
+  vm68k_arena::vm68k_arena (void *buffer, size_t size)
+  {
+    assert (buffer != NULL || size == 0);
+    _buffer = static_cast<unsigned char *> (buffer);
+    _size = size;
+    _used = 0;
+
+    // The start of the buffer is aligned first.
+    size_t skip = -reinterpret_cast<size_t> (_buffer) & (ALIGNMENT - 1);
+    if (skip > _size)
+      {
+        skip = _size;
+      }
+    _buffer += skip;
+    _size -= skip;
+  }
+
+  void *vm68k_arena::allocate (size_t size)
+  {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (size > _size - _used)
+      {
+        throw std::bad_alloc ();
+      }
+
+    void *p = _buffer + _used;
+    _used += size;
+    return p;
+  }
+}
@@ -38,7 +38,6 @@
 #include <cassert>
 
 using std::string;
-using std::fill;
 
 namespace vx68k
 {
@@ -126,18 +125,611 @@ namespace vx68k
     this->write16 (func, addr + 2, value);
   }
 
+  unsigned char *vm68k_bus::mappable::direct (function_code,
+                                              vm68k_address_t)
+  {
+    return NULL;
+  }
+
+  void vm68k_bus::posted_mappable::write_batch (const posted_write *first,
+                                                const posted_write *last)
+  {
+    for (; first != last; ++first)
+      {
+        switch (first->size)
+          {
+          case 1:
+            this->write8 (first->func, first->address, first->value);
+            break;
+          case 2:
+            this->write16 (first->func, first->address, first->value);
+            break;
+          case 4:
+            this->write32 (first->func, first->address, first->value);
+            break;
+          default:
+            assert (false);
+            break;
+          }
+      }
+  }
+
+  vm68k_bus::filter::filter ()
+  {
+    _next = NULL;
+  }
+
+  uint_fast8_t vm68k_bus::filter::read8 (function_code func,
+                                         vm68k_address_t addr) const
+    throw (vm68k_bus_error)
+  {
+    return _next->read8 (func, addr);
+  }
+
+  uint_fast16_t vm68k_bus::filter::read16 (function_code func,
+                                           vm68k_address_t addr) const
+    throw (vm68k_bus_error)
+  {
+    return _next->read16 (func, addr);
+  }
+
+  uint_fast32_t vm68k_bus::filter::read32 (function_code func,
+                                           vm68k_address_t addr) const
+    throw (vm68k_bus_error)
+  {
+    return _next->read32 (func, addr);
+  }
+
+  void vm68k_bus::filter::write8 (function_code func, vm68k_address_t addr,
+                                  uint_fast8_t value)
+    throw (vm68k_bus_error)
+  {
+    _next->write8 (func, addr, value);
+  }
+
+  void vm68k_bus::filter::write16 (function_code func, vm68k_address_t addr,
+                                   uint_fast16_t value)
+    throw (vm68k_bus_error)
+  {
+    _next->write16 (func, addr, value);
+  }
+
+  void vm68k_bus::filter::write32 (function_code func, vm68k_address_t addr,
+                                   uint_fast32_t value)
+    throw (vm68k_bus_error)
+  {
+    _next->write32 (func, addr, value);
+  }
+
+  vm68k_bus::watch_handler::~watch_handler ()
+  {
+  }
+
+  /* Filter that checks accesses to a watched page.  */
+  class vm68k_bus::watch_filter : public filter
+  {
+  public:
+    watch_filter (vm68k_bus *bus, function_code func, std::size_t page)
+    {
+      _bus = bus;
+      _func = func;
+      _page = page;
+    }
+
+  public:
+    function_code func () const
+    {
+      return _func;
+    }
+
+    std::size_t page () const
+    {
+      return _page;
+    }
+
+  public:
+    uint_fast8_t read8 (function_code func, vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      uint_fast8_t value = this->next ()->read8 (func, addr);
+      _bus->check_watchpoints (func, addr, 1, READ, value);
+      return value;
+    }
+
+    uint_fast16_t read16 (function_code func, vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      uint_fast16_t value = this->next ()->read16 (func, addr);
+      _bus->check_watchpoints (func, addr, 2, READ, value);
+      return value;
+    }
+
+    uint_fast32_t read32 (function_code func, vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      uint_fast32_t value = this->next ()->read32 (func, addr);
+      _bus->check_watchpoints (func, addr, 4, READ, value);
+      return value;
+    }
+
+    void write8 (function_code func, vm68k_address_t addr,
+                 uint_fast8_t value) throw (vm68k_bus_error)
+    {
+      _bus->check_watchpoints (func, addr, 1, WRITE, value);
+      this->next ()->write8 (func, addr, value);
+    }
+
+    void write16 (function_code func, vm68k_address_t addr,
+                  uint_fast16_t value) throw (vm68k_bus_error)
+    {
+      _bus->check_watchpoints (func, addr, 2, WRITE, value);
+      this->next ()->write16 (func, addr, value);
+    }
+
+    void write32 (function_code func, vm68k_address_t addr,
+                  uint_fast32_t value) throw (vm68k_bus_error)
+    {
+      _bus->check_watchpoints (func, addr, 4, WRITE, value);
+      this->next ()->write32 (func, addr, value);
+    }
+
+  private:
+    vm68k_bus *_bus;
+    function_code _func;
+    std::size_t _page;
+  };
+
+  vm68k_bus::code_listener::~code_listener ()
+  {
+  }
+
+  /* Filter that checks writes to a page with code.  The marks are
+     kept for each owner, so that one owner can clear its own marks
+     without clearing those of another on the same words.  */
+  class vm68k_bus::code_filter : public filter
+  {
+  private:
+    struct owner_marks
+    {
+      const code_listener *owner;
+      std::vector<uint_least32_t> marks;
+      std::size_t count;
+    };
+
+  public:
+    code_filter (vm68k_bus *bus, function_code func, std::size_t page)
+    {
+      _bus = bus;
+      _func = func;
+      _page = page;
+      _count = 0;
+    }
+
+  public:
+    function_code func () const
+    {
+      return _func;
+    }
+
+    std::size_t page () const
+    {
+      return _page;
+    }
+
+    /* Returns the number of marks of all the owners.  */
+    std::size_t count () const
+    {
+      return _count;
+    }
+
+    /* Sets or clears the marks of OWNER on SIZE bytes at page offset
+       OFFSET.  */
+    void mark (std::size_t offset, std::size_t size,
+               const code_listener *owner, bool code)
+    {
+      std::vector<owner_marks>::iterator k = _owners.begin ();
+      while (k != _owners.end () && k->owner != owner)
+        {
+          ++k;
+        }
+      if (k == _owners.end ())
+        {
+          if (!code)
+            {
+              return;
+            }
+          owner_marks m;
+          m.owner = owner;
+          m.marks.resize (PAGE_SIZE / 2 / 32);
+          m.count = 0;
+          k = _owners.insert (k, m);
+        }
+
+      this->mark_words (*k, offset, size, code);
+      if (k->count == 0)
+        {
+          _owners.erase (k);
+        }
+    }
+
+    /* Clears the marks of all the owners on SIZE bytes at page offset
+       OFFSET.  Returns true if any mark was set before.  */
+    bool clear (std::size_t offset, std::size_t size)
+    {
+      bool marked = false;
+      std::vector<owner_marks>::iterator k = _owners.begin ();
+      while (k != _owners.end ())
+        {
+          marked = this->mark_words (*k, offset, size, false) || marked;
+          if (k->count == 0)
+            {
+              k = _owners.erase (k);
+            }
+          else
+            {
+              ++k;
+            }
+        }
+      return marked;
+    }
+
+  public:
+    void write8 (function_code func, vm68k_address_t addr,
+                 uint_fast8_t value) throw (vm68k_bus_error)
+    {
+      this->next ()->write8 (func, addr, value);
+      this->check (func, addr, 1);
+    }
+
+    void write16 (function_code func, vm68k_address_t addr,
+                  uint_fast16_t value) throw (vm68k_bus_error)
+    {
+      this->next ()->write16 (func, addr, value);
+      this->check (func, addr, 2);
+    }
+
+    void write32 (function_code func, vm68k_address_t addr,
+                  uint_fast32_t value) throw (vm68k_bus_error)
+    {
+      this->next ()->write32 (func, addr, value);
+      this->check (func, addr, 4);
+    }
+
+  protected:
+    void check (function_code func, vm68k_address_t addr, int size)
+    {
+      if (_count != 0 && this->clear (addr & (PAGE_SIZE - 1), size))
+        {
+          _bus->code_written (func, addr, size);
+        }
+    }
+
+    /* Sets or clears the marks in M of SIZE bytes at page offset
+       OFFSET.  Returns true if any mark was set before.  */
+    bool mark_words (owner_marks &m, std::size_t offset, std::size_t size,
+                     bool code)
+    {
+      bool marked = false;
+      std::size_t last = std::min (offset + size + 1, PAGE_SIZE) / 2;
+      for (std::size_t i = offset / 2; i < last; ++i)
+        {
+          uint_least32_t bit = (uint_least32_t) 1 << i % 32;
+          bool old = (m.marks[i / 32] & bit) != 0;
+          if (old != code)
+            {
+              if (code)
+                {
+                  m.marks[i / 32] |= bit;
+                  ++m.count;
+                  ++_count;
+                }
+              else
+                {
+                  m.marks[i / 32] &= ~bit;
+                  --m.count;
+                  --_count;
+                }
+            }
+          marked = marked || old;
+        }
+      return marked;
+    }
+
+  private:
+    vm68k_bus *_bus;
+    function_code _func;
+    std::size_t _page;
+    std::vector<owner_marks> _owners;
+    std::size_t _count;
+  };
+
+  /* Filter that counts accesses to a page.  */
+  class vm68k_bus::count_filter : public filter
+  {
+  public:
+    count_filter (function_code func, std::size_t page,
+                  unsigned long *reads, unsigned long *writes)
+    {
+      _func = func;
+      _page = page;
+      _reads = reads;
+      _writes = writes;
+    }
+
+  public:
+    function_code func () const
+    {
+      return _func;
+    }
+
+    std::size_t page () const
+    {
+      return _page;
+    }
+
+  public:
+    uint_fast8_t read8 (function_code func, vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      ++*_reads;
+      return this->next ()->read8 (func, addr);
+    }
+
+    uint_fast16_t read16 (function_code func, vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      ++*_reads;
+      return this->next ()->read16 (func, addr);
+    }
+
+    uint_fast32_t read32 (function_code func, vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      ++*_reads;
+      return this->next ()->read32 (func, addr);
+    }
+
+    void write8 (function_code func, vm68k_address_t addr,
+                 uint_fast8_t value) throw (vm68k_bus_error)
+    {
+      ++*_writes;
+      this->next ()->write8 (func, addr, value);
+    }
+
+    void write16 (function_code func, vm68k_address_t addr,
+                  uint_fast16_t value) throw (vm68k_bus_error)
+    {
+      ++*_writes;
+      this->next ()->write16 (func, addr, value);
+    }
+
+    void write32 (function_code func, vm68k_address_t addr,
+                  uint_fast32_t value) throw (vm68k_bus_error)
+    {
+      ++*_writes;
+      this->next ()->write32 (func, addr, value);
+    }
+
+  private:
+    function_code _func;
+    std::size_t _page;
+    unsigned long *_reads;
+    unsigned long *_writes;
+  };
+
+  /* Mappable that keeps the accesses to a device in order with the
+     posted writes.  Writes to a posted device are posted, and any
+     other access delivers the posted writes first.  */
+  class vm68k_bus::device_proxy : public mappable
+  {
+  public:
+    device_proxy (vm68k_bus *bus, mappable *target, posted_mappable *posted)
+    {
+      _bus = bus;
+      _target = target;
+      _posted = posted;
+    }
+
+  public:
+    mappable *target () const
+    {
+      return _target;
+    }
+
+    posted_mappable *posted () const
+    {
+      return _posted;
+    }
+
+  public:
+    uint_fast8_t read8 (function_code func, vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      _bus->flush_posted_writes ();
+      return _target->read8 (func, addr);
+    }
+
+    uint_fast16_t read16 (function_code func, vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      _bus->flush_posted_writes ();
+      return _target->read16 (func, addr);
+    }
+
+    uint_fast32_t read32 (function_code func, vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      _bus->flush_posted_writes ();
+      return _target->read32 (func, addr);
+    }
+
+    void write8 (function_code func, vm68k_address_t addr,
+                 uint_fast8_t value) throw (vm68k_bus_error)
+    {
+      if (_posted != NULL)
+        {
+          _bus->post (_posted, func, addr, value, 1);
+          return;
+        }
+      _bus->flush_posted_writes ();
+      _target->write8 (func, addr, value);
+    }
+
+    void write16 (function_code func, vm68k_address_t addr,
+                  uint_fast16_t value) throw (vm68k_bus_error)
+    {
+      if (_posted != NULL)
+        {
+          _bus->post (_posted, func, addr, value, 2);
+          return;
+        }
+      _bus->flush_posted_writes ();
+      _target->write16 (func, addr, value);
+    }
+
+    void write32 (function_code func, vm68k_address_t addr,
+                  uint_fast32_t value) throw (vm68k_bus_error)
+    {
+      if (_posted != NULL)
+        {
+          _bus->post (_posted, func, addr, value, 4);
+          return;
+        }
+      _bus->flush_posted_writes ();
+      _target->write32 (func, addr, value);
+    }
+
+  private:
+    vm68k_bus *_bus;
+    mappable *_target;
+    posted_mappable *_posted;
+  };
+
+  vm68k_bus::fault_handler::~fault_handler ()
+  {
+  }
+
+  uint_fast8_t vm68k_bus::null_mappable::read8 (function_code func,
+                                                vm68k_address_t addr) const
+    throw (vm68k_bus_error)
+  {
+    _bus->fault (false, READ | func, addr);
+    return 0;
+  }
+
+  uint_fast16_t vm68k_bus::null_mappable::read16 (function_code func,
+                                                  vm68k_address_t addr) const
+    throw (vm68k_bus_error)
+  {
+    _bus->fault (false, READ | func, addr);
+    return 0;
+  }
+
+  uint_fast32_t vm68k_bus::null_mappable::read32 (function_code func,
+                                                  vm68k_address_t addr) const
+    throw (vm68k_bus_error)
+  {
+    _bus->fault (false, READ | func, addr);
+    return 0;
+  }
+
+  void vm68k_bus::null_mappable::write8 (function_code func,
+                                         vm68k_address_t addr,
+                                         uint_fast8_t)
+    throw (vm68k_bus_error)
+  {
+    _bus->fault (false, WRITE | func, addr);
+  }
+
+  void vm68k_bus::null_mappable::write16 (function_code func,
+                                          vm68k_address_t addr,
+                                          uint_fast16_t)
+    throw (vm68k_bus_error)
+  {
+    _bus->fault (false, WRITE | func, addr);
+  }
+
+  void vm68k_bus::null_mappable::write32 (function_code func,
+                                          vm68k_address_t addr,
+                                          uint_fast32_t)
+    throw (vm68k_bus_error)
+  {
+    _bus->fault (false, WRITE | func, addr);
+  }
+
   /* Class bus implementation.  */
 
   vm68k_bus::vm68k_bus ()
+    : null_accessible (this)
+  {
+    this->initialize (NULL);
+  }
+
+  vm68k_bus::vm68k_bus (vm68k_arena *arena)
+    : null_accessible (this)
   {
-    page_table[USER_DATA]    .assign (NPAGES, &null_accessible);
-    page_table[USER_PROGRAM] .assign (NPAGES, &null_accessible);
-    page_table[SUPER_DATA]   .assign (NPAGES, &null_accessible);
-    page_table[SUPER_PROGRAM].assign (NPAGES, &null_accessible);
+    assert (arena != NULL);
+    this->initialize (arena);
+  }
+
+  void vm68k_bus::initialize (vm68k_arena *arena)
+  {
+    static const function_code used[] =
+      {
+        USER_DATA, USER_PROGRAM, SUPER_DATA, SUPER_PROGRAM
+      };
+    const std::size_t n = sizeof used / sizeof used[0];
+
+    _arena = arena;
+    if (arena != NULL)
+      {
+        _page_storage = static_cast<mappable **>
+          (arena->allocate (n * NPAGES * sizeof (mappable *)));
+      }
+    else
+      {
+        _page_storage = new mappable *[n * NPAGES];
+      }
+    for (std::size_t k = 0; k != n; ++k)
+      {
+        page_table[used[k]]._pages = _page_storage + k * NPAGES;
+        std::fill (page_table[used[k]].begin (), page_table[used[k]].end (),
+                   static_cast<mappable *> (&null_accessible));
+      }
+
+    // The buffers of posted writes are reserved when first used.
+    _posted_limit = 64;
+
+    _last_watch_id = 0;
+    _fault_handler = NULL;
   }
 
   vm68k_bus::~vm68k_bus ()
   {
+    for (std::vector<device_proxy *>::iterator i = _proxies.begin ();
+         i != _proxies.end (); ++i)
+      {
+        delete *i;
+      }
+    for (std::vector<watch_filter *>::iterator i = _watch_filters.begin ();
+         i != _watch_filters.end (); ++i)
+      {
+        delete *i;
+      }
+    for (std::vector<code_filter *>::iterator i = _code_filters.begin ();
+         i != _code_filters.end (); ++i)
+      {
+        delete *i;
+      }
+    for (std::vector<count_filter *>::iterator i = _count_filters.begin ();
+         i != _count_filters.end (); ++i)
+      {
+        delete *i;
+      }
+    if (_arena == NULL)
+      {
+        delete [] _page_storage;
+      }
   }
 
   void vm68k_bus::map_pages (int func_mask, vm68k_address_t addr,
@@ -147,15 +739,26 @@ namespace vx68k
       {
         if ((func_mask & 1U) != 0 && !page_table[func].empty ())
           {
-            page_table_type::iterator i =
+            page_table_type::iterator last =
               this->find_page ((function_code) func,
                                addr + size + PAGE_SIZE - 1);
-            if (i == page_table[func].begin ())
+            if (last == page_table[func].begin ())
               {
-                i = page_table[func].end ();
+                last = page_table[func].end ();
               }
 
-            fill (this->find_page ((function_code) func, addr), i, p);
+            for (page_table_type::iterator i =
+                   this->find_page ((function_code) func, addr);
+                 i != last; ++i)
+              {
+                // Filters stay in front of the new mappable.
+                mappable **slot = &*i;
+                while (filter *f = dynamic_cast<filter *> (*slot))
+                  {
+                    slot = &f->_next;
+                  }
+                *slot = p;
+              }
           }
       }
   }
@@ -166,13 +769,531 @@ namespace vx68k
     this->map_pages (func_mask, addr, size, &null_accessible);
   }
 
+  void vm68k_bus::map_device_pages (int func_mask, vm68k_address_t addr,
+                                    uint_fast32_t size, mappable *p)
+  {
+    assert (p != NULL);
+    this->map_pages (func_mask, addr, size, this->proxy (p, NULL));
+  }
+
+  void vm68k_bus::map_posted_pages (int func_mask, vm68k_address_t addr,
+                                    uint_fast32_t size, posted_mappable *p)
+  {
+    assert (p != NULL);
+    this->map_pages (func_mask, addr, size, this->proxy (p, p));
+  }
+
+  vm68k_bus::device_proxy *vm68k_bus::proxy (mappable *p,
+                                             posted_mappable *posted)
+  {
+    // A device mapped again keeps its proxy.
+    for (std::vector<device_proxy *>::const_iterator i = _proxies.begin ();
+         i != _proxies.end (); ++i)
+      {
+        if ((*i)->target () == p && (*i)->posted () == posted)
+          {
+            return *i;
+          }
+      }
+    _proxies.push_back (new device_proxy (this, p, posted));
+    return _proxies.back ();
+  }
+
+  void vm68k_bus::attach_filter (function_code func, vm68k_address_t addr,
+                                 filter *f)
+  {
+    assert (f != NULL && f->_next == NULL);
+    page_table_type::iterator i = this->find_page (func, addr);
+    f->_next = *i;
+    *i = f;
+  }
+
+  void vm68k_bus::detach_filter (function_code func, vm68k_address_t addr,
+                                 filter *f)
+  {
+    mappable **slot = &*(this->find_page (func, addr));
+    while (*slot != f)
+      {
+        filter *g = dynamic_cast<filter *> (*slot);
+        assert (g != NULL);
+        slot = &g->_next;
+      }
+    *slot = f->_next;
+    f->_next = NULL;
+  }
+
+  int vm68k_bus::set_watchpoint (int func_mask, vm68k_address_t addr,
+                                 uint_fast32_t size, int type,
+                                 watch_handler *h)
+  {
+    assert (h != NULL);
+    assert (size != 0);
+
+    watchpoint w;
+    w.id = ++_last_watch_id;
+    w.func_mask = func_mask;
+    w.address = addr & ((1UL << ADDRESS_BIT) - 1);
+    w.size = size;
+    w.type = type;
+    w.handler = h;
+    _watchpoints.push_back (w);
+
+    std::size_t first = w.address >> PAGE_SHIFT;
+    std::size_t n = ((w.address & (PAGE_SIZE - 1)) + size + PAGE_SIZE - 1)
+      >> PAGE_SHIFT;
+    if (n > NPAGES)
+      {
+        n = NPAGES;
+      }
+
+    for (int func = 0; func != 7; ++func)
+      {
+        if ((func_mask & (1 << func)) != 0 && !page_table[func].empty ())
+          {
+            for (std::size_t k = 0; k != n; ++k)
+              {
+                std::size_t page = (first + k) % NPAGES;
+                if (!this->watched ((function_code) func, page))
+                  {
+                    watch_filter *f =
+                      new watch_filter (this, (function_code) func, page);
+                    _watch_filters.push_back (f);
+                    this->attach_filter ((function_code) func,
+                                         page << PAGE_SHIFT, f);
+                  }
+              }
+          }
+      }
+
+    return w.id;
+  }
+
+  void vm68k_bus::remove_watchpoint (int id)
+  {
+    std::vector<watchpoint>::iterator i = _watchpoints.begin ();
+    while (i != _watchpoints.end () && i->id != id)
+      {
+        ++i;
+      }
+    if (i == _watchpoints.end ())
+      {
+        return;
+      }
+    _watchpoints.erase (i);
+
+    // Drops the filters from pages no other watchpoint covers.
+    std::vector<watch_filter *>::iterator j = _watch_filters.begin ();
+    while (j != _watch_filters.end ())
+      {
+        watch_filter *f = *j;
+        vm68k_address_t page_addr = f->page () << PAGE_SHIFT;
+
+        bool covered = false;
+        for (std::vector<watchpoint>::const_iterator k =
+               _watchpoints.begin ();
+             k != _watchpoints.end () && !covered; ++k)
+          {
+            if ((k->func_mask & (1 << f->func ())) != 0)
+              {
+                const vm68k_address_t mask = (1UL << ADDRESS_BIT) - 1;
+                covered = ((page_addr - k->address) & mask) < k->size
+                  || ((k->address - page_addr) & mask) < PAGE_SIZE;
+              }
+          }
+
+        if (covered)
+          {
+            ++j;
+          }
+        else
+          {
+            this->detach_filter (f->func (), page_addr, f);
+            delete f;
+            j = _watch_filters.erase (j);
+          }
+      }
+  }
+
+  bool vm68k_bus::watched (function_code func, std::size_t page) const
+  {
+    for (std::vector<watch_filter *>::const_iterator i =
+           _watch_filters.begin ();
+         i != _watch_filters.end (); ++i)
+      {
+        if ((*i)->func () == func && (*i)->page () == page)
+          {
+            return true;
+          }
+      }
+    return false;
+  }
+
+  void vm68k_bus::add_code_listener (code_listener *l)
+  {
+    assert (l != NULL);
+    _code_listeners.push_back (l);
+  }
+
+  void vm68k_bus::remove_code_listener (code_listener *l)
+  {
+    std::vector<code_listener *>::iterator i =
+      std::find (_code_listeners.begin (), _code_listeners.end (), l);
+    if (i != _code_listeners.end ())
+      {
+        _code_listeners.erase (i);
+      }
+  }
+
+  void vm68k_bus::mark_code (int func_mask, vm68k_address_t addr,
+                             uint_fast32_t size, const code_listener *owner)
+  {
+    addr &= (1UL << ADDRESS_BIT) - 1;
+    for (int func = 0; func != 7; ++func)
+      {
+        if ((func_mask & (1 << func)) == 0 || page_table[func].empty ())
+          {
+            continue;
+          }
+
+        vm68k_address_t a = addr;
+        uint_fast32_t n = size;
+        while (n != 0)
+          {
+            std::size_t page = (a >> PAGE_SHIFT) % NPAGES;
+            std::size_t offset = a & (PAGE_SIZE - 1);
+            uint_fast32_t k = std::min<uint_fast32_t> (n, PAGE_SIZE - offset);
+
+            code_filter *f = this->find_code_filter ((function_code) func,
+                                                     page);
+            if (f == NULL)
+              {
+                f = new code_filter (this, (function_code) func, page);
+                _code_filters.push_back (f);
+                this->attach_filter ((function_code) func,
+                                     page << PAGE_SHIFT, f);
+              }
+            f->mark (offset, k, owner, true);
+
+            a += k;
+            n -= k;
+          }
+      }
+  }
+
+  void vm68k_bus::unmark_code (int func_mask, vm68k_address_t addr,
+                               uint_fast32_t size,
+                               const code_listener *owner)
+  {
+    addr &= (1UL << ADDRESS_BIT) - 1;
+    for (int func = 0; func != 7; ++func)
+      {
+        if ((func_mask & (1 << func)) == 0 || page_table[func].empty ())
+          {
+            continue;
+          }
+
+        vm68k_address_t a = addr;
+        uint_fast32_t n = size;
+        while (n != 0)
+          {
+            std::size_t page = (a >> PAGE_SHIFT) % NPAGES;
+            std::size_t offset = a & (PAGE_SIZE - 1);
+            uint_fast32_t k = std::min<uint_fast32_t> (n, PAGE_SIZE - offset);
+
+            code_filter *f = this->find_code_filter ((function_code) func,
+                                                     page);
+            if (f != NULL)
+              {
+                f->mark (offset, k, owner, false);
+              }
+
+            a += k;
+            n -= k;
+          }
+      }
+
+    /* Drops the filters from pages without code.  */
+    std::vector<code_filter *>::iterator i = _code_filters.begin ();
+    while (i != _code_filters.end ())
+      {
+        code_filter *f = *i;
+        if (f->count () != 0)
+          {
+            ++i;
+          }
+        else
+          {
+            this->detach_filter (f->func (), f->page () << PAGE_SHIFT, f);
+            delete f;
+            i = _code_filters.erase (i);
+          }
+      }
+  }
+
+  bool vm68k_bus::code_page (function_code func, vm68k_address_t addr) const
+  {
+    const code_filter *f =
+      this->find_code_filter (func, (addr >> PAGE_SHIFT) % NPAGES);
+    return f != NULL && f->count () != 0;
+  }
+
+  void vm68k_bus::code_changed (int func_mask, vm68k_address_t addr,
+                                uint_fast32_t size)
+  {
+    addr &= (1UL << ADDRESS_BIT) - 1;
+    for (int func = 0; func != 7; ++func)
+      {
+        if ((func_mask & (1 << func)) == 0 || page_table[func].empty ())
+          {
+            continue;
+          }
+
+        vm68k_address_t a = addr;
+        uint_fast32_t n = size;
+        while (n != 0)
+          {
+            std::size_t page = (a >> PAGE_SHIFT) % NPAGES;
+            std::size_t offset = a & (PAGE_SIZE - 1);
+            uint_fast32_t k = std::min<uint_fast32_t> (n, PAGE_SIZE - offset);
+
+            code_filter *f = this->find_code_filter ((function_code) func,
+                                                     page);
+            if (f != NULL && f->count () != 0 && f->clear (offset, k))
+              {
+                this->code_written ((function_code) func, a, k);
+              }
+
+            a += k;
+            n -= k;
+          }
+      }
+  }
+
+  vm68k_bus::code_filter *
+  vm68k_bus::find_code_filter (function_code func, std::size_t page) const
+  {
+    for (std::vector<code_filter *>::const_iterator i =
+           _code_filters.begin ();
+         i != _code_filters.end (); ++i)
+      {
+        if ((*i)->func () == func && (*i)->page () == page)
+          {
+            return *i;
+          }
+      }
+    return NULL;
+  }
+
+  void vm68k_bus::code_written (function_code func, vm68k_address_t addr,
+                                int size)
+  {
+    for (std::vector<code_listener *>::size_type i = 0;
+         i != _code_listeners.size (); ++i)
+      {
+        _code_listeners[i]->code_written (func, addr, size);
+      }
+  }
+
+  void vm68k_bus::set_access_counting (bool counting)
+  {
+    if (counting == this->access_counting ())
+      {
+        return;
+      }
+
+    if (!counting)
+      {
+        for (std::vector<count_filter *>::iterator i =
+               _count_filters.begin ();
+             i != _count_filters.end (); ++i)
+          {
+            this->detach_filter ((*i)->func (), (*i)->page () << PAGE_SHIFT,
+                                 *i);
+            delete *i;
+          }
+        _count_filters.clear ();
+        return;
+      }
+
+    for (int func = 0; func != 7; ++func)
+      {
+        if (page_table[func].empty ())
+          {
+            continue;
+          }
+
+        // The counts are not resized later, as the filters point to
+        // them.
+        _read_counts[func].resize (NPAGES);
+        _write_counts[func].resize (NPAGES);
+        for (std::size_t page = 0; page != NPAGES; ++page)
+          {
+            count_filter *f =
+              new count_filter ((function_code) func, page,
+                                &_read_counts[func][page],
+                                &_write_counts[func][page]);
+            _count_filters.push_back (f);
+            this->attach_filter ((function_code) func, page << PAGE_SHIFT,
+                                 f);
+          }
+      }
+  }
+
+  void vm68k_bus::reset_access_counts ()
+  {
+    for (int func = 0; func != 7; ++func)
+      {
+        std::fill (_read_counts[func].begin (), _read_counts[func].end (),
+                   0UL);
+        std::fill (_write_counts[func].begin (), _write_counts[func].end (),
+                   0UL);
+      }
+  }
+
+  unsigned long vm68k_bus::read_count (function_code func,
+                                       vm68k_address_t addr) const
+  {
+    if (_read_counts[func].empty ())
+      {
+        return 0;
+      }
+    return _read_counts[func][(addr >> PAGE_SHIFT) % NPAGES];
+  }
+
+  unsigned long vm68k_bus::write_count (function_code func,
+                                        vm68k_address_t addr) const
+  {
+    if (_write_counts[func].empty ())
+      {
+        return 0;
+      }
+    return _write_counts[func][(addr >> PAGE_SHIFT) % NPAGES];
+  }
+
+  void vm68k_bus::write_heatmap (std::FILE *stream) const
+  {
+    assert (stream != NULL);
+    std::fprintf (stream, "# func page reads writes\n");
+    for (int func = 0; func != 7; ++func)
+      {
+        for (std::size_t page = 0; page != _read_counts[func].size ();
+             ++page)
+          {
+            unsigned long reads = _read_counts[func][page];
+            unsigned long writes = _write_counts[func][page];
+            if (reads != 0 || writes != 0)
+              {
+                std::fprintf (stream, "%d 0x%06lx %lu %lu\n", func,
+                              (unsigned long) page << PAGE_SHIFT, reads,
+                              writes);
+              }
+          }
+      }
+  }
+
+  void vm68k_bus::fault (bool address_error, uint_fast16_t status,
+                         vm68k_address_t addr) const
+  {
+    if (_fault_handler == NULL)
+      {
+        if (address_error)
+          {
+            throw vm68k_address_error (status, addr);
+          }
+        throw vm68k_bus_error (status, addr);
+      }
+
+    _fault_handler->fault (address_error, status, addr);
+  }
+
+  void vm68k_bus::check_watchpoints (function_code func, vm68k_address_t addr,
+                                     int size, direction_code dir,
+                                     uint_fast32_t value)
+    throw (vm68k_bus_error)
+  {
+    const vm68k_address_t mask = (1UL << ADDRESS_BIT) - 1;
+    int type = dir == READ ? WATCH_READ : WATCH_WRITE;
+
+    for (std::vector<watchpoint>::size_type i = 0;
+         i != _watchpoints.size (); ++i)
+      {
+        watchpoint w = _watchpoints[i];
+        if ((w.type & type) != 0 && (w.func_mask & (1 << func)) != 0
+            && (((addr - w.address) & mask) < w.size
+                || ((w.address - addr) & mask) < (vm68k_address_t) size))
+          {
+            w.handler->hit (w.id, func, addr, size, dir, value);
+          }
+      }
+  }
+
+  void vm68k_bus::set_posted_write_limit (std::size_t limit)
+  {
+    this->flush_posted_writes ();
+    _posted_limit = limit != 0 ? limit : 1;
+  }
+
+  void vm68k_bus::post (posted_mappable *p, function_code func,
+                        vm68k_address_t addr, uint_fast32_t value, int size)
+  {
+    posted_write w;
+    w.func = func;
+    w.address = addr;
+    w.value = value;
+    w.size = size;
+    if (_posted.empty ())
+      {
+        _posted.reserve (_posted_limit);
+        _posted_targets.reserve (_posted_limit);
+      }
+    _posted.push_back (w);
+    _posted_targets.push_back (p);
+
+    if (_posted.size () >= _posted_limit)
+      {
+        this->deliver_posted_writes ();
+      }
+  }
+
+  void vm68k_bus::deliver_posted_writes ()
+  {
+    try
+      {
+        // Each run of writes to the same device makes a batch.
+        std::vector<posted_write>::size_type n = _posted.size ();
+        std::vector<posted_write>::size_type i = 0;
+        while (i != n)
+          {
+            std::vector<posted_write>::size_type j = i + 1;
+            while (j != n && _posted_targets[j] == _posted_targets[i])
+              {
+                ++j;
+              }
+
+            _posted_targets[i]->write_batch (&_posted[0] + i,
+                                             &_posted[0] + j);
+            i = j;
+          }
+      }
+    catch (...)
+      {
+        _posted.clear ();
+        _posted_targets.clear ();
+        throw;
+      }
+
+    _posted.clear ();
+    _posted_targets.clear ();
+  }
+
   uint_fast16_t vm68k_bus::read16 (function_code func,
                                    vm68k_address_t addr) const
     throw (vm68k_bus_error, vm68k_address_error)
   {
     if ((addr & 1U) != 0)
       {
-        throw vm68k_address_error (READ | func, addr);
+        this->fault (true, READ | func, addr);
+        return 0;
       }
 
     return this->read16_unchecked (func, addr);
@@ -184,7 +1305,8 @@ namespace vx68k
   {
     if ((addr & 1U) != 0)
       {
-        throw vm68k_address_error (READ | func, addr);
+        this->fault (true, READ | func, addr);
+        return 0;
       }
 
     uint_fast32_t value;
@@ -240,7 +1362,8 @@ namespace vx68k
   {
     if ((addr & 1U) != 0)
       {
-        throw vm68k_address_error (WRITE | func, addr);
+        this->fault (true, WRITE | func, addr);
+        return;
       }
 
     this->write16_unchecked (func, addr, value);
@@ -252,7 +1375,8 @@ namespace vx68k
   {
     if ((addr & 1U) != 0)
       {
-        throw vm68k_address_error (WRITE | func, addr);
+        this->fault (true, WRITE | func, addr);
+        return;
       }
 
     if ((addr & 2U) != 0)
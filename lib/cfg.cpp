@@ -0,0 +1,372 @@
+/* Virtual M68000 Toolkit
+   Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307
+   USA.  */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+#include <vm68k/cfg>
+
+#include <algorithm>
+#include <cassert>
+
+using std::FILE;
+using std::fprintf;
+using std::make_pair;
+using std::map;
+using std::pair;
+using std::set;
+using std::stable_sort;
+using std::vector;
+
+namespace
+{
+  using namespace vx68k;
+
+  /* Instruction found by the walk.  */
+  struct instruction
+  {
+    vm68k_address_t next;
+    vm68k_address_t target;
+    vm68k_instruction::flow_type flow;
+  };
+
+  /* Returns true if flow F has a target.  */
+  inline bool has_target (vm68k_instruction::flow_type f)
+  {
+    return f == vm68k_instruction::FLOW_BRANCH
+      || f == vm68k_instruction::FLOW_CONDITIONAL
+      || f == vm68k_instruction::FLOW_CALL;
+  }
+
+  /* Returns true if flow F may go on to the next instruction.  */
+  inline bool has_next (vm68k_instruction::flow_type f)
+  {
+    return f == vm68k_instruction::FLOW_NEXT
+      || f == vm68k_instruction::FLOW_CONDITIONAL
+      || f == vm68k_instruction::FLOW_CALL
+      || f == vm68k_instruction::FLOW_INDIRECT_CALL;
+  }
+
+  bool more_pairs (const vm68k_instruction_decoder::pair_count &x,
+                   const vm68k_instruction_decoder::pair_count &y)
+  {
+    return x.count > y.count;
+  }
+}
+
+namespace vx68k
+{
+  vm68k_control_flow_graph::
+  vm68k_control_flow_graph (const vm68k_disassembler *d)
+  {
+    assert (d != NULL);
+    _disassembler = d;
+  }
+
+  void vm68k_control_flow_graph::add_code (const vm68k_bus *bus,
+                                           vm68k_bus::function_code func,
+                                           vm68k_address_t addr,
+                                           uint_fast32_t size)
+  {
+    assert (bus != NULL);
+
+    vector<unsigned char> data (size);
+    if (size != 0)
+      {
+        bus->read (func, addr, &data[0], size);
+      }
+    this->add_code (addr, size != 0 ? &data[0] : NULL, size);
+  }
+
+  void vm68k_control_flow_graph::add_code (vm68k_address_t addr,
+                                           const unsigned char *data,
+                                           std::size_t size)
+  {
+    assert (data != NULL || size == 0);
+
+    region r;
+    r.base = addr;
+    r.data.assign (data, data + size);
+    _code.push_back (r);
+  }
+
+  void vm68k_control_flow_graph::add_entry (vm68k_address_t addr)
+  {
+    _entries.push_back (addr);
+  }
+
+  vm68k_code_image
+  vm68k_control_flow_graph::find_image (vm68k_address_t addr) const
+  {
+    for (vector<region>::const_iterator i = _code.begin ();
+         i != _code.end (); ++i)
+      {
+        if (!i->data.empty ())
+          {
+            vm68k_code_image image (i->base, &i->data[0], i->data.size ());
+            if (image.contains (addr, 2))
+              {
+                return image;
+              }
+          }
+      }
+    return vm68k_code_image (addr, NULL, 0);
+  }
+
+  void vm68k_control_flow_graph::build ()
+  {
+    _blocks.clear ();
+    _functions.clear ();
+
+    // Walks the code, taking the entries and the targets as leaders.
+    map<vm68k_address_t, instruction> found;
+    set<vm68k_address_t> leaders;
+    vector<vm68k_address_t> work;
+    for (vector<vm68k_address_t>::const_iterator i = _entries.begin ();
+         i != _entries.end (); ++i)
+      {
+        _functions.insert (*i);
+        leaders.insert (*i);
+        work.push_back (*i);
+      }
+
+    while (!work.empty ())
+      {
+        vm68k_address_t a = work.back ();
+        work.pop_back ();
+
+        bool more = true;
+        while (more && (a & 1U) == 0 && found.find (a) == found.end ())
+          {
+            vm68k_code_image image = this->find_image (a);
+            if (image.size () == 0)
+              {
+                break;
+              }
+
+            instruction &i = found[a];
+            i.target = 0;
+            i.flow = _disassembler->flow (image, a, i.next, i.target);
+            if (has_target (i.flow))
+              {
+                leaders.insert (i.target);
+                work.push_back (i.target);
+                if (i.flow == vm68k_instruction::FLOW_CALL)
+                  {
+                    _functions.insert (i.target);
+                  }
+              }
+            if (i.flow != vm68k_instruction::FLOW_NEXT && has_next (i.flow))
+              {
+                leaders.insert (i.next);
+              }
+
+            more = has_next (i.flow);
+            a = i.next;
+          }
+      }
+
+    // Splits the instructions into blocks at the leaders.
+    for (set<vm68k_address_t>::const_iterator i = leaders.begin ();
+         i != leaders.end (); ++i)
+      {
+        map<vm68k_address_t, instruction>::const_iterator k =
+          found.find (*i);
+        if (k == found.end ())
+          {
+            continue;
+          }
+
+        block b;
+        b.start = *i;
+        b.size = 0;
+        for (;;)
+          {
+            ++b.size;
+            const instruction &x = k->second;
+            if (x.flow != vm68k_instruction::FLOW_NEXT
+                || leaders.find (x.next) != leaders.end ()
+                || found.find (x.next) == found.end ())
+              {
+                b.last = k->first;
+                b.end = x.next;
+                b.target = x.target;
+                b.flow = x.flow;
+                break;
+              }
+            k = found.find (x.next);
+          }
+        _blocks.insert (make_pair (b.start, b));
+      }
+  }
+
+  void
+  vm68k_control_flow_graph::successors (const block &b,
+                                        vector<vm68k_address_t> &successors)
+    const
+  {
+    if (has_next (b.flow) && _blocks.find (b.end) != _blocks.end ())
+      {
+        successors.push_back (b.end);
+      }
+    if (b.flow != vm68k_instruction::FLOW_CALL && has_target (b.flow)
+        && _blocks.find (b.target) != _blocks.end ())
+      {
+        successors.push_back (b.target);
+      }
+  }
+
+  void
+  vm68k_control_flow_graph::function_blocks (vm68k_address_t entry,
+                                             vector<vm68k_address_t> &starts)
+    const
+  {
+    if (_blocks.find (entry) == _blocks.end ())
+      {
+        return;
+      }
+
+    set<vm68k_address_t> seen;
+    seen.insert (entry);
+    std::size_t first = starts.size ();
+    starts.push_back (entry);
+    for (std::size_t i = first; i != starts.size (); ++i)
+      {
+        vector<vm68k_address_t> next;
+        this->successors (_blocks.find (starts[i])->second, next);
+        for (vector<vm68k_address_t>::const_iterator j = next.begin ();
+             j != next.end (); ++j)
+          {
+            if (seen.insert (*j).second)
+              {
+                starts.push_back (*j);
+              }
+          }
+      }
+  }
+
+  void vm68k_control_flow_graph::mark_code (vm68k_bus *bus,
+                                            int func_mask) const
+  {
+    assert (bus != NULL);
+
+    for (block_map::const_iterator i = _blocks.begin ();
+         i != _blocks.end (); ++i)
+      {
+        const block &b = i->second;
+        bus->mark_code (func_mask, b.start, b.end - b.start);
+      }
+  }
+
+  void vm68k_control_flow_graph::pair_counts
+  (vector<vm68k_instruction_decoder::pair_count> &pairs) const
+  {
+    map<pair<uint_least16_t, uint_least16_t>, unsigned long> counts;
+    for (block_map::const_iterator i = _blocks.begin ();
+         i != _blocks.end (); ++i)
+      {
+        const block &b = i->second;
+        vm68k_code_image image = this->find_image (b.start);
+
+        vm68k_address_t a = b.start;
+        while (a != b.last)
+          {
+            vm68k_address_t next, target;
+            _disassembler->flow (image, a, next, target);
+            ++counts[make_pair (image.fetch_word (a),
+                                image.fetch_word (next))];
+            a = next;
+          }
+      }
+
+    std::size_t first = pairs.size ();
+    for (map<pair<uint_least16_t, uint_least16_t>, unsigned long>::
+           const_iterator i = counts.begin (); i != counts.end (); ++i)
+      {
+        vm68k_instruction_decoder::pair_count p;
+        p.first = i->first.first;
+        p.second = i->first.second;
+        p.count = i->second;
+        pairs.push_back (p);
+      }
+    stable_sort (pairs.begin () + first, pairs.end (), &more_pairs);
+  }
+
+  void vm68k_control_flow_graph::write_dot (FILE *stream, bool text) const
+  {
+    assert (stream != NULL);
+
+    fprintf (stream, "digraph cfg {\n");
+    fprintf (stream, "  node [shape=box, fontname=monospace];\n");
+    for (block_map::const_iterator i = _blocks.begin ();
+         i != _blocks.end (); ++i)
+      {
+        const block &b = i->second;
+        fprintf (stream, "  b%08lx [label=\"", (unsigned long) b.start);
+        if (text)
+          {
+            vm68k_code_image image = this->find_image (b.start);
+            vm68k_address_t a = b.start;
+            for (uint_fast32_t k = 0; k != b.size; ++k)
+              {
+                char buf[vm68k_disassembler::TEXT_MAX];
+                vm68k_address_t next =
+                  _disassembler->disassemble (image, a, buf, sizeof buf);
+                fprintf (stream, "%08lx  %s\\l", (unsigned long) a, buf);
+                a = next;
+              }
+          }
+        else
+          {
+            fprintf (stream, "%08lx-%08lx\\n%lu", (unsigned long) b.start,
+                     (unsigned long) b.end, (unsigned long) b.size);
+          }
+        fprintf (stream, "\"%s];\n",
+                 _functions.find (b.start) != _functions.end ()
+                 ? ", peripheries=2" : "");
+
+        vector<vm68k_address_t> next;
+        this->successors (b, next);
+        for (vector<vm68k_address_t>::const_iterator j = next.begin ();
+             j != next.end (); ++j)
+          {
+            fprintf (stream, "  b%08lx -> b%08lx;\n",
+                     (unsigned long) b.start, (unsigned long) *j);
+          }
+        if (b.flow == vm68k_instruction::FLOW_CALL
+            && _blocks.find (b.target) != _blocks.end ())
+          {
+            fprintf (stream, "  b%08lx -> b%08lx [style=dashed];\n",
+                     (unsigned long) b.start, (unsigned long) b.target);
+          }
+      }
+    fprintf (stream, "}\n");
+  }
+}
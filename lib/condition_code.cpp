@@ -137,6 +137,15 @@ condition_code::set_cc_sub(sint32_type r, sint32_type d, sint32_type s)
   x_values[2] = cc_values[2] = s;
 }
 
+void
+condition_code::set_x_sub(sint32_type r, sint32_type d, sint32_type s)
+{
+  x_eval = &const_sub_condition_tester;
+  x_values[0] = r;
+  x_values[1] = d;
+  x_values[2] = s;
+}
+
 void
 condition_code::set_cc_asr(sint32_type r, sint32_type d, sint32_type s)
 {
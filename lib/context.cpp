@@ -20,121 +20,470 @@
 #include <config.h>
 #endif
 
-#if __GNUC__
-#define _VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
 #endif
 
 #include <vm68k/context>
+#include <vm68k/journal>
+
+#include <algorithm>
 #include <cassert>
 #include <pthread.h>
 
-namespace vx68k_m68k
+using std::copy;
+using std::fill;
+
+namespace vx68k
 {
-  context *context::current_context ()
+  /* Filter that invalidates the vector cache on writes to the vector
+     table in page 0.  */
+  class vm68k_context::vector_filter : public vm68k_bus::filter
+  {
+  public:
+    explicit vector_filter (vm68k_context *c)
+    {
+      _context = c;
+    }
+
+  public:
+    void write8 (vm68k_bus::function_code func, vm68k_address_t addr,
+                 uint_fast8_t value) throw (vm68k_bus_error)
+    {
+      this->check (addr);
+      this->next ()->write8 (func, addr, value);
+    }
+
+    void write16 (vm68k_bus::function_code func, vm68k_address_t addr,
+                  uint_fast16_t value) throw (vm68k_bus_error)
+    {
+      this->check (addr);
+      this->next ()->write16 (func, addr, value);
+    }
+
+    void write32 (vm68k_bus::function_code func, vm68k_address_t addr,
+                  uint_fast32_t value) throw (vm68k_bus_error)
+    {
+      this->check (addr);
+      this->next ()->write32 (func, addr, value);
+    }
+
+  protected:
+    void check (vm68k_address_t addr)
+    {
+      // The table has 256 vectors of 4 bytes from address 0.
+      if ((addr & (PAGE_SIZE - 1)) < 0x400)
+        {
+          _context->invalidate_vectors ();
+        }
+    }
+
+  private:
+    vm68k_context *_context;
+  };
+
+  vm68k_context *vm68k_context::current_context ()
   {
     return NULL;
   }
 
-  context::context (system_bus *bus)
+  vm68k_context::vm68k_context (vm68k_bus *bus)
   {
+    assert (bus != NULL);
     _bus = bus;
-    if (this->super ())
-      {
-        dfc_cache = SUPER_DATA;
-        pfc_cache = SUPER_PROGRAM;
-      }
-    else
-      {
-        dfc_cache = USER_DATA;
-        pfc_cache = USER_PROGRAM;
-      }
 
-    a_interrupted = false;
+    fill (_reg + 0, _reg + REGISTER_MAX, 0);
+    _usp = 0;
+    _ssp = 0;
+
+    // The processor starts in the supervisor state with all the
+    // interrupts masked.
+    _status_high = S | 0x0700;
+    _status = _status_high;
+    dfc_cache = vm68k_bus::SUPER_DATA;
+    pfc_cache = vm68k_bus::SUPER_PROGRAM;
+
+    _store_count = 0;
+    _trace = NULL;
+    _store_trace = NULL;
+    _perf_profile = NULL;
+    _journal = NULL;
+    _lost_interrupts = 0;
+    _pending = 0;
+    _stop_reason = STOP_NONE;
+    _fusible = false;
+    _exception_processing = false;
+    fill (_vector_filters + 0, _vector_filters + 7, (vector_filter *) NULL);
+    _vectors_valid = false;
+
+    _deferred_faults = false;
+    _fault_address_error = false;
+    _fault_status = 0;
+    _fault_address = 0;
+
+    pthread_mutex_init (&_mutex, NULL);
+    pthread_cond_init (&_cond, NULL);
   }
 
-  void context::set_super (bool state)
+  vm68k_context::~vm68k_context ()
+  {
+    this->set_vector_cache (false);
+    pthread_cond_destroy (&_cond);
+    pthread_mutex_destroy (&_mutex);
+  }
+
+  void vm68k_context::set_super (bool state)
   {
     if (state != super ())
       {
         if (state)
           {
-	    _named_reg.usp = _named_reg.sp;
-	    _status.set_s_bit (true);
-	    _named_reg.sp = _named_reg.ssp;
+            _usp = _named_reg.sp;
+            _status_high |= S;
+            _status.set_s_bit (true);
+            _named_reg.sp = _ssp;
 
-	    dfc_cache = SUPER_DATA;
-	    pfc_cache = SUPER_PROGRAM;
-	  }
+            dfc_cache = vm68k_bus::SUPER_DATA;
+            pfc_cache = vm68k_bus::SUPER_PROGRAM;
+          }
         else
           {
-	    _named_reg.ssp = _named_reg.sp;
-	    _status.set_s_bit (false);
-	    _named_reg.sp = _named_reg.usp;
+            _ssp = _named_reg.sp;
+            _status_high &= ~S;
+            _status.set_s_bit (false);
+            _named_reg.sp = _usp;
 
-	    dfc_cache = USER_DATA;
-	    pfc_cache = USER_PROGRAM;
-	  }
+            dfc_cache = vm68k_bus::USER_DATA;
+            pfc_cache = vm68k_bus::USER_PROGRAM;
+          }
       }
   }
 
-  void context::set_status (udata_fast16_t value)
+  void vm68k_context::set_trace (vm68k_trace_buffer *buffer)
   {
-    set_super ((value & 0x2000) != 0);
+    _trace = buffer;
+    _store_trace = NULL;
+    if (buffer != NULL
+        && (buffer->options () & vm68k_trace_buffer::STORES) != 0)
+      {
+        _store_trace = buffer;
+      }
+  }
+
+  void vm68k_context::set_status (uint_fast16_t value)
+  {
+    set_super ((value & S) != 0);
+    _status_high = value & 0xff00U;
     _status = value;
   }
 
-  void context::interrupt (int priority, udata_fast8_t vecno)
+  void vm68k_context::save (snapshot &s) const
+  {
+    copy (_reg + 0, _reg + REGISTER_MAX, s.reg + 0);
+    s.usp = this->super () ? _usp : _named_reg.sp;
+    s.ssp = this->super () ? _named_reg.sp : _ssp;
+    s.status = this->status ();
+    s.stopped = this->stopped ();
+    s.store_count = _store_count;
+  }
+
+  void vm68k_context::restore (const snapshot &s)
+  {
+    this->set_status (s.status);
+    copy (s.reg + 0, s.reg + REGISTER_MAX, _reg + 0);
+    _usp = s.usp;
+    _ssp = s.ssp;
+    _store_count = s.store_count;
+
+    pthread_mutex_lock (&_mutex);
+    for (int i = 0; i != 7; ++i)
+      {
+        interrupt_queue[i].clear ();
+      }
+    _pending = s.stopped ? STOPPED : 0;
+    pthread_mutex_unlock (&_mutex);
+
+    // The vector table may have been restored without the bus.
+    _vectors_valid = false;
+  }
+
+  void vm68k_context::interrupt (int priority, uint_fast8_t vecno)
+  {
+    // Only the interrupts in the journal are replayed.
+    if (_journal != NULL && _journal->replaying ())
+      {
+        return;
+      }
+
+    this->queue_interrupt (priority, vecno);
+  }
+
+  void vm68k_context::queue_interrupt (int priority, uint_fast8_t vecno)
   {
     if (priority < 1 || priority > 7)
-      return;
+      {
+        return;
+      }
 
-    vecno &= 0xffU;
-    interrupt_queue[7 - priority].push (vecno);
-    a_interrupted = true;
+    pthread_mutex_lock (&_mutex);
+    if (interrupt_queue[7 - priority].full ())
+      {
+        ++_lost_interrupts;
+        pthread_mutex_unlock (&_mutex);
+        return;
+      }
+    interrupt_queue[7 - priority].push (vecno & 0xffU);
+    _pending |= INTERRUPTED;
+    pthread_cond_broadcast (&_cond);
+    pthread_mutex_unlock (&_mutex);
   }
 
-#if 0
-  address_t
-  context::handle_interrupts (address_t pc)
+  bool vm68k_context::interrupt_acceptable () const
   {
-    using std::vector;
-    using std::queue;
+    int level = _status_high >> 8 & 7;
+    for (int prio = 7; prio != 0; --prio)
+      {
+        if (!interrupt_queue[7 - prio].empty ())
+          {
+            // Level 7 is not maskable.
+            return prio == 7 || prio > level;
+          }
+      }
+
+    return false;
+  }
 
-    vector<queue<unsigned int> >::iterator i = interrupt_queues.begin();
-    while (i->empty())
+  vm68k_address_t vm68k_context::handle_interrupts (vm68k_address_t pc)
+  {
+    pthread_mutex_lock (&_mutex);
+    if (!this->interrupt_acceptable ())
       {
-	++i;
-	assert (i != interrupt_queues.end());
+        pthread_mutex_unlock (&_mutex);
+        return pc;
       }
 
-    int prio = interrupt_queues.end() - i;
-    int level = sr() >> 8 & 7;
-    if (prio == 7 || prio > level)
+    int prio = 7;
+    while (interrupt_queue[7 - prio].empty ())
       {
-	unsigned int vecno = i->front();
-	i->pop();
+        --prio;
+        assert (prio != 0);
+      }
 
-	udata_fast16_t old_sr = status ();
-	set_status (old_sr & ~0x700 | prio << 8);
-	set_super (true);
-	_named_reg.sp -= 6;
-	_bus->put32 (SUPER_DATA, _named_reg.sp + 2, pc);
-	_bus->put16 (SUPER_DATA, _named_reg.sp + 0, old_sr);
+    uint_fast8_t vecno = interrupt_queue[7 - prio].front ();
+    interrupt_queue[7 - prio].pop ();
 
-	address_t address = vecno * 4u;
-	pc = _bus->get32 (SUPER_DATA, address);
+    _pending &= ~(INTERRUPTED | STOPPED);
+    for (int i = 0; i != 7; ++i)
+      {
+        if (!interrupt_queue[i].empty ())
+          {
+            _pending |= INTERRUPTED;
+          }
+      }
+    pthread_mutex_unlock (&_mutex);
 
-	a_interrupted = false;
-	vector<queue<unsigned int> >::iterator j = i;
-	while (j != interrupt_queues.end())
-	  {
-	    if (!j->empty())
-	      a_interrupted = true;
-	    ++j;
-	  }
+    if (_journal != NULL)
+      {
+        _journal->interrupt_accepted (prio, vecno);
       }
 
-    return pc;
+    uint_fast16_t old_status = this->status ();
+    this->set_status ((old_status & ~0x8700U) | S | prio << 8);
+    this->push (vm68k_data_size::LONG_WORD, pc);
+    this->push (vm68k_data_size::WORD, old_status);
+
+    return this->vector (vecno);
+  }
+
+  void vm68k_context::wait_interrupt ()
+  {
+    pthread_mutex_lock (&_mutex);
+    if (_journal != NULL && _journal->replaying ())
+      {
+        // The journal has run out or the replay has diverged.
+        if (!this->interrupt_acceptable ())
+          {
+            _pending |= STOP_REQUEST;
+          }
+        pthread_mutex_unlock (&_mutex);
+        return;
+      }
+
+    while (!this->interrupt_acceptable () && (_pending & STOP_REQUEST) == 0)
+      {
+        pthread_cond_wait (&_cond, &_mutex);
+      }
+    pthread_mutex_unlock (&_mutex);
+  }
+
+  void vm68k_context::stop ()
+  {
+    pthread_mutex_lock (&_mutex);
+    _pending |= STOPPED;
+    pthread_mutex_unlock (&_mutex);
+  }
+
+  void vm68k_context::trap_host_call ()
+  {
+    pthread_mutex_lock (&_mutex);
+    _pending |= HOST_CALL;
+    pthread_mutex_unlock (&_mutex);
+  }
+
+  bool vm68k_context::host_call_trapped ()
+  {
+    if ((_pending & HOST_CALL) == 0)
+      {
+        return false;
+      }
+
+    pthread_mutex_lock (&_mutex);
+    _pending &= ~HOST_CALL;
+    pthread_mutex_unlock (&_mutex);
+    return true;
+  }
+
+  void vm68k_context::request_stop ()
+  {
+    pthread_mutex_lock (&_mutex);
+    _pending |= STOP_REQUEST;
+    pthread_cond_broadcast (&_cond);
+    pthread_mutex_unlock (&_mutex);
+  }
+
+  bool vm68k_context::stop_requested ()
+  {
+    if ((_pending & STOP_REQUEST) == 0)
+      {
+        return false;
+      }
+
+    pthread_mutex_lock (&_mutex);
+    _pending &= ~STOP_REQUEST;
+    pthread_mutex_unlock (&_mutex);
+    return true;
+  }
+
+  void vm68k_context::set_deferred_faults (bool deferred)
+  {
+    _deferred_faults = deferred;
+  }
+
+  void vm68k_context::fault (bool address_error, uint_fast16_t status,
+                             vm68k_address_t addr)
+  {
+    // Only the first fault of an instruction is kept.
+    if ((_pending & FAULT) != 0)
+      {
+        return;
+      }
+
+    _fault_address_error = address_error;
+    _fault_status = status;
+    _fault_address = addr;
+
+    pthread_mutex_lock (&_mutex);
+    _pending |= FAULT;
+    pthread_mutex_unlock (&_mutex);
+  }
+
+  bool vm68k_context::faulted ()
+  {
+    if ((_pending & FAULT) == 0)
+      {
+        return false;
+      }
+
+    pthread_mutex_lock (&_mutex);
+    _pending &= ~FAULT;
+    pthread_mutex_unlock (&_mutex);
+    return true;
+  }
+
+  vm68k_address_t vm68k_context::take_exception (uint_fast16_t vecno,
+                                                 vm68k_address_t pc)
+  {
+    uint_fast16_t old_status = this->status ();
+    this->set_status ((old_status & ~0x8000U) | S);
+    this->push (vm68k_data_size::LONG_WORD, pc);
+    this->push (vm68k_data_size::WORD, old_status);
+
+    return this->vector (vecno);
+  }
+
+  vm68k_address_t
+  vm68k_context::take_group0_exception (uint_fast16_t vecno,
+                                        vm68k_address_t pc,
+                                        uint_fast16_t ir,
+                                        uint_fast16_t status,
+                                        vm68k_address_t addr)
+  {
+    uint_fast16_t old_status = this->status ();
+    this->set_status ((old_status & ~0x8000U) | S);
+    this->push (vm68k_data_size::LONG_WORD, pc);
+    this->push (vm68k_data_size::WORD, old_status);
+    this->push (vm68k_data_size::WORD, ir);
+    this->push (vm68k_data_size::LONG_WORD, addr);
+
+    // The special status word has the R/W bit and the function code
+    // from STATUS, and the I/N bit set for data accesses.
+    uint_fast16_t func = status & 7;
+    uint_fast16_t ssw = status & 0x17U;
+    if (func != vm68k_bus::USER_PROGRAM && func != vm68k_bus::SUPER_PROGRAM)
+      {
+        ssw |= 0x08U;
+      }
+    this->push (vm68k_data_size::WORD, ssw);
+
+    return this->vector (vecno);
+  }
+
+  void vm68k_context::set_vector_cache (bool cached)
+  {
+    static const vm68k_bus::function_code funcs[] =
+      {
+        vm68k_bus::USER_DATA,
+        vm68k_bus::SUPER_DATA,
+      };
+
+    for (int i = 0; i != 2; ++i)
+      {
+        vector_filter *&f = _vector_filters[funcs[i]];
+        if (cached && f == NULL)
+          {
+            f = new vector_filter (this);
+            _bus->attach_filter (funcs[i], 0, f);
+          }
+        else if (!cached && f != NULL)
+          {
+            _bus->detach_filter (funcs[i], 0, f);
+            delete f;
+            f = NULL;
+          }
+      }
+    _vectors_valid = false;
+  }
+
+  vm68k_address_t vm68k_context::vector (uint_fast16_t vecno)
+  {
+    assert (vecno < 256);
+    if (_vector_filters[vm68k_bus::SUPER_DATA] == NULL)
+      {
+        return _bus->read32 (vm68k_bus::SUPER_DATA, vecno * 4U);
+      }
+
+    if (!_vectors_valid)
+      {
+        for (int i = 0; i != 256; ++i)
+          {
+            _vectors[i] = _bus->read32 (vm68k_bus::SUPER_DATA, i * 4U);
+          }
+        _vectors_valid = true;
+      }
+    return _vectors[vecno];
   }
-#endif
 }
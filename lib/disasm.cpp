@@ -0,0 +1,182 @@
+/* Virtual M68000 Toolkit
+   Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307
+   USA.  */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+#include <vm68k/disasm>
+
+#include "inst/text.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+using std::fill;
+using std::memcpy;
+
+namespace vx68k
+{
+  vm68k_disassembler::vm68k_disassembler ()
+  {
+    _text = new vm68k_instruction::text_function [0x10000];
+    fill (_text, _text + 0x10000, vm68k_instruction::text_function ());
+    _flow = new vm68k_instruction::flow_function [0x10000];
+    fill (_flow, _flow + 0x10000, vm68k_instruction::flow_function ());
+
+    // The same tables in the same order as the decoder.
+    insert_inst1 (this);
+    insert_inst2 (this);
+    insert_inst3 (this);
+    insert_inst4 (this);
+    insert_inst5 (this);
+    insert_inst6 (this);
+    insert_inst10 (this);
+    insert_inst11 (this);
+    insert_inst15 (this);
+  }
+
+  vm68k_disassembler::~vm68k_disassembler ()
+  {
+    delete [] _flow;
+    delete [] _text;
+  }
+
+  void vm68k_disassembler::insert (const vm68k_instruction_decoder::spec &s)
+  {
+    uint_fast16_t code = s.code & ~s.mask;
+    for (uint_fast32_t i = code; i <= (code | s.mask); ++i)
+      {
+        if ((i & ~s.mask) == code)
+          {
+            _text[i] = s.text;
+            _flow[i] = s.flow;
+          }
+      }
+  }
+
+  vm68k_address_t
+  vm68k_disassembler::write (const vm68k_code_image &code,
+                             vm68k_address_t addr, char *&p) const
+  {
+    uint_fast16_t w = code.fetch_word (addr);
+    vm68k_instruction::text_function text = _text[w];
+    if (text == NULL)
+      {
+        // The executor would take an illegal instruction exception.
+        p = vx68k_m68k::write_string (p, ".short ");
+        p = vx68k_m68k::write_hex (p, w);
+        return (addr + 2) & 0xffffffffU;
+      }
+    return text (addr + 2, w, code, p) & 0xffffffffU;
+  }
+
+  vm68k_address_t
+  vm68k_disassembler::disassemble (const vm68k_code_image &code,
+                                   vm68k_address_t addr,
+                                   char *buf, std::size_t size) const
+  {
+    assert (buf != NULL || size == 0);
+
+    char text[TEXT_MAX];
+    char *p = text;
+    vm68k_address_t next = this->write (code, addr, p);
+    assert (p < text + TEXT_MAX);
+
+    if (size != 0)
+      {
+        std::size_t n = std::min (std::size_t (p - text), size - 1);
+        memcpy (buf, text, n);
+        buf[n] = '\0';
+      }
+    return next;
+  }
+
+  vm68k_address_t
+  vm68k_disassembler::disassemble_range (const vm68k_code_image &code,
+                                         vm68k_address_t addr,
+                                         vm68k_address_t end,
+                                         char *buf, std::size_t size,
+                                         std::size_t *length) const
+  {
+    assert (buf != NULL || size == 0);
+
+    // Each line has 8 digits, a tab and a newline besides the text.
+    const std::size_t line_max = 8 + 1 + TEXT_MAX + 1;
+
+    static const char digits[] = "0123456789abcdef";
+
+    char *p = buf;
+    while (addr < end && std::size_t (buf + size - p) > line_max)
+      {
+        for (int shift = 28; shift >= 0; shift -= 4)
+          {
+            *p++ = digits[addr >> shift & 0xfU];
+          }
+        *p++ = '\t';
+        addr = this->write (code, addr, p);
+        *p++ = '\n';
+      }
+
+    if (size != 0)
+      {
+        *p = '\0';
+      }
+    if (length != NULL)
+      {
+        *length = p - buf;
+      }
+    return addr;
+  }
+
+  vm68k_instruction::flow_type
+  vm68k_disassembler::flow (const vm68k_code_image &code,
+                            vm68k_address_t addr, vm68k_address_t &next,
+                            vm68k_address_t &target) const
+  {
+    uint_fast16_t w = code.fetch_word (addr);
+    if (_text[w] == NULL)
+      {
+        next = (addr + 2) & 0xffffffffU;
+        return vm68k_instruction::FLOW_ILLEGAL;
+      }
+
+    // The text function is the only one that knows the length.
+    char text[TEXT_MAX];
+    char *p = text;
+    next = _text[w] (addr + 2, w, code, p) & 0xffffffffU;
+
+    if (_flow[w] == NULL)
+      {
+        return vm68k_instruction::FLOW_NEXT;
+      }
+    return _flow[w] (addr + 2, w, code, target);
+  }
+}
@@ -0,0 +1,788 @@
+/* Virtual M68000 Toolkit
+   Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307
+   USA.  */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/trace>
+#include <vm68k/gdbstub>
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+using std::string;
+
+namespace
+{
+  using namespace vx68k;
+  using vx68k::uint_fast32_t;   // avoid ambiguity
+
+  /* Signal numbers in stop replies.  */
+  const int SIGNAL_INT =  2;
+  const int SIGNAL_ILL =  4;
+  const int SIGNAL_TRAP = 5;
+  const int SIGNAL_FPE =  8;
+  const int SIGNAL_BUS = 10;
+
+  /* Kinds of watchpoints in the protocol.  */
+  const int WATCH_KIND_WRITE =  2;
+  const int WATCH_KIND_READ =   3;
+  const int WATCH_KIND_ACCESS = 4;
+
+  const char HEX_DIGITS[] = "0123456789abcdef";
+
+  int hex_value (char c)
+  {
+    if (c >= '0' && c <= '9')
+      {
+        return c - '0';
+      }
+    if (c >= 'a' && c <= 'f')
+      {
+        return c - 'a' + 10;
+      }
+    if (c >= 'A' && c <= 'F')
+      {
+        return c - 'A' + 10;
+      }
+    return -1;
+  }
+
+  /* Appends VALUE as hexadecimal digits in big-endian order.  */
+  void append_hex (string &s, uint_fast32_t value, int size)
+  {
+    for (int i = size * 2 - 1; i >= 0; --i)
+      {
+        s += HEX_DIGITS[value >> i * 4 & 0xf];
+      }
+  }
+
+  /* Parses hexadecimal digits from position I of S up to a character
+     that is not one.  */
+  uint_fast32_t parse_hex (const string &s, string::size_type &i)
+  {
+    uint_fast32_t value = 0;
+    int d;
+    while (i != s.size () && (d = hex_value (s[i])) >= 0)
+      {
+        value = value << 4 | d;
+        ++i;
+      }
+    return value;
+  }
+
+  string signal_reply (int sig)
+  {
+    string reply = "S";
+    append_hex (reply, sig, 1);
+    return reply;
+  }
+
+  /* Watches the connection for a break while the program runs.  */
+  class break_watcher
+  {
+  public:
+    break_watcher (int connection, vm68k_context *c);
+    ~break_watcher ();
+
+  public:
+    /* Returns true if the connection was lost.  */
+    bool lost () const
+    {
+      return _lost;
+    }
+
+  private:
+    static void *run (void *arg);
+
+  private:
+    int _connection;
+    vm68k_context *_context;
+    int _pipe[2];
+    pthread_t _thread;
+    bool _started;
+    bool _lost;
+  };
+
+  break_watcher::break_watcher (int connection, vm68k_context *c)
+  {
+    _connection = connection;
+    _context = c;
+    _lost = false;
+    _started = false;
+    if (pipe (_pipe) == 0)
+      {
+        _started = pthread_create (&_thread, NULL, &run, this) == 0;
+      }
+  }
+
+  break_watcher::~break_watcher ()
+  {
+    if (_started)
+      {
+        char c = 0;
+        while (write (_pipe[1], &c, 1) == -1 && errno == EINTR)
+          {
+          }
+        pthread_join (_thread, NULL);
+      }
+    close (_pipe[0]);
+    close (_pipe[1]);
+  }
+
+  void *break_watcher::run (void *arg)
+  {
+    break_watcher *w = static_cast<break_watcher *> (arg);
+
+    struct pollfd fds[2];
+    fds[0].fd = w->_connection;
+    fds[0].events = POLLIN;
+    fds[1].fd = w->_pipe[0];
+    fds[1].events = POLLIN;
+    for (;;)
+      {
+        if (poll (fds, 2, -1) == -1)
+          {
+            if (errno == EINTR)
+              {
+                continue;
+              }
+            break;
+          }
+        if (fds[1].revents != 0)
+          {
+            break;
+          }
+        if (fds[0].revents != 0)
+          {
+            char c;
+            ssize_t n = recv (w->_connection, &c, 1, 0);
+            if (n <= 0)
+              {
+                w->_lost = true;
+                w->_context->request_stop ();
+                break;
+              }
+            if (c == '\003')
+              {
+                w->_context->request_stop ();
+                break;
+              }
+          }
+      }
+    return NULL;
+  }
+}
+
+namespace vx68k
+{
+  vm68k_gdbstub::vm68k_gdbstub (vm68k_instruction_decoder *decoder,
+                                vm68k_context *c)
+  {
+    assert (decoder != NULL);
+    assert (c != NULL);
+    _decoder = decoder;
+    _context = c;
+    _listener = -1;
+    _connection = -1;
+    _pc = 0;
+    _running = false;
+    _watch_kind = 0;
+    _watch_address = 0;
+  }
+
+  vm68k_gdbstub::~vm68k_gdbstub ()
+  {
+    for (std::map<std::pair<int, vm68k_address_t>, int>::iterator i =
+           _watchpoints.begin ();
+         i != _watchpoints.end (); ++i)
+      {
+        _context->bus ()->remove_watchpoint (i->second);
+      }
+    if (_connection != -1)
+      {
+        close (_connection);
+      }
+    if (_listener != -1)
+      {
+        close (_listener);
+        if (!_path.empty ())
+          {
+            unlink (_path.c_str ());
+          }
+      }
+  }
+
+  bool vm68k_gdbstub::listen_tcp (int port)
+  {
+    assert (_listener == -1);
+    int s = socket (AF_INET, SOCK_STREAM, 0);
+    if (s == -1)
+      {
+        return false;
+      }
+
+    int on = 1;
+    setsockopt (s, SOL_SOCKET, SO_REUSEADDR, &on, sizeof on);
+
+    struct sockaddr_in addr;
+    std::memset (&addr, 0, sizeof addr);
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons (port);
+    addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+    if (bind (s, (struct sockaddr *) &addr, sizeof addr) == -1
+        || listen (s, 1) == -1)
+      {
+        close (s);
+        return false;
+      }
+
+    _listener = s;
+    return true;
+  }
+
+  bool vm68k_gdbstub::listen_unix (const char *path)
+  {
+    assert (_listener == -1);
+    struct sockaddr_un addr;
+    if (std::strlen (path) >= sizeof addr.sun_path)
+      {
+        return false;
+      }
+
+    int s = socket (AF_UNIX, SOCK_STREAM, 0);
+    if (s == -1)
+      {
+        return false;
+      }
+
+    std::memset (&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    std::strcpy (addr.sun_path, path);
+    if (bind (s, (struct sockaddr *) &addr, sizeof addr) == -1
+        || listen (s, 1) == -1)
+      {
+        close (s);
+        return false;
+      }
+
+    _listener = s;
+    _path = path;
+    return true;
+  }
+
+  vm68k_address_t vm68k_gdbstub::serve (vm68k_address_t pc)
+  {
+    assert (_listener != -1);
+    _pc = pc;
+
+    do
+      {
+        _connection = accept (_listener, NULL, NULL);
+      }
+    while (_connection == -1 && errno == EINTR);
+    if (_connection == -1)
+      {
+        return _pc;
+      }
+
+    string packet, reply;
+    while (this->receive (packet))
+      {
+        bool more = this->handle (packet, reply);
+        if (!this->send (reply) || !more)
+          {
+            break;
+          }
+      }
+
+    close (_connection);
+    _connection = -1;
+    return _pc;
+  }
+
+  bool vm68k_gdbstub::handle (const string &packet, string &reply)
+  {
+    reply.clear ();
+    if (packet.empty ())
+      {
+        return true;
+      }
+
+    vm68k_bus *bus = _context->bus ();
+    vm68k_bus::function_code func =
+      _context->super () ? vm68k_bus::SUPER_DATA : vm68k_bus::USER_DATA;
+    string::size_type i = 1;
+    switch (packet[0])
+      {
+      case '?':
+        reply = signal_reply (SIGNAL_TRAP);
+        break;
+
+      case 'g':
+        for (int regno = 0; regno != REGISTER_COUNT; ++regno)
+          {
+            append_hex (reply, this->read_register (regno), 4);
+          }
+        break;
+
+      case 'G':
+        for (int regno = 0;
+             regno != REGISTER_COUNT && i + 8 <= packet.size (); ++regno)
+          {
+            string digits = packet.substr (i, 8);
+            string::size_type k = 0;
+            this->write_register (regno, parse_hex (digits, k));
+            i += 8;
+          }
+        reply = "OK";
+        break;
+
+      case 'p':
+        {
+          int regno = parse_hex (packet, i);
+          if (regno < REGISTER_COUNT)
+            {
+              append_hex (reply, this->read_register (regno), 4);
+            }
+          else
+            {
+              reply = "E01";
+            }
+        }
+        break;
+
+      case 'P':
+        {
+          int regno = parse_hex (packet, i);
+          if (regno < REGISTER_COUNT && i != packet.size ()
+              && packet[i] == '=')
+            {
+              ++i;
+              this->write_register (regno, parse_hex (packet, i));
+              reply = "OK";
+            }
+          else
+            {
+              reply = "E01";
+            }
+        }
+        break;
+
+      case 'm':
+        {
+          vm68k_address_t addr = parse_hex (packet, i);
+          ++i;
+          uint_fast32_t size = parse_hex (packet, i);
+          try
+            {
+              for (uint_fast32_t k = 0; k != size; ++k)
+                {
+                  append_hex (reply, bus->read8 (func, addr + k), 1);
+                }
+            }
+          catch (const vm68k_bus_error &)
+            {
+              if (reply.empty ())
+                {
+                  reply = "E01";
+                }
+            }
+        }
+        break;
+
+      case 'M':
+        {
+          vm68k_address_t addr = parse_hex (packet, i);
+          ++i;
+          uint_fast32_t size = parse_hex (packet, i);
+          ++i;
+          try
+            {
+              for (uint_fast32_t k = 0;
+                   k != size && i + 1 < packet.size (); ++k, i += 2)
+                {
+                  int value = hex_value (packet[i]) << 4
+                    | hex_value (packet[i + 1]);
+                  bus->write8 (func, addr + k, value);
+                }
+              bus->flush_posted_writes ();
+              reply = "OK";
+            }
+          catch (const vm68k_bus_error &)
+            {
+              reply = "E01";
+            }
+        }
+        break;
+
+      case 'c':
+      case 's':
+        if (i != packet.size ())
+          {
+            _pc = parse_hex (packet, i);
+          }
+        reply = this->resume (packet[0] == 's');
+        break;
+
+      case 'Z':
+      case 'z':
+        {
+          int kind = parse_hex (packet, i);
+          ++i;
+          vm68k_address_t addr = parse_hex (packet, i);
+          ++i;
+          uint_fast32_t size = parse_hex (packet, i);
+          bool insert = packet[0] == 'Z';
+          if (kind == 0 || kind == 1)
+            {
+              if (insert)
+                {
+                  _decoder->set_breakpoint (*_context, addr);
+                }
+              else
+                {
+                  _decoder->remove_breakpoint (addr);
+                }
+              reply = "OK";
+            }
+          else if (kind >= WATCH_KIND_WRITE && kind <= WATCH_KIND_ACCESS)
+            {
+              std::pair<int, vm68k_address_t> key (kind, addr);
+              std::map<std::pair<int, vm68k_address_t>, int>::iterator k =
+                _watchpoints.find (key);
+              if (k != _watchpoints.end ())
+                {
+                  bus->remove_watchpoint (k->second);
+                  _watchpoints.erase (k);
+                }
+              if (insert)
+                {
+                  int type = vm68k_bus::WATCH_ACCESS;
+                  if (kind == WATCH_KIND_WRITE)
+                    {
+                      type = vm68k_bus::WATCH_WRITE;
+                    }
+                  else if (kind == WATCH_KIND_READ)
+                    {
+                      type = vm68k_bus::WATCH_READ;
+                    }
+                  _watchpoints[key] =
+                    bus->set_watchpoint (1 << vm68k_bus::USER_DATA
+                                         | 1 << vm68k_bus::SUPER_DATA,
+                                         addr, size != 0 ? size : 1,
+                                         type, this);
+                }
+              reply = "OK";
+            }
+        }
+        break;
+
+      case 'H':
+        reply = "OK";
+        break;
+
+      case 'q':
+        if (packet.compare (0, 10, "qSupported") == 0)
+          {
+            reply = "PacketSize=1000";
+          }
+        else if (packet == "qAttached")
+          {
+            reply = "1";
+          }
+        else if (packet == "qC")
+          {
+            reply = "QC1";
+          }
+        break;
+
+      case 'D':
+        reply = "OK";
+        return false;
+
+      case 'k':
+        return false;
+
+      default:
+        break;
+      }
+
+    return true;
+  }
+
+  string vm68k_gdbstub::resume (bool step)
+  {
+    // The instruction at a breakpoint the debugger resumes from must
+    // be executed.
+    if (_decoder->breakpoint (_pc))
+      {
+        _context->set_stop_reason (vm68k_context::STOP_BREAKPOINT);
+      }
+    _watch_kind = 0;
+
+    int sig = SIGNAL_TRAP;
+    {
+      break_watcher watcher (_connection, _context);
+      _running = true;
+      try
+        {
+          if (step)
+            {
+              _pc = _decoder->run (_pc, *_context, 1);
+            }
+          else
+            {
+              _pc = _decoder->run (_pc, *_context);
+            }
+          if (_context->stop_reason () == vm68k_context::STOP_REQUESTED
+              && _watch_kind == 0)
+            {
+              sig = SIGNAL_INT;
+            }
+        }
+      catch (const vm68k_exception &e)
+        {
+          _pc = e.pc ();
+          switch (e.vecno ())
+            {
+            case 2:
+            case 3:
+              sig = SIGNAL_BUS;
+              break;
+            case 5:
+              sig = SIGNAL_FPE;
+              break;
+            default:
+              sig = SIGNAL_ILL;
+              break;
+            }
+        }
+      _running = false;
+    }
+
+    // A break that came after the program stopped is not for it.
+    _context->stop_requested ();
+
+    string reply;
+    if (_watch_kind != 0)
+      {
+        reply = "T";
+        append_hex (reply, SIGNAL_TRAP, 1);
+        switch (_watch_kind)
+          {
+          case WATCH_KIND_WRITE:
+            reply += "watch:";
+            break;
+          case WATCH_KIND_READ:
+            reply += "rwatch:";
+            break;
+          default:
+            reply += "awatch:";
+            break;
+          }
+        append_hex (reply, _watch_address, 4);
+        reply += ';';
+        return reply;
+      }
+
+    return signal_reply (sig);
+  }
+
+  void vm68k_gdbstub::hit (int id, vm68k_bus::function_code,
+                           vm68k_address_t addr, int,
+                           vm68k_bus::direction_code, uint_fast32_t)
+    throw (vm68k_bus_error)
+  {
+    // Accesses made for the debugger do not stop the program.
+    if (!_running || _watch_kind != 0)
+      {
+        return;
+      }
+
+    for (std::map<std::pair<int, vm68k_address_t>, int>::const_iterator i =
+           _watchpoints.begin ();
+         i != _watchpoints.end (); ++i)
+      {
+        if (i->second == id)
+          {
+            _watch_kind = i->first.first;
+            _watch_address = addr;
+          }
+      }
+    _context->request_stop ();
+  }
+
+  uint_fast32_t vm68k_gdbstub::read_register (int regno) const
+  {
+    switch (regno)
+      {
+      case REGISTER_SR:
+        return _context->status ();
+      case REGISTER_PC:
+        return _pc;
+      default:
+        return _context->read_reg_unsigned (vm68k_data_size::LONG_WORD,
+                                            regno);
+      }
+  }
+
+  void vm68k_gdbstub::write_register (int regno, uint_fast32_t value)
+  {
+    switch (regno)
+      {
+      case REGISTER_SR:
+        _context->set_status (value & 0xffffU);
+        break;
+      case REGISTER_PC:
+        _pc = value;
+        break;
+      default:
+        _context->write_reg (vm68k_data_size::LONG_WORD, regno, value);
+        break;
+      }
+  }
+
+  bool vm68k_gdbstub::receive (string &packet)
+  {
+    for (;;)
+      {
+        char c;
+        do
+          {
+            ssize_t n = recv (_connection, &c, 1, 0);
+            if (n <= 0)
+              {
+                if (n == -1 && errno == EINTR)
+                  {
+                    continue;
+                  }
+                return false;
+              }
+          }
+        while (c != '$');
+
+        packet.clear ();
+        unsigned int sum = 0;
+        for (;;)
+          {
+            ssize_t n = recv (_connection, &c, 1, 0);
+            if (n <= 0)
+              {
+                return false;
+              }
+            if (c == '#')
+              {
+                break;
+              }
+            sum += (unsigned char) c;
+            packet += c;
+          }
+
+        char check[2];
+        for (int k = 0; k != 2; ++k)
+          {
+            if (recv (_connection, &check[k], 1, 0) <= 0)
+              {
+                return false;
+              }
+          }
+
+        bool good = (unsigned int) (hex_value (check[0]) << 4
+                                    | hex_value (check[1])) == (sum & 0xff);
+        char ack = good ? '+' : '-';
+        if (::send (_connection, &ack, 1, 0) != 1)
+          {
+            return false;
+          }
+        if (good)
+          {
+            return true;
+          }
+      }
+  }
+
+  bool vm68k_gdbstub::send (const string &packet)
+  {
+    string frame = "$";
+    unsigned int sum = 0;
+    for (string::const_iterator i = packet.begin (); i != packet.end (); ++i)
+      {
+        sum += (unsigned char) *i;
+      }
+    frame += packet;
+    frame += '#';
+    append_hex (frame, sum & 0xff, 1);
+
+    for (;;)
+      {
+        const char *p = frame.data ();
+        string::size_type rest = frame.size ();
+        while (rest != 0)
+          {
+            ssize_t n = ::send (_connection, p, rest, 0);
+            if (n <= 0)
+              {
+                if (n == -1 && errno == EINTR)
+                  {
+                    continue;
+                  }
+                return false;
+              }
+            p += n;
+            rest -= n;
+          }
+
+        // Waits for the acknowledgment, resending on a negative one.
+        char ack;
+        do
+          {
+            if (recv (_connection, &ack, 1, 0) <= 0)
+              {
+                return false;
+              }
+          }
+        while (ack != '+' && ack != '-');
+        if (ack == '+')
+          {
+            return true;
+          }
+      }
+  }
+}
@@ -0,0 +1,546 @@
+/* Virtual M68000 Toolkit
+   Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307
+   USA.  */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/history>
+
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+using std::clock;
+using std::clock_t;
+using std::deque;
+using std::size_t;
+using std::vector;
+
+namespace vx68k
+{
+  const double vm68k_history::DEFAULT_STEP_TIME = 0.05;
+
+  /* Filter that tells the history the first write to a page.  */
+  class vm68k_history::page_filter : public vm68k_bus::filter
+  {
+  public:
+    page_filter (vm68k_history *history, std::size_t i,
+                 vm68k_bus::function_code func)
+    {
+      _history = history;
+      _index = i;
+      _func = func;
+    }
+
+  public:
+    vm68k_bus::function_code func () const
+    {
+      return _func;
+    }
+
+    /* Returns the mappable under all the filters of the page.  */
+    vm68k_bus::mappable *base () const
+    {
+      vm68k_bus::mappable *m = this->next ();
+      for (;;)
+        {
+          vm68k_bus::filter *f = dynamic_cast<vm68k_bus::filter *> (m);
+          if (f == NULL)
+            {
+              return m;
+            }
+          m = f->next ();
+        }
+    }
+
+  public:
+    // The page is saved and the filter detached before the write is
+    // forwarded.
+    void write8 (vm68k_bus::function_code func, vm68k_address_t addr,
+                 uint_fast8_t value) throw (vm68k_bus_error)
+    {
+      vm68k_bus::mappable *next = this->next ();
+      _history->page_written (_index);
+      next->write8 (func, addr, value);
+    }
+
+    void write16 (vm68k_bus::function_code func, vm68k_address_t addr,
+                  uint_fast16_t value) throw (vm68k_bus_error)
+    {
+      vm68k_bus::mappable *next = this->next ();
+      _history->page_written (_index);
+      next->write16 (func, addr, value);
+    }
+
+    void write32 (vm68k_bus::function_code func, vm68k_address_t addr,
+                  uint_fast32_t value) throw (vm68k_bus_error)
+    {
+      vm68k_bus::mappable *next = this->next ();
+      _history->page_written (_index);
+      next->write32 (func, addr, value);
+    }
+
+  private:
+    vm68k_history *_history;
+    std::size_t _index;
+    vm68k_bus::function_code _func;
+  };
+
+  /* Watch handler that keeps the position of the last hit.  */
+  class vm68k_history::watch_recorder : public vm68k_bus::watch_handler
+  {
+  public:
+    explicit watch_recorder (const vm68k_journal *journal)
+    {
+      _journal = journal;
+      this->reset (0);
+    }
+
+  public:
+    bool found () const
+    {
+      return _found;
+    }
+
+    unsigned long long position () const
+    {
+      return _position;
+    }
+
+    /* Forgets hits and ignores ones at LIMIT or later.  */
+    void reset (unsigned long long limit)
+    {
+      _found = false;
+      _position = 0;
+      _limit = limit;
+    }
+
+    void hit (int, vm68k_bus::function_code, vm68k_address_t, int,
+              vm68k_bus::direction_code, uint_fast32_t)
+      throw (vm68k_bus_error)
+    {
+      // The position during an instruction is the number of the ones
+      // finished before it.
+      unsigned long long position = _journal->instruction_count ();
+      if (position < _limit)
+        {
+          _found = true;
+          _position = position;
+        }
+    }
+
+  private:
+    const vm68k_journal *_journal;
+    bool _found;
+    unsigned long long _position;
+    unsigned long long _limit;
+  };
+
+  vm68k_history::vm68k_history (const vm68k_instruction_decoder *decoder,
+                                vm68k_context *c)
+  {
+    _decoder = decoder;
+    _context = c;
+    _saved_bytes = 0;
+    _memory_limit = DEFAULT_MEMORY_LIMIT;
+    _pc = 0;
+    _interval = MIN_INTERVAL;
+    _step_time = DEFAULT_STEP_TIME;
+    _run_count = 0;
+    _run_time = 0;
+
+    _context->set_journal (&_journal);
+  }
+
+  vm68k_history::~vm68k_history ()
+  {
+    _context->set_journal (NULL);
+    _journal.remove_devices ();
+
+    vm68k_bus *bus = _context->bus ();
+    for (vector<memory_page>::iterator i = _pages.begin ();
+         i != _pages.end (); ++i)
+      {
+        for (vector<page_filter *>::iterator j = i->filters.begin ();
+             j != i->filters.end (); ++j)
+          {
+            if (i->armed)
+              {
+                bus->detach_filter ((*j)->func (), i->address, *j);
+              }
+            delete *j;
+          }
+      }
+  }
+
+  void vm68k_history::add_memory (int func_mask, vm68k_address_t addr,
+                                  uint_fast32_t size)
+  {
+    if (size == 0)
+      {
+        return;
+      }
+
+    vm68k_address_t first = addr & ~(PAGE_SIZE - 1);
+    vm68k_address_t last = (addr + (size - 1)) & ~(PAGE_SIZE - 1);
+    for (vm68k_address_t page = first; ; page += PAGE_SIZE)
+      {
+        memory_page p;
+        p.address = page;
+        p.base = NULL;
+        p.armed = false;
+        _pages.push_back (p);
+
+        size_t i = _pages.size () - 1;
+        int mask = func_mask;
+        for (int func = 0; func != 7; mask >>= 1, ++func)
+          {
+            if ((mask & 1U) != 0)
+              {
+                _pages[i].filters.push_back
+                  (new page_filter (this, i, (vm68k_bus::function_code) func));
+              }
+          }
+        if (_pages[i].filters.empty ())
+          {
+            _pages.pop_back ();
+            return;
+          }
+        this->arm (i);
+        _pages[i].base = _pages[i].filters.front ()->base ();
+
+        if (page == last)
+          {
+            break;
+          }
+      }
+  }
+
+  void vm68k_history::arm (size_t i)
+  {
+    memory_page &p = _pages[i];
+    if (p.armed)
+      {
+        return;
+      }
+
+    vm68k_bus *bus = _context->bus ();
+    for (vector<page_filter *>::iterator j = p.filters.begin ();
+         j != p.filters.end (); ++j)
+      {
+        bus->attach_filter ((*j)->func (), p.address, *j);
+      }
+    p.armed = true;
+  }
+
+  void vm68k_history::page_written (size_t i)
+  {
+    memory_page &p = _pages[i];
+    assert (p.armed && !p.filters.empty ());
+
+    // Writes before the first checkpoint need not be saved.
+    if (!_checkpoints.empty ())
+      {
+        checkpoint &k = _checkpoints.back ();
+        k.pages.push_back (i);
+        k.data.resize (k.data.size () + PAGE_SIZE);
+
+        unsigned char *data = &k.data[k.data.size () - PAGE_SIZE];
+        vm68k_bus::function_code func = p.filters.front ()->func ();
+        vm68k_bus::mappable *m = p.base;
+        const unsigned char *src = m->direct (func, p.address);
+        if (src != NULL)
+          {
+            std::memcpy (data, src, PAGE_SIZE);
+          }
+        else
+          {
+            for (size_t j = 0; j != PAGE_SIZE; ++j)
+              {
+                data[j] = m->read8 (func, p.address + j);
+              }
+          }
+        _saved_bytes += PAGE_SIZE;
+      }
+
+    // The page is accessed directly again until the next checkpoint.
+    vm68k_bus *bus = _context->bus ();
+    for (vector<page_filter *>::iterator j = p.filters.begin ();
+         j != p.filters.end (); ++j)
+      {
+        bus->detach_filter ((*j)->func (), p.address, *j);
+      }
+    p.armed = false;
+    _dirty.push_back (i);
+  }
+
+  void vm68k_history::take_checkpoint (vm68k_address_t pc)
+  {
+    for (vector<size_t>::iterator i = _dirty.begin (); i != _dirty.end ();
+         ++i)
+      {
+        this->arm (*i);
+      }
+    _dirty.clear ();
+
+    _checkpoints.push_back (checkpoint ());
+    checkpoint &k = _checkpoints.back ();
+    k.count = _journal.instruction_count ();
+    k.position = _journal.position ();
+    k.pc = pc;
+    _context->save (k.state);
+
+    // The oldest checkpoints are dropped for memory.
+    while (_saved_bytes > _memory_limit && _checkpoints.size () > 1)
+      {
+        _saved_bytes -= _checkpoints.front ().data.size ();
+        _checkpoints.pop_front ();
+      }
+
+    // The interval is adjusted to the speed of the last one.
+    if (_run_time > 0)
+      {
+        double rate = _run_count * (double) CLOCKS_PER_SEC / _run_time;
+        double interval = rate * _step_time;
+        _interval = (unsigned long) std::max<double>
+          (MIN_INTERVAL, std::min<double> (MAX_INTERVAL, interval));
+      }
+    _run_count = 0;
+    _run_time = 0;
+  }
+
+  vm68k_address_t vm68k_history::run (vm68k_address_t pc,
+                                      unsigned long count)
+  {
+    if (_checkpoints.empty ())
+      {
+        this->take_checkpoint (pc);
+      }
+
+    while (count != 0)
+      {
+        unsigned long long start = this->position ();
+        unsigned long long next = _checkpoints.back ().count + _interval;
+        unsigned long n = count;
+        if (next > start && next - start < n)
+          {
+            n = next - start;
+          }
+
+        clock_t start_time = clock ();
+        pc = _decoder->run (pc, *_context, n);
+        _run_time += clock () - start_time;
+        _run_count += this->position () - start;
+        count -= n;
+
+        if (this->position () >= next)
+          {
+            this->take_checkpoint (pc);
+          }
+        if (_context->stop_reason () != vm68k_context::STOP_NONE)
+          {
+            break;
+          }
+      }
+
+    _pc = pc;
+    return pc;
+  }
+
+  void vm68k_history::restore (deque<checkpoint>::size_type k)
+  {
+    assert (k < _checkpoints.size ());
+    vm68k_bus *bus = _context->bus ();
+
+    // Pages are restored from the newest checkpoint, so that each
+    // gets its contents at checkpoint K.
+    for (deque<checkpoint>::size_type i = _checkpoints.size (); i-- != k; )
+      {
+        checkpoint &c = _checkpoints[i];
+        for (size_t j = 0; j != c.pages.size (); ++j)
+          {
+            const memory_page &p = _pages[c.pages[j]];
+            const unsigned char *data = &c.data[j * PAGE_SIZE];
+            vm68k_bus::function_code func = p.filters.front ()->func ();
+            vm68k_bus::mappable *m = p.base;
+
+            // The bytes that change are tracked for the code listeners,
+            // as the writes do not go through the bus.
+            size_t first = PAGE_SIZE;
+            size_t last = 0;
+            unsigned char *dest = m->direct (func, p.address);
+            for (size_t l = 0; l != PAGE_SIZE; ++l)
+              {
+                uint_fast8_t old = dest != NULL ? dest[l]
+                  : m->read8 (func, p.address + l);
+                if (old != data[l])
+                  {
+                    first = std::min (first, l);
+                    last = l + 1;
+                  }
+              }
+            if (first == PAGE_SIZE)
+              {
+                continue;
+              }
+
+            if (dest != NULL)
+              {
+                std::memcpy (dest + first, data + first, last - first);
+              }
+            else
+              {
+                for (size_t l = first; l != last; ++l)
+                  {
+                    m->write8 (func, p.address + l, data[l]);
+                  }
+              }
+
+            int func_mask = 0;
+            for (vector<page_filter *>::const_iterator f =
+                   p.filters.begin ();
+                 f != p.filters.end (); ++f)
+              {
+                func_mask |= 1 << (*f)->func ();
+              }
+            bus->code_changed (func_mask, p.address + first, last - first);
+          }
+        _saved_bytes -= c.data.size ();
+        if (i != k)
+          {
+            _checkpoints.pop_back ();
+          }
+      }
+
+    checkpoint &c = _checkpoints.back ();
+    c.pages.clear ();
+    c.data.clear ();
+    for (vector<size_t>::iterator i = _dirty.begin (); i != _dirty.end ();
+         ++i)
+      {
+        this->arm (*i);
+      }
+    _dirty.clear ();
+
+    _context->restore (c.state);
+    _context->set_stop_reason (vm68k_context::STOP_NONE);
+    _journal.rewind (c.position, c.count);
+    _pc = c.pc;
+  }
+
+  void vm68k_history::replay_to (unsigned long long target)
+  {
+    while (this->position () < target)
+      {
+        unsigned long long start = this->position ();
+        this->run (_pc, std::min<unsigned long long>
+                   (target - start, ~0UL));
+
+        // The run after a breakpoint passes it.
+        vm68k_context::stop_reason_type reason = _context->stop_reason ();
+        if (reason == vm68k_context::STOP_BREAKPOINT)
+          {
+            continue;
+          }
+        if (reason != vm68k_context::STOP_NONE
+            || this->position () == start)
+          {
+            break;
+          }
+      }
+  }
+
+  vm68k_address_t vm68k_history::step_back (unsigned long long n)
+  {
+    if (_checkpoints.empty ())
+      {
+        return _pc;
+      }
+
+    unsigned long long target = this->position ();
+    target = target - std::min (target - this->first_position (), n);
+
+    deque<checkpoint>::size_type k = _checkpoints.size () - 1;
+    while (_checkpoints[k].count > target)
+      {
+        --k;
+      }
+    this->restore (k);
+    this->replay_to (target);
+    return _pc;
+  }
+
+  bool vm68k_history::reverse_to_watchpoint (int func_mask,
+                                             vm68k_address_t addr,
+                                             uint_fast32_t size, int type,
+                                             vm68k_address_t &pc)
+  {
+    if (_checkpoints.empty ())
+      {
+        pc = _pc;
+        return false;
+      }
+
+    // The checkpoints are searched from the newest one, replaying the
+    // range up to the next one.  The later checkpoints are dropped
+    // and taken again as each range is replayed.
+    vector<unsigned long long> limits;
+    for (deque<checkpoint>::iterator i = _checkpoints.begin () + 1;
+         i != _checkpoints.end (); ++i)
+      {
+        limits.push_back (i->count);
+      }
+    limits.push_back (this->position ());
+
+    vm68k_bus *bus = _context->bus ();
+    watch_recorder w (&_journal);
+    int id = bus->set_watchpoint (func_mask, addr, size, type, &w);
+    for (deque<checkpoint>::size_type k = limits.size (); k-- != 0; )
+      {
+        this->restore (k);
+        w.reset (limits[k]);
+        this->replay_to (limits[k]);
+        if (w.found ())
+          {
+            bus->remove_watchpoint (id);
+            this->restore (k);
+            this->replay_to (w.position ());
+            pc = _pc;
+            return true;
+          }
+      }
+    bus->remove_watchpoint (id);
+
+    this->restore (0);
+    pc = _pc;
+    return false;
+  }
+}
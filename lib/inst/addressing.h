@@ -19,9 +19,8 @@
 #ifndef INST_ADDRESSING_H
 #define INST_ADDRESSING_H 1
 
-#include <string>
-#include <cstdio>
 #include <vm68k/context>
+#include "text.h"
 
 #include <cassert>
 
@@ -29,6 +28,7 @@ namespace vx68k_m68k
 {
   using namespace vx68k;
   using vx68k::uint_fast16_t;   // avoid ambiguity
+  using vx68k::uint_fast32_t;
 
   /* Data register direct addressing.  */
   template<class Size>
@@ -64,11 +64,18 @@ namespace vx68k_m68k
     {
     }
 
-    std::string text (const vm68k_context *) const
+    /* Returns true if an access to the operand faulted.  The
+       handlers stop before they change any state then.  */
+    bool faulted (const vm68k_context *) const
     {
-      char buf[32];
-      std::sprintf (buf, "%%d%d", _regno - 0);
-      return buf;
+      return false;
+    }
+
+    /* Writes the text of the operand to P.  Returns the end of the
+       text.  */
+    char *text (const vm68k_code_image &, char *p) const
+    {
+      return write_reg (p, _regno);
     }
 
   private:
@@ -113,11 +120,14 @@ namespace vx68k_m68k
     {
     }
 
-    std::string text (const vm68k_context *) const
+    bool faulted (const vm68k_context *) const
     {
-      char buf[32];
-      std::sprintf (buf, "%%a%d", _regno - 8);
-      return buf;
+      return false;
+    }
+
+    char *text (const vm68k_code_image &, char *p) const
+    {
+      return write_reg (p, _regno);
     }
 
   private:
@@ -180,16 +190,27 @@ namespace vx68k_m68k
       c->store (Size (), this->address (c), value);
     }
 
-    void finish (vm68k_context *c) const
+    void finish (vm68k_context *) const
+    {
+    }
+
+    bool faulted (const vm68k_context *c) const
+    {
+      return c->fault_pending ();
+    }
+
+    char *text (const vm68k_code_image &, char *p) const
     {
+      p = write_reg (p, _regno);
+      *p++ = '@';
+      return p;
     }
 
-    std::string text (const vm68k_context *c) const
+    /* Sets A to the address of the operand if it is known before run
+       time.  Returns false if not.  */
+    bool static_address (const vm68k_code_image &, vm68k_address_t &) const
     {
-      char buf[64];
-      std::sprintf (buf, "%%a%d@ /*= %#lx*/", _regno - 8,
-                    (unsigned long) this->address (Size (), c));
-      return buf;
+      return false;
     }
 
   private:
@@ -232,12 +253,17 @@ namespace vx68k_m68k
                     this->address (c) + increment_size ());
     }
 
-    std::string text (const vm68k_context *c) const
+    bool faulted (const vm68k_context *c) const
     {
-      char buf[64];
-      std::sprintf (buf, "%%a%d@+ /*= %#lx*/", _regno - 8,
-                    (unsigned long) this->address (Size (), c));
-      return buf;
+      return c->fault_pending ();
+    }
+
+    char *text (const vm68k_code_image &, char *p) const
+    {
+      p = write_reg (p, _regno);
+      *p++ = '@';
+      *p++ = '+';
+      return p;
     }
 
   protected:
@@ -297,12 +323,17 @@ namespace vx68k_m68k
       c->write_reg (vm68k_data_size::LONG_WORD, _regno, this->address (c));
     }
 
-    std::string text (const vm68k_context *c) const
+    bool faulted (const vm68k_context *c) const
+    {
+      return c->fault_pending ();
+    }
+
+    char *text (const vm68k_code_image &, char *p) const
     {
-      char buf[64];
-      std::sprintf (buf, "%%a%d@- /*= %#lx*/", _regno - 8,
-                    (unsigned long) this->address (Size (), c));
-      return buf;
+      p = write_reg (p, _regno);
+      *p++ = '@';
+      *p++ = '-';
+      return p;
     }
 
   protected:
@@ -352,30 +383,55 @@ namespace vx68k_m68k
 
     typename Size::udata_type get_unsigned (const vm68k_context *c) const
     {
-      return c->load_unsigned (Size (), this->address (c));
+      vm68k_address_t a = this->address (c);
+      if (c->fault_pending ())
+        {
+          return 0;
+        }
+      return c->load_unsigned (Size (), a);
     }
 
     typename Size::data_type get (const vm68k_context *c) const
     {
-      return c->load (Size (), this->address (c));
+      vm68k_address_t a = this->address (c);
+      if (c->fault_pending ())
+        {
+          return 0;
+        }
+      return c->load (Size (), a);
     }
 
     void put (vm68k_context *c, typename Size::udata_type value) const
     {
-      c->store (Size (), this->address (c), value);
+      vm68k_address_t a = this->address (c);
+      if (!c->fault_pending ())
+        {
+          c->store (Size (), a, value);
+        }
     }
 
-    void finish (vm68k_context *c) const
+    void finish (vm68k_context *) const
     {
     }
 
-    std::string text (const vm68k_context *c) const
+    bool faulted (const vm68k_context *c) const
     {
-      char buf[64];
-      std::sprintf (buf, "%%a%d@(%d) /*= %#lx*/", _regno - 8,
-                    (int) c->fetch (vm68k_data_size::WORD, _pc),
-                    (unsigned long) this->address (c));
-      return buf;
+      return c->fault_pending ();
+    }
+
+    char *text (const vm68k_code_image &code, char *p) const
+    {
+      p = write_reg (p, _regno);
+      *p++ = '@';
+      *p++ = '(';
+      p = write_decimal (p, vm68k_word::as_signed (code.fetch_word (_pc)));
+      *p++ = ')';
+      return p;
+    }
+
+    bool static_address (const vm68k_code_image &, vm68k_address_t &) const
+    {
+      return false;
     }
 
   private:
@@ -419,42 +475,52 @@ namespace vx68k_m68k
 
     typename Size::udata_type get_unsigned (const vm68k_context *c) const
     {
-      return c->load_unsigned (Size (), this->address (c));
+      vm68k_address_t a = this->address (c);
+      if (c->fault_pending ())
+        {
+          return 0;
+        }
+      return c->load_unsigned (Size (), a);
     }
 
     typename Size::data_type get (const vm68k_context *c) const
     {
-      return c->load (Size (), this->address (c));
+      vm68k_address_t a = this->address (c);
+      if (c->fault_pending ())
+        {
+          return 0;
+        }
+      return c->load (Size (), a);
     }
 
     void put (vm68k_context *c, typename Size::udata_type value) const
     {
-      c->store (Size (), this->address (c), value);
+      vm68k_address_t a = this->address (c);
+      if (!c->fault_pending ())
+        {
+          c->store (Size (), a, value);
+        }
     }
 
-    void finish (vm68k_context *c) const
+    void finish (vm68k_context *) const
     {
     }
 
-    std::string text (const vm68k_context *c) const
+    bool faulted (const vm68k_context *c) const
     {
-      uint_fast16_t w = c->fetch_unsigned (vm68k_data_size::WORD, _pc);
-      int x = w >> 12 & 0xf;
-      const char *xp = x >= 8 ? "%a" : "%d";
-      char buf[64];
-      if ((w & 0x800) != 0)
-        {
-          std::sprintf (buf, "%%a%d@(%d,%s%d:l) /*= %#lx*/", _regno - 8,
-                        (int) vm68k_byte::as_signed (w & 0xffU), xp, x & 7,
-                        (unsigned long) this->address (c));
-        }
-      else
-        {
-          std::sprintf (buf, "%%a%d@(%d,%s%d:w) /*= %#lx*/", _regno - 8,
-                        (int) vm68k_byte::as_signed (w & 0xffU), xp, x & 7,
-                        (unsigned long) this->address (c));
-        }
-      return buf;
+      return c->fault_pending ();
+    }
+
+    char *text (const vm68k_code_image &code, char *p) const
+    {
+      p = write_reg (p, _regno);
+      *p++ = '@';
+      return write_index (p, code.fetch_word (_pc));
+    }
+
+    bool static_address (const vm68k_code_image &, vm68k_address_t &) const
+    {
+      return false;
     }
 
   private:
@@ -484,28 +550,56 @@ namespace vx68k_m68k
 
     typename Size::udata_type get_unsigned (const vm68k_context *c) const
     {
-      return c->load_unsigned (Size (), this->address (c));
+      vm68k_address_t a = this->address (c);
+      if (c->fault_pending ())
+        {
+          return 0;
+        }
+      return c->load_unsigned (Size (), a);
     }
 
     typename Size::data_type get (const vm68k_context *c) const
     {
-      return c->load (Size (), this->address (c));
+      vm68k_address_t a = this->address (c);
+      if (c->fault_pending ())
+        {
+          return 0;
+        }
+      return c->load (Size (), a);
     }
 
     void put (vm68k_context *c, typename Size::udata_type value) const
     {
-      c->store (Size (), this->address (c), value);
+      vm68k_address_t a = this->address (c);
+      if (!c->fault_pending ())
+        {
+          c->store (Size (), a, value);
+        }
     }
 
-    void finish (vm68k_context *c) const
+    void finish (vm68k_context *) const
+    {
+    }
+
+    bool faulted (const vm68k_context *c) const
     {
+      return c->fault_pending ();
     }
 
-    std::string text (const vm68k_context *c) const
+    char *text (const vm68k_code_image &code, char *p) const
     {
-      char buf[32];
-      std::sprintf (buf, "%#lx:w", (unsigned long) this->address (c));
-      return buf;
+      uint_fast32_t a = vm68k_word::as_signed (code.fetch_word (_pc));
+      p = write_hex (p, a & 0xffffffffU);
+      *p++ = ':';
+      *p++ = 'w';
+      return p;
+    }
+
+    bool static_address (const vm68k_code_image &code,
+                         vm68k_address_t &a) const
+    {
+      a = vm68k_word::as_signed (code.fetch_word (_pc)) & 0xffffffffU;
+      return true;
     }
 
   private:
@@ -534,28 +628,52 @@ namespace vx68k_m68k
 
     typename Size::udata_type get_unsigned (const vm68k_context *c) const
     {
-      return c->load_unsigned (Size (), this->address (c));
+      vm68k_address_t a = this->address (c);
+      if (c->fault_pending ())
+        {
+          return 0;
+        }
+      return c->load_unsigned (Size (), a);
     }
 
     typename Size::data_type get (const vm68k_context *c) const
     {
-      return c->load (Size (), this->address (c));
+      vm68k_address_t a = this->address (c);
+      if (c->fault_pending ())
+        {
+          return 0;
+        }
+      return c->load (Size (), a);
     }
 
     void put (vm68k_context *c, typename Size::udata_type value) const
     {
-      c->store (Size (), this->address (c), value);
+      vm68k_address_t a = this->address (c);
+      if (!c->fault_pending ())
+        {
+          c->store (Size (), a, value);
+        }
     }
 
-    void finish (vm68k_context *c) const
+    void finish (vm68k_context *) const
     {
     }
 
-    std::string text (const vm68k_context *c) const
+    bool faulted (const vm68k_context *c) const
     {
-      char buf[32];
-      std::sprintf (buf, "%#lx", (unsigned long) this->address (c));
-      return buf;
+      return c->fault_pending ();
+    }
+
+    char *text (const vm68k_code_image &code, char *p) const
+    {
+      return write_hex (p, code.fetch_long_word (_pc));
+    }
+
+    bool static_address (const vm68k_code_image &code,
+                         vm68k_address_t &a) const
+    {
+      a = code.fetch_long_word (_pc);
+      return true;
     }
 
   private:
@@ -584,25 +702,48 @@ namespace vx68k_m68k
 
     typename Size::udata_type get_unsigned (const vm68k_context *c) const
     {
-      return c->load_unsigned (Size (), this->address (c));
+      vm68k_address_t a = this->address (c);
+      if (c->fault_pending ())
+        {
+          return 0;
+        }
+      return c->load_unsigned (Size (), a);
     }
 
     typename Size::data_type get (const vm68k_context *c) const
     {
-      return c->load (Size (), this->address (c));
+      vm68k_address_t a = this->address (c);
+      if (c->fault_pending ())
+        {
+          return 0;
+        }
+      return c->load (Size (), a);
     }
 
-    void finish (vm68k_context *c) const
+    void finish (vm68k_context *) const
+    {
+    }
+
+    bool faulted (const vm68k_context *c) const
     {
+      return c->fault_pending ();
     }
 
-    std::string text (const vm68k_context *c) const
+    char *text (const vm68k_code_image &code, char *p) const
     {
-      char buf[64];
-      std::sprintf (buf, "%%pc@(%d) /*= %#lx*/",
-                    (int) c->fetch (vm68k_data_size::WORD, _pc),
-                    (unsigned long) this->address (c));
-      return buf;
+      // The target address is written instead of the displacement.
+      p = write_string (p, "%pc@(");
+      p = write_hex (p, (_pc + vm68k_word::as_signed (code.fetch_word (_pc)))
+                     & 0xffffffffU);
+      *p++ = ')';
+      return p;
+    }
+
+    bool static_address (const vm68k_code_image &code,
+                         vm68k_address_t &a) const
+    {
+      a = (_pc + vm68k_word::as_signed (code.fetch_word (_pc))) & 0xffffffffU;
+      return true;
     }
 
   private:
@@ -646,37 +787,42 @@ namespace vx68k_m68k
 
     typename Size::udata_type get_unsigned (const vm68k_context *c) const
     {
-      return c->load_unsigned (Size (), this->address (c));
+      vm68k_address_t a = this->address (c);
+      if (c->fault_pending ())
+        {
+          return 0;
+        }
+      return c->load_unsigned (Size (), a);
     }
 
     typename Size::data_type get (const vm68k_context *c) const
     {
-      return c->load (Size (), this->address (c));
+      vm68k_address_t a = this->address (c);
+      if (c->fault_pending ())
+        {
+          return 0;
+        }
+      return c->load (Size (), a);
     }
 
-    void finish (vm68k_context *c) const
+    void finish (vm68k_context *) const
     {
     }
 
-    std::string text (const vm68k_context *c) const
+    bool faulted (const vm68k_context *c) const
     {
-      uint_fast16_t w = c->fetch_unsigned (vm68k_data_size::WORD, _pc);
-      int x = w >> 12 & 0xf;
-      const char *xp = x >= 8 ? "%a" : "%d";
-      char buf[64];
-      if ((w & 0x800) != 0)
-        {
-          std::sprintf (buf, "%%pc@(%d,%s%d:l) /*= %#lx*/",
-                        (int) vm68k_byte::as_signed (w & 0xffU), xp, x & 7,
-                        (unsigned long) this->address (c));
-        }
-      else
-        {
-          std::sprintf (buf, "%%pc@(%d,%s%d:w) /*= %#lx*/",
-                        (int) vm68k_byte::as_signed (w & 0xffU), xp, x & 7,
-                        (unsigned long) this->address (c));
-        }
-      return buf;
+      return c->fault_pending ();
+    }
+
+    char *text (const vm68k_code_image &code, char *p) const
+    {
+      p = write_string (p, "%pc@");
+      return write_index (p, code.fetch_word (_pc));
+    }
+
+    bool static_address (const vm68k_code_image &, vm68k_address_t &) const
+    {
+      return false;
     }
 
   private:
@@ -712,15 +858,28 @@ namespace vx68k_m68k
       return c->fetch (Size (), _pc);
     }
 
-    void finish (vm68k_context *c) const
+    void finish (vm68k_context *) const
     {
     }
 
-    std::string text (const vm68k_context *c) const
+    bool faulted (const vm68k_context *c) const
     {
-      char buf[32];
-      std::sprintf (buf, "#%#lx", (unsigned long) this->get_unsigned (c));
-      return buf;
+      return c->fault_pending ();
+    }
+
+    char *text (const vm68k_code_image &code, char *p) const
+    {
+      uint_fast32_t v;
+      if (Size::data_size () > 2)
+        {
+          v = code.fetch_long_word (_pc);
+        }
+      else
+        {
+          v = code.fetch_word (_pc);
+        }
+      *p++ = '#';
+      return write_hex (p, Size::read_unsigned (v));
     }
 
   private:
@@ -21,15 +21,18 @@
 
 #include <vm68k/context>
 #include "addressing.h"
+#include "flags.h"
 
 #include <cassert>
 
 namespace vx68k_m68k
 {
+  using vx68k::uint_fast32_t;   // avoid ambiguity
+
   /**
    * Handles an ADDI instruction.
    */
-  template<class Size, template<class Size> class D>
+  template<class Size, template<class> class D, class Flags = all_flags>
   struct addi_instruction
   {
     static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
@@ -42,9 +45,17 @@ namespace vx68k_m68k
       D<Size> ea1 (w & 7, pc + Size::aligned_data_size ());
 
       udata_type v1 = ea1.get (c);
+      if (c->fault_pending ())
+        {
+          return pc;
+        }
       udata_type v = v1 + v2;
       ea1.put (c, v);
-      c->_status.set_cc_as_add (v, v1, v2);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
+      Flags::set_cc_as_add (c, v, v1, v2);
 
       ea1.finish (c);
       return pc + Size::aligned_data_size () + D<Size>::extension_size ();
@@ -52,33 +63,285 @@ namespace vx68k_m68k
   };
 
   /**
-   * Handles a CMPI instruction.
+   * Handles a CMP instruction.
    */
-  template<class Size, template<class Size> class D>
-  struct cmpi_instruction
+  template<class Size, template<class> class S, class Flags = all_flags>
+  struct cmp_instruction
   {
+    /* Compares the operands and returns the address of the next
+       instruction.  The compared values are stored in V1 and V2 so
+       that a condition can be tested on them directly.  */
+    static vm68k_address_t compare (vm68k_address_t pc, uint_fast16_t w,
+                                     vm68k_context *c,
+                                     typename Size::udata_type &v1,
+                                     typename Size::udata_type &v2)
+    {
+      typedef typename Size::udata_type udata_type;
+      assert (c != NULL);
+
+      S<Size> ea2 (w & 7, pc);
+      int r1 = w >> 9 & 7;
+
+      v2 = ea2.get_unsigned (c);
+      if (ea2.faulted (c))
+        {
+          return pc;
+        }
+      v1 = c->read_reg_unsigned (Size (), vm68k_context::D0 + r1);
+      udata_type v = v1 - v2;
+      Flags::set_cc_cmp (c, Size::as_signed (v), Size::as_signed (v1),
+                              Size::as_signed (v2));
+
+      ea2.finish (c);
+      return pc + S<Size>::extension_size ();
+    }
+
     static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
                                     vm68k_context *c)
+    {
+      typename Size::udata_type v1, v2;
+      return compare (pc, w, c, v1, v2);
+    }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &code, char *&p)
+    {
+      S<Size> ea2 (w & 7, pc);
+
+      p = write_mnemonic<Size> (p, "cmp");
+      p = ea2.text (code, p);
+      *p++ = ',';
+      p = write_reg (p, vm68k_context::D0 + (w >> 9 & 7));
+      return pc + S<Size>::extension_size ();
+    }
+  };
+
+  /**
+   * Handles a CMPI instruction.
+   */
+  template<class Size, template<class> class D, class Flags = all_flags>
+  struct cmpi_instruction
+  {
+    /* Compares the operands and returns the address of the next
+       instruction.  The compared values are stored in V1 and V2.  */
+    static vm68k_address_t compare (vm68k_address_t pc, uint_fast16_t w,
+                                     vm68k_context *c,
+                                     typename Size::udata_type &v1,
+                                     typename Size::udata_type &v2)
     {
       typedef typename Size::udata_type udata_type;
       assert (c != NULL);
 
-      udata_type v2 = c->fetch_unsigned (Size (), pc);
+      v2 = c->fetch_unsigned (Size (), pc);
       D<Size> ea1 (w & 7, pc + Size::aligned_data_size ());
 
-      udata_type v1 = ea1.get (c);
+      v1 = ea1.get_unsigned (c);
+      if (c->fault_pending ())
+        {
+          return pc;
+        }
       udata_type v = v1 - v2;
-      c->_status.set_cc_cmp (v, v1, v2);
+      Flags::set_cc_cmp (c, Size::as_signed (v), Size::as_signed (v1),
+                              Size::as_signed (v2));
 
       ea1.finish (c);
       return pc + Size::aligned_data_size () + D<Size>::extension_size ();
     }
+
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      typename Size::udata_type v1, v2;
+      return compare (pc, w, c, v1, v2);
+    }
+  };
+
+  /**
+   * Handles an ADDQ instruction to a data register or memory.
+   */
+  template<class Size, template<class> class D, class Flags = all_flags>
+  struct addq_instruction
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      typedef typename Size::udata_type udata_type;
+      assert (c != NULL);
+
+      udata_type v2 = (((w >> 9) - 1) & 7) + 1;
+      D<Size> ea1 (w & 7, pc);
+
+      udata_type v1 = ea1.get_unsigned (c);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
+      udata_type v = v1 + v2;
+      ea1.put (c, v);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
+      Flags::set_cc_as_add (c, Size::as_signed (v), Size::as_signed (v1),
+                                Size::as_signed (v2));
+
+      ea1.finish (c);
+      return pc + D<Size>::extension_size ();
+    }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &code, char *&p)
+    {
+      D<Size> ea1 (w & 7, pc);
+
+      p = write_mnemonic<Size> (p, "addq");
+      p = write_quick (p, w);
+      *p++ = ',';
+      p = ea1.text (code, p);
+      return pc + D<Size>::extension_size ();
+    }
+  };
+
+  /**
+   * Handles an ADDQ instruction to an address register.  The whole
+   * register is changed for any size.  This instruction does not
+   * change CCR.
+   */
+  struct addqa_instruction
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      assert (c != NULL);
+
+      int r1 = vm68k_context::A0 + (w & 7);
+      uint_fast32_t v2 = (((w >> 9) - 1) & 7) + 1;
+
+      c->write_reg (vm68k_data_size::LONG_WORD, r1,
+                    c->read_reg_unsigned (vm68k_data_size::LONG_WORD, r1)
+                    + v2);
+      return pc;
+    }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &, char *&p)
+    {
+      // The size is only in the operation word for this handler.
+      if ((w & 0x80) != 0)
+        {
+          p = write_mnemonic<vm68k_long_word> (p, "addq");
+        }
+      else
+        {
+          p = write_mnemonic<vm68k_word> (p, "addq");
+        }
+      p = write_quick (p, w);
+      *p++ = ',';
+      p = write_reg (p, vm68k_context::A0 + (w & 7));
+      return pc;
+    }
+  };
+
+  /**
+   * Handles a SUBQ instruction to a data register or memory.
+   */
+  template<class Size, template<class> class D, class Flags = all_flags>
+  struct subq_instruction
+  {
+    /* Subtracts and returns the address of the next instruction.  The
+       operands are stored in V1 and V2 as they would be compared.  */
+    static vm68k_address_t compare (vm68k_address_t pc, uint_fast16_t w,
+                                     vm68k_context *c,
+                                     typename Size::udata_type &v1,
+                                     typename Size::udata_type &v2)
+    {
+      typedef typename Size::udata_type udata_type;
+      assert (c != NULL);
+
+      v2 = (((w >> 9) - 1) & 7) + 1;
+      D<Size> ea1 (w & 7, pc);
+
+      v1 = ea1.get_unsigned (c);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
+      udata_type v = v1 - v2;
+      ea1.put (c, v);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
+      Flags::set_cc_sub (c, Size::as_signed (v), Size::as_signed (v1),
+                             Size::as_signed (v2));
+
+      ea1.finish (c);
+      return pc + D<Size>::extension_size ();
+    }
+
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      typename Size::udata_type v1, v2;
+      return compare (pc, w, c, v1, v2);
+    }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &code, char *&p)
+    {
+      D<Size> ea1 (w & 7, pc);
+
+      p = write_mnemonic<Size> (p, "subq");
+      p = write_quick (p, w);
+      *p++ = ',';
+      p = ea1.text (code, p);
+      return pc + D<Size>::extension_size ();
+    }
+  };
+
+  /**
+   * Handles a SUBQ instruction to an address register.  The whole
+   * register is changed for any size.  This instruction does not
+   * change CCR.
+   */
+  struct subqa_instruction
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      assert (c != NULL);
+
+      int r1 = vm68k_context::A0 + (w & 7);
+      uint_fast32_t v2 = (((w >> 9) - 1) & 7) + 1;
+
+      c->write_reg (vm68k_data_size::LONG_WORD, r1,
+                    c->read_reg_unsigned (vm68k_data_size::LONG_WORD, r1)
+                    - v2);
+      return pc;
+    }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &, char *&p)
+    {
+      if ((w & 0x80) != 0)
+        {
+          p = write_mnemonic<vm68k_long_word> (p, "subq");
+        }
+      else
+        {
+          p = write_mnemonic<vm68k_word> (p, "subq");
+        }
+      p = write_quick (p, w);
+      *p++ = ',';
+      p = write_reg (p, vm68k_context::A0 + (w & 7));
+      return pc;
+    }
   };
 
   /**
    * Handles a SUBI instruction.
    */
-  template<class Size, template<class Size> class D>
+  template<class Size, template<class> class D, class Flags = all_flags>
   struct subi_instruction
   {
     static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
@@ -91,14 +354,70 @@ namespace vx68k_m68k
       D<Size> ea1 (w & 7, pc + Size::aligned_data_size ());
 
       udata_type v1 = ea1.get (c);
+      if (c->fault_pending ())
+        {
+          return pc;
+        }
       udata_type v = v1 - v2;
       ea1.put (c, v);
-      c->_status.set_cc_sub (v, v1, v2);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
+      Flags::set_cc_sub (c, v, v1, v2);
 
       ea1.finish (c);
       return pc + Size::aligned_data_size () + D<Size>::extension_size ();
     }
   };
+
+  /**
+   * Handles a TST instruction.
+   */
+  template<class Size, template<class> class D, class Flags = all_flags>
+  struct tst_instruction
+  {
+    /* Tests the operand and returns the address of the next
+       instruction.  The operand is stored in V1 and zero in V2 as
+       they would be compared.  */
+    static vm68k_address_t compare (vm68k_address_t pc, uint_fast16_t w,
+                                     vm68k_context *c,
+                                     typename Size::udata_type &v1,
+                                     typename Size::udata_type &v2)
+    {
+      assert (c != NULL);
+
+      D<Size> ea1 (w & 7, pc);
+
+      v1 = ea1.get_unsigned (c);
+      v2 = 0;
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
+      Flags::set_cc (c, Size::as_signed (v1));
+
+      ea1.finish (c);
+      return pc + D<Size>::extension_size ();
+    }
+
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      typename Size::udata_type v1, v2;
+      return compare (pc, w, c, v1, v2);
+    }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &code, char *&p)
+    {
+      D<Size> ea1 (w & 7, pc);
+
+      p = write_mnemonic<Size> (p, "tst");
+      p = ea1.text (code, p);
+      return pc + D<Size>::extension_size ();
+    }
+  };
 }
 
 #endif
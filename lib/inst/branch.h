@@ -0,0 +1,336 @@
+/* -*-c++-*-
+ * branch - branch instructions for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INST_BRANCH_H
+#define INST_BRANCH_H 1
+
+#include <vm68k/processor>
+#include "addressing.h"
+
+#include <cassert>
+
+namespace vx68k_m68k
+{
+  /* Condition codes in operation words.  */
+  enum
+  {
+    CC_T,  CC_F,  CC_HI, CC_LS, CC_CC, CC_CS, CC_NE, CC_EQ,
+    CC_VC, CC_VS, CC_PL, CC_MI, CC_GE, CC_LT, CC_GT, CC_LE
+  };
+
+  /* Tests condition CC on the status register.  */
+  inline bool test_condition (const vm68k_context *c, int cc)
+  {
+    switch (cc)
+      {
+      case CC_T:
+        return true;
+      case CC_F:
+        return false;
+      case CC_HI:
+        return c->_status.hi ();
+      case CC_LS:
+        return c->_status.ls ();
+      case CC_CC:
+        return c->_status.cc ();
+      case CC_CS:
+        return c->_status.cs ();
+      case CC_NE:
+        return c->_status.ne ();
+      case CC_EQ:
+        return c->_status.eq ();
+      case CC_VC:
+        return (c->status () & 2U) == 0;
+      case CC_VS:
+        return (c->status () & 2U) != 0;
+      case CC_PL:
+        return c->_status.pl ();
+      case CC_MI:
+        return c->_status.mi ();
+      case CC_GE:
+        return c->_status.ge ();
+      case CC_LT:
+        return c->_status.lt ();
+      case CC_GT:
+        return c->_status.gt ();
+      default:
+        return c->_status.le ();
+      }
+  }
+
+  /* Tests condition CC as it would be after comparing V1 with V2 of
+     size Size, without evaluating the status register.  A test is the
+     comparison with zero.  */
+  template<class Size>
+  inline bool compare_condition (int cc, typename Size::udata_type v1,
+                                 typename Size::udata_type v2)
+  {
+    typename Size::udata_type u1 = Size::read_unsigned (v1);
+    typename Size::udata_type u2 = Size::read_unsigned (v2);
+    typename Size::data_type s1 = Size::as_signed (u1);
+    typename Size::data_type s2 = Size::as_signed (u2);
+    bool n = Size::as_signed (Size::read_unsigned (u1 - u2)) < 0;
+
+    switch (cc)
+      {
+      case CC_T:
+        return true;
+      case CC_F:
+        return false;
+      case CC_HI:
+        return u1 > u2;
+      case CC_LS:
+        return u1 <= u2;
+      case CC_CC:
+        return u1 >= u2;
+      case CC_CS:
+        return u1 < u2;
+      case CC_NE:
+        return u1 != u2;
+      case CC_EQ:
+        return u1 == u2;
+      case CC_VC:
+        return n == (s1 < s2);
+      case CC_VS:
+        return n != (s1 < s2);
+      case CC_PL:
+        return !n;
+      case CC_MI:
+        return n;
+      case CC_GE:
+        return s1 >= s2;
+      case CC_LT:
+        return s1 < s2;
+      case CC_GT:
+        return s1 > s2;
+      default:
+        return s1 <= s2;
+      }
+  }
+
+  /* Returns the address a Bcc instruction goes to.  PC is the address
+     after operation word W.  */
+  inline vm68k_address_t branch (vm68k_address_t pc, uint_fast16_t w,
+                                 vm68k_context *c, bool taken)
+  {
+    if ((w & 0xffU) == 0)
+      {
+        if (!taken)
+          {
+            return pc + vm68k_word::aligned_data_size ();
+          }
+        return pc + c->fetch (vm68k_data_size::WORD, pc);
+      }
+
+    if (!taken)
+      {
+        return pc;
+      }
+    return pc + vm68k_byte::as_signed (w & 0xffU);
+  }
+
+  /* Returns the address a DBcc instruction goes to.  PC is the address
+     after operation word W.  */
+  inline vm68k_address_t decrement_branch (vm68k_address_t pc,
+                                           uint_fast16_t w,
+                                           vm68k_context *c, bool done)
+  {
+    if (!done)
+      {
+        int r = vm68k_context::D0 + (w & 7);
+        uint_fast16_t count =
+          c->read_reg_unsigned (vm68k_data_size::WORD, r) - 1;
+        if ((count & 0xffffU) != 0xffffU)
+          {
+            // The displacement is fetched before the counter changes.
+            vm68k_address_t a = pc + c->fetch (vm68k_data_size::WORD, pc);
+            if (c->fault_pending ())
+              {
+                return pc;
+              }
+            c->write_reg (vm68k_data_size::WORD, r, count);
+            return a;
+          }
+        c->write_reg (vm68k_data_size::WORD, r, count);
+      }
+    return pc + vm68k_word::aligned_data_size ();
+  }
+
+  /* Returns the target address of a Bcc instruction in CODE.  PC is
+     the address after operation word W.  */
+  inline vm68k_address_t branch_target (vm68k_address_t pc, uint_fast16_t w,
+                                        const vm68k_code_image &code)
+  {
+    if ((w & 0xffU) == 0)
+      {
+        return (pc + vm68k_word::as_signed (code.fetch_word (pc)))
+          & 0xffffffffU;
+      }
+    return (pc + vm68k_byte::as_signed (w & 0xffU)) & 0xffffffffU;
+  }
+
+  /* Writes the target address of a Bcc instruction.  Returns the
+     address of the next instruction.  */
+  inline vm68k_address_t branch_text (vm68k_address_t pc, uint_fast16_t w,
+                                      const vm68k_code_image &code,
+                                      char *&p)
+  {
+    p = write_hex (p, branch_target (pc, w, code));
+    if ((w & 0xffU) == 0)
+      {
+        return pc + vm68k_word::aligned_data_size ();
+      }
+    return pc;
+  }
+
+  /**
+   * Handles a Bcc or BRA instruction.  This instruction does not
+   * change CCR.
+   */
+  template<int Cond>
+  struct bcc_instruction
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      assert (c != NULL);
+
+      return branch (pc, w, c, test_condition (c, Cond));
+    }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &code, char *&p)
+    {
+      if (Cond == CC_T)
+        {
+          p = write_string (p, "bra");
+        }
+      else
+        {
+          *p++ = 'b';
+          p = write_condition (p, Cond);
+        }
+      *p++ = (w & 0xffU) == 0 ? 'w' : 's';
+      *p++ = ' ';
+      return branch_text (pc, w, code, p);
+    }
+
+    static vm68k_instruction::flow_type flow (vm68k_address_t pc,
+                                              uint_fast16_t w,
+                                              const vm68k_code_image &code,
+                                              vm68k_address_t &target)
+    {
+      target = branch_target (pc, w, code);
+      if (Cond == CC_T)
+        {
+          return vm68k_instruction::FLOW_BRANCH;
+        }
+      return vm68k_instruction::FLOW_CONDITIONAL;
+    }
+  };
+
+  /**
+   * Handles a BSR instruction.  This instruction does not change CCR.
+   */
+  struct bsr_instruction
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      assert (c != NULL);
+
+      vm68k_address_t a = branch (pc, w, c, true);
+      vm68k_address_t ret = pc;
+      if ((w & 0xffU) == 0)
+        {
+          if (c->fault_pending ())
+            {
+              return pc;
+            }
+          ret += vm68k_word::aligned_data_size ();
+        }
+      c->push (vm68k_data_size::LONG_WORD, ret);
+
+      return a;
+    }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &code, char *&p)
+    {
+      p = write_string (p, "bsr");
+      *p++ = (w & 0xffU) == 0 ? 'w' : 's';
+      *p++ = ' ';
+      return branch_text (pc, w, code, p);
+    }
+
+    static vm68k_instruction::flow_type flow (vm68k_address_t pc,
+                                              uint_fast16_t w,
+                                              const vm68k_code_image &code,
+                                              vm68k_address_t &target)
+    {
+      target = branch_target (pc, w, code);
+      return vm68k_instruction::FLOW_CALL;
+    }
+  };
+
+  /**
+   * Handles a DBcc instruction.  This instruction does not change
+   * CCR.
+   */
+  template<int Cond>
+  struct dbcc_instruction
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      assert (c != NULL);
+
+      return decrement_branch (pc, w, c, test_condition (c, Cond));
+    }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &code, char *&p)
+    {
+      p = write_string (p, "db");
+      p = write_condition (p, Cond);
+      *p++ = ' ';
+      p = write_reg (p, vm68k_context::D0 + (w & 7));
+      *p++ = ',';
+      p = write_hex (p, (pc + vm68k_word::as_signed (code.fetch_word (pc)))
+                     & 0xffffffffU);
+      return pc + vm68k_word::aligned_data_size ();
+    }
+
+    static vm68k_instruction::flow_type flow (vm68k_address_t pc,
+                                              uint_fast16_t,
+                                              const vm68k_code_image &code,
+                                              vm68k_address_t &target)
+    {
+      // DBT never branches.
+      if (Cond == CC_T)
+        {
+          return vm68k_instruction::FLOW_NEXT;
+        }
+      target = (pc + vm68k_word::as_signed (code.fetch_word (pc)))
+        & 0xffffffffU;
+      return vm68k_instruction::FLOW_CONDITIONAL;
+    }
+  };
+}
+
+#endif
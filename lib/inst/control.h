@@ -1,62 +1,282 @@
-/* -*- C++ -*- */
-/* Control instructions for Virtual M68000 Toolkit
-   Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
-
-   This program is free software; you can redistribute it and/or modify
-   it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2 of the License, or (at
-   your option) any later version.
-
-   This program is distributed in the hope that it will be useful, but
-   WITHOUT ANY WARRANTY; without even the implied warranty of
-   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
-   General Public License for more details.
-
-   You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
-   USA.  */
+/* -*-c++-*-
+ * control - control instructions for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
 
 #ifndef INST_CONTROL_H
 #define INST_CONTROL_H 1
 
+#include <vm68k/processor>
+#include "addressing.h"
+
 #include <cassert>
 
 namespace vx68k_m68k
 {
-  namespace inst
+  /* Takes exception VECNO with PC as the return address, or throws it
+     if the context does not process exceptions.  */
+  inline vm68k_address_t raise_exception (vm68k_context *c,
+                                          uint_fast16_t vecno,
+                                          vm68k_address_t pc)
+  {
+    if (!c->exception_processing ())
+      {
+        throw vm68k_trap_exception (pc, vecno);
+      }
+    return c->take_exception (vecno, pc);
+  }
+
+  /**
+   * Handles a JMP instruction.  This instruction does not change CCR.
+   */
+  template<template<class> class S>
+  struct jmp_instruction
   {
-    /**
-     * Handles a JMP instruction.  This instruction does not change CCR.
-     */
-    template<template<class Size> class S>
-    address_t do_JMP (address_t pc, udata_fast16_t w, execution_context *c)
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
     {
       assert (c != NULL);
 
-      S<word_size> ea1 (w & 7, pc);
+      S<vm68k_word> ea1 (w & 7, pc);
 
-      address_t a = ea1.address (c);
+      return ea1.address (c);
+    }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &code, char *&p)
+    {
+      S<vm68k_word> ea1 (w & 7, pc);
+
+      p = write_string (p, "jmp ");
+      p = ea1.text (code, p);
+      return pc + S<vm68k_word>::extension_size ();
+    }
+
+    static vm68k_instruction::flow_type flow (vm68k_address_t pc,
+                                              uint_fast16_t w,
+                                              const vm68k_code_image &code,
+                                              vm68k_address_t &target)
+    {
+      S<vm68k_word> ea1 (w & 7, pc);
+
+      if (!ea1.static_address (code, target))
+        {
+          return vm68k_instruction::FLOW_INDIRECT;
+        }
+      return vm68k_instruction::FLOW_BRANCH;
+    }
+  };
+
+  /**
+   * Handles a JSR instruction.  This instruction does not change CCR.
+   */
+  template<template<class> class S>
+  struct jsr_instruction
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      assert (c != NULL);
+
+      S<vm68k_word> ea1 (w & 7, pc);
+
+      vm68k_address_t a = ea1.address (c);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
+      c->push (vm68k_data_size::LONG_WORD,
+               pc + S<vm68k_word>::extension_size ());
 
       return a;
     }
 
-    /**
-     * Handles a JSR instruction.  This instruction does not change CCR.
-     */
-    template<template<class Size> class S>
-    address_t do_JSR (address_t pc, udata_fast16_t w, execution_context *c)
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &code, char *&p)
+    {
+      S<vm68k_word> ea1 (w & 7, pc);
+
+      p = write_string (p, "jsr ");
+      p = ea1.text (code, p);
+      return pc + S<vm68k_word>::extension_size ();
+    }
+
+    static vm68k_instruction::flow_type flow (vm68k_address_t pc,
+                                              uint_fast16_t w,
+                                              const vm68k_code_image &code,
+                                              vm68k_address_t &target)
+    {
+      S<vm68k_word> ea1 (w & 7, pc);
+
+      if (!ea1.static_address (code, target))
+        {
+          return vm68k_instruction::FLOW_INDIRECT_CALL;
+        }
+      return vm68k_instruction::FLOW_CALL;
+    }
+  };
+
+  /**
+   * Handles a STOP instruction.  The run loop will wait for an
+   * interrupt without using the host processor.
+   */
+  struct stop_instruction
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t,
+                                    vm68k_context *c)
+    {
+      assert (c != NULL);
+
+      uint_fast16_t v = c->fetch_unsigned (vm68k_data_size::WORD, pc);
+      if (c->fault_pending ())
+        {
+          return pc;
+        }
+
+      // This instruction is privileged.
+      if (!c->super ())
+        {
+          throw privilege_violation_exception (pc);
+        }
+
+      c->set_status (v);
+      c->stop ();
+
+      return pc + vm68k_word::aligned_data_size ();
+    }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t,
+                                 const vm68k_code_image &code, char *&p)
+    {
+      p = write_string (p, "stop #");
+      p = write_hex (p, code.fetch_word (pc));
+      return pc + vm68k_word::aligned_data_size ();
+    }
+  };
+
+  /**
+   * Handles a TRAP instruction.  The exception is processed without
+   * leaving the run loop.
+   */
+  struct trap_instruction
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
     {
       assert (c != NULL);
 
-      S<word_size> ea1 (w & 7, pc);
+      return raise_exception (c, 32 + (w & 0xf), pc);
+    }
 
-      address_t a = ea1.address (c);
-      c->push (long_word, pc + S<word_size>::extension_size ());
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &, char *&p)
+    {
+      p = write_string (p, "trap #");
+      p = write_decimal (p, w & 0xf);
+      return pc;
+    }
+
+    static vm68k_instruction::flow_type flow (vm68k_address_t,
+                                              uint_fast16_t,
+                                              const vm68k_code_image &,
+                                              vm68k_address_t &)
+    {
+      // The handler usually returns to the next instruction.
+      return vm68k_instruction::FLOW_INDIRECT_CALL;
+    }
+  };
+
+  /**
+   * Handles a RTE instruction.
+   */
+  struct rte_instruction
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t,
+                                    vm68k_context *c)
+    {
+      assert (c != NULL);
+
+      // This instruction is privileged.
+      if (!c->super ())
+        {
+          throw privilege_violation_exception (pc);
+        }
+
+      // Both are popped from the supervisor stack before the status
+      // register may switch the stack.
+      uint_fast16_t status = c->pop_unsigned (vm68k_data_size::WORD);
+      vm68k_address_t a = c->pop_unsigned (vm68k_data_size::LONG_WORD);
+      if (c->fault_pending ())
+        {
+          return pc;
+        }
+      c->set_status (status);
 
       return a;
     }
-  }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t,
+                                 const vm68k_code_image &, char *&p)
+    {
+      p = write_string (p, "rte");
+      return pc;
+    }
+
+    static vm68k_instruction::flow_type flow (vm68k_address_t,
+                                              uint_fast16_t,
+                                              const vm68k_code_image &,
+                                              vm68k_address_t &)
+    {
+      return vm68k_instruction::FLOW_RETURN;
+    }
+  };
+
+  /**
+   * Handles an unimplemented instruction in line A or line F.
+   */
+  template<int Vecno>
+  struct unimplemented_instruction
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t,
+                                    vm68k_context *c)
+    {
+      assert (c != NULL);
+
+      // The exception returns to the instruction itself.
+      return raise_exception (c, Vecno, pc - 2);
+    }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &, char *&p)
+    {
+      p = write_string (p, ".short ");
+      p = write_hex (p, w);
+      return pc;
+    }
+
+    static vm68k_instruction::flow_type flow (vm68k_address_t,
+                                              uint_fast16_t,
+                                              const vm68k_code_image &,
+                                              vm68k_address_t &)
+    {
+      // Host calls and emulated systems usually go on to the next
+      // instruction after their work.
+      return vm68k_instruction::FLOW_INDIRECT_CALL;
+    }
+  };
 }
 
 #endif
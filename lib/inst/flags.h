@@ -0,0 +1,116 @@
+/* -*-c++-*-
+ * flags - flag policies for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INST_FLAGS_H
+#define INST_FLAGS_H 1
+
+#include <vm68k/context>
+
+namespace vx68k_m68k
+{
+  using namespace vx68k;
+  using vx68k::int_fast32_t;    // avoid ambiguity
+  using vx68k::uint_fast16_t;
+  using vx68k::uint_fast32_t;
+
+  /**
+   * Flag policy that sets every flag an instruction changes.  This is
+   * the default for instruction handlers.
+   */
+  struct all_flags
+  {
+    static void set_cc (vm68k_context *c, int_fast32_t r)
+    {
+      c->_status.set_cc (r);
+    }
+
+    static void set_cc_cmp (vm68k_context *c, int_fast32_t r,
+                            int_fast32_t d, int_fast32_t s)
+    {
+      c->_status.set_cc_cmp (r, d, s);
+    }
+
+    static void set_cc_as_add (vm68k_context *c, int_fast32_t r,
+                               int_fast32_t d, int_fast32_t s)
+    {
+      c->_status.set_cc_as_add (r, d, s);
+    }
+
+    static void set_cc_sub (vm68k_context *c, int_fast32_t r,
+                            int_fast32_t d, int_fast32_t s)
+    {
+      c->_status.set_cc_sub (r, d, s);
+    }
+  };
+
+  /**
+   * Flag policy for an instruction whose condition codes are
+   * overwritten before they are read but whose X flag is not.
+   */
+  struct x_flag_only
+  {
+    static void set_cc (vm68k_context *, int_fast32_t)
+    {
+    }
+
+    static void set_cc_cmp (vm68k_context *, int_fast32_t, int_fast32_t,
+                            int_fast32_t)
+    {
+    }
+
+    static void set_cc_as_add (vm68k_context *c, int_fast32_t r,
+                               int_fast32_t d, int_fast32_t s)
+    {
+      c->_status.set_x_as_add (r, d, s);
+    }
+
+    static void set_cc_sub (vm68k_context *c, int_fast32_t r,
+                            int_fast32_t d, int_fast32_t s)
+    {
+      c->_status.set_x_sub (r, d, s);
+    }
+  };
+
+  /**
+   * Flag policy for an instruction whose flags are all overwritten
+   * before they are read.
+   */
+  struct no_flags
+  {
+    static void set_cc (vm68k_context *, int_fast32_t)
+    {
+    }
+
+    static void set_cc_cmp (vm68k_context *, int_fast32_t, int_fast32_t,
+                            int_fast32_t)
+    {
+    }
+
+    static void set_cc_as_add (vm68k_context *, int_fast32_t, int_fast32_t,
+                               int_fast32_t)
+    {
+    }
+
+    static void set_cc_sub (vm68k_context *, int_fast32_t, int_fast32_t,
+                            int_fast32_t)
+    {
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,733 @@
+/* fused - fused instruction pairs for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/processor>
+
+#include "arith.h"
+#include "transfer.h"
+#include "fused.h"
+
+#include <cassert>
+
+using namespace vx68k;
+using namespace vx68k_m68k;
+
+namespace
+{
+  typedef vm68k_byte B;
+  typedef vm68k_word W;
+  typedef vm68k_long_word L;
+
+  /* MOVE to Dn whose flags are overwritten by the next instruction.  */
+  template<class Size, template<class> class S>
+  struct dead_move
+    : dead_flags_pair<move_instruction<Size, S, d_reg_direct>,
+                      move_instruction<Size, S, d_reg_direct, no_flags> >
+  {
+  };
+
+  /* ADDQ to Dn whose flags are overwritten by the next instruction.  */
+  template<class Size>
+  struct dead_addq
+    : dead_flags_pair<addq_instruction<Size, d_reg_direct>,
+                      addq_instruction<Size, d_reg_direct, x_flag_only>,
+                      addq_instruction<Size, d_reg_direct, no_flags> >
+  {
+  };
+
+  /* SUBQ to Dn whose flags are overwritten by the next instruction.  */
+  template<class Size>
+  struct dead_subq
+    : dead_flags_pair<subq_instruction<Size, d_reg_direct>,
+                      subq_instruction<Size, d_reg_direct, x_flag_only>,
+                      subq_instruction<Size, d_reg_direct, no_flags> >
+  {
+  };
+}
+
+namespace vx68k
+{
+  const vm68k_instruction_decoder::fused_spec
+  vm68k_instruction_decoder::fused[] =
+    {
+      { 0x0c00,     7,
+        cmpi_instruction<B, d_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmpi_instruction<B, d_reg_direct> >::execute },
+      { 0x0c10,     7,
+        cmpi_instruction<B, indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmpi_instruction<B, indirect> >::execute },
+      { 0x0c18,     7,
+        cmpi_instruction<B, postinc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmpi_instruction<B, postinc_indirect> >::execute },
+      { 0x0c20,     7,
+        cmpi_instruction<B, predec_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmpi_instruction<B, predec_indirect> >::execute },
+      { 0x0c28,     7,
+        cmpi_instruction<B, disp_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmpi_instruction<B, disp_indirect> >::execute },
+      { 0x0c30,     7,
+        cmpi_instruction<B, index_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmpi_instruction<B, index_indirect> >::execute },
+      { 0x0c38,     0,
+        cmpi_instruction<B, abs_short>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmpi_instruction<B, abs_short> >::execute },
+      { 0x0c39,     0,
+        cmpi_instruction<B, abs_long>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmpi_instruction<B, abs_long> >::execute },
+      { 0x0c40,     7,
+        cmpi_instruction<W, d_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmpi_instruction<W, d_reg_direct> >::execute },
+      { 0x0c50,     7,
+        cmpi_instruction<W, indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmpi_instruction<W, indirect> >::execute },
+      { 0x0c58,     7,
+        cmpi_instruction<W, postinc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmpi_instruction<W, postinc_indirect> >::execute },
+      { 0x0c60,     7,
+        cmpi_instruction<W, predec_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmpi_instruction<W, predec_indirect> >::execute },
+      { 0x0c68,     7,
+        cmpi_instruction<W, disp_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmpi_instruction<W, disp_indirect> >::execute },
+      { 0x0c70,     7,
+        cmpi_instruction<W, index_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmpi_instruction<W, index_indirect> >::execute },
+      { 0x0c78,     0,
+        cmpi_instruction<W, abs_short>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmpi_instruction<W, abs_short> >::execute },
+      { 0x0c79,     0,
+        cmpi_instruction<W, abs_long>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmpi_instruction<W, abs_long> >::execute },
+      { 0x0c80,     7,
+        cmpi_instruction<L, d_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmpi_instruction<L, d_reg_direct> >::execute },
+      { 0x0c90,     7,
+        cmpi_instruction<L, indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmpi_instruction<L, indirect> >::execute },
+      { 0x0c98,     7,
+        cmpi_instruction<L, postinc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmpi_instruction<L, postinc_indirect> >::execute },
+      { 0x0ca0,     7,
+        cmpi_instruction<L, predec_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmpi_instruction<L, predec_indirect> >::execute },
+      { 0x0ca8,     7,
+        cmpi_instruction<L, disp_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmpi_instruction<L, disp_indirect> >::execute },
+      { 0x0cb0,     7,
+        cmpi_instruction<L, index_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmpi_instruction<L, index_indirect> >::execute },
+      { 0x0cb8,     0,
+        cmpi_instruction<L, abs_short>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmpi_instruction<L, abs_short> >::execute },
+      { 0x0cb9,     0,
+        cmpi_instruction<L, abs_long>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmpi_instruction<L, abs_long> >::execute },
+      { 0x1000, 0xe07,
+        move_instruction<B, d_reg_direct, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<B, d_reg_direct>::execute },
+      { 0x1000, 0xe07,
+        move_instruction<B, d_reg_direct, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<B, d_reg_direct>::execute },
+      { 0x1000, 0xe07,
+        move_instruction<B, d_reg_direct, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<B, d_reg_direct>::execute },
+      { 0x1010, 0xe07,
+        move_instruction<B, indirect, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<B, indirect>::execute },
+      { 0x1010, 0xe07,
+        move_instruction<B, indirect, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<B, indirect>::execute },
+      { 0x1010, 0xe07,
+        move_instruction<B, indirect, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<B, indirect>::execute },
+      { 0x1018, 0xe07,
+        move_instruction<B, postinc_indirect, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<B, postinc_indirect>::execute },
+      { 0x1018, 0xe07,
+        move_instruction<B, postinc_indirect, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<B, postinc_indirect>::execute },
+      { 0x1018, 0xe07,
+        move_instruction<B, postinc_indirect, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<B, postinc_indirect>::execute },
+      { 0x1020, 0xe07,
+        move_instruction<B, predec_indirect, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<B, predec_indirect>::execute },
+      { 0x1020, 0xe07,
+        move_instruction<B, predec_indirect, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<B, predec_indirect>::execute },
+      { 0x1020, 0xe07,
+        move_instruction<B, predec_indirect, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<B, predec_indirect>::execute },
+      { 0x10c0, 0xe07,
+        move_instruction<B, d_reg_direct, postinc_indirect>::execute,
+        0x50c8, 0x0f07,
+        loop_pair<move_instruction<B, d_reg_direct, postinc_indirect>,
+                  bulk_fill<B> >::execute },
+      { 0x10d8, 0xe07,
+        move_instruction<B, postinc_indirect, postinc_indirect>::execute,
+        0x50c8, 0x0f07,
+        loop_pair<move_instruction<B, postinc_indirect, postinc_indirect>,
+                  bulk_copy<B> >::execute },
+      { 0x2000, 0xe07,
+        move_instruction<L, d_reg_direct, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<L, d_reg_direct>::execute },
+      { 0x2000, 0xe07,
+        move_instruction<L, d_reg_direct, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<L, d_reg_direct>::execute },
+      { 0x2000, 0xe07,
+        move_instruction<L, d_reg_direct, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<L, d_reg_direct>::execute },
+      { 0x2008, 0xe07,
+        move_instruction<L, a_reg_direct, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<L, a_reg_direct>::execute },
+      { 0x2008, 0xe07,
+        move_instruction<L, a_reg_direct, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<L, a_reg_direct>::execute },
+      { 0x2008, 0xe07,
+        move_instruction<L, a_reg_direct, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<L, a_reg_direct>::execute },
+      { 0x2010, 0xe07,
+        move_instruction<L, indirect, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<L, indirect>::execute },
+      { 0x2010, 0xe07,
+        move_instruction<L, indirect, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<L, indirect>::execute },
+      { 0x2010, 0xe07,
+        move_instruction<L, indirect, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<L, indirect>::execute },
+      { 0x2018, 0xe07,
+        move_instruction<L, postinc_indirect, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<L, postinc_indirect>::execute },
+      { 0x2018, 0xe07,
+        move_instruction<L, postinc_indirect, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<L, postinc_indirect>::execute },
+      { 0x2018, 0xe07,
+        move_instruction<L, postinc_indirect, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<L, postinc_indirect>::execute },
+      { 0x2020, 0xe07,
+        move_instruction<L, predec_indirect, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<L, predec_indirect>::execute },
+      { 0x2020, 0xe07,
+        move_instruction<L, predec_indirect, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<L, predec_indirect>::execute },
+      { 0x2020, 0xe07,
+        move_instruction<L, predec_indirect, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<L, predec_indirect>::execute },
+      { 0x20c0, 0xe07,
+        move_instruction<L, d_reg_direct, postinc_indirect>::execute,
+        0x50c8, 0x0f07,
+        loop_pair<move_instruction<L, d_reg_direct, postinc_indirect>,
+                  bulk_fill<L> >::execute },
+      { 0x20d8, 0xe07,
+        move_instruction<L, postinc_indirect, postinc_indirect>::execute,
+        0x50c8, 0x0f07,
+        loop_pair<move_instruction<L, postinc_indirect, postinc_indirect>,
+                  bulk_copy<L> >::execute },
+      { 0x3000, 0xe07,
+        move_instruction<W, d_reg_direct, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<W, d_reg_direct>::execute },
+      { 0x3000, 0xe07,
+        move_instruction<W, d_reg_direct, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<W, d_reg_direct>::execute },
+      { 0x3000, 0xe07,
+        move_instruction<W, d_reg_direct, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<W, d_reg_direct>::execute },
+      { 0x3008, 0xe07,
+        move_instruction<W, a_reg_direct, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<W, a_reg_direct>::execute },
+      { 0x3008, 0xe07,
+        move_instruction<W, a_reg_direct, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<W, a_reg_direct>::execute },
+      { 0x3008, 0xe07,
+        move_instruction<W, a_reg_direct, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<W, a_reg_direct>::execute },
+      { 0x3010, 0xe07,
+        move_instruction<W, indirect, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<W, indirect>::execute },
+      { 0x3010, 0xe07,
+        move_instruction<W, indirect, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<W, indirect>::execute },
+      { 0x3010, 0xe07,
+        move_instruction<W, indirect, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<W, indirect>::execute },
+      { 0x3018, 0xe07,
+        move_instruction<W, postinc_indirect, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<W, postinc_indirect>::execute },
+      { 0x3018, 0xe07,
+        move_instruction<W, postinc_indirect, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<W, postinc_indirect>::execute },
+      { 0x3018, 0xe07,
+        move_instruction<W, postinc_indirect, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<W, postinc_indirect>::execute },
+      { 0x3020, 0xe07,
+        move_instruction<W, predec_indirect, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_move<W, predec_indirect>::execute },
+      { 0x3020, 0xe07,
+        move_instruction<W, predec_indirect, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_move<W, predec_indirect>::execute },
+      { 0x3020, 0xe07,
+        move_instruction<W, predec_indirect, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_move<W, predec_indirect>::execute },
+      { 0x30c0, 0xe07,
+        move_instruction<W, d_reg_direct, postinc_indirect>::execute,
+        0x50c8, 0x0f07,
+        loop_pair<move_instruction<W, d_reg_direct, postinc_indirect>,
+                  bulk_fill<W> >::execute },
+      { 0x30d8, 0xe07,
+        move_instruction<W, postinc_indirect, postinc_indirect>::execute,
+        0x50c8, 0x0f07,
+        loop_pair<move_instruction<W, postinc_indirect, postinc_indirect>,
+                  bulk_copy<W> >::execute },
+      { 0x4a00,     7,
+        tst_instruction<B, d_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, tst_instruction<B, d_reg_direct> >::execute },
+      { 0x4a10,     7,
+        tst_instruction<B, indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, tst_instruction<B, indirect> >::execute },
+      { 0x4a18,     7,
+        tst_instruction<B, postinc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, tst_instruction<B, postinc_indirect> >::execute },
+      { 0x4a20,     7,
+        tst_instruction<B, predec_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, tst_instruction<B, predec_indirect> >::execute },
+      { 0x4a28,     7,
+        tst_instruction<B, disp_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, tst_instruction<B, disp_indirect> >::execute },
+      { 0x4a30,     7,
+        tst_instruction<B, index_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, tst_instruction<B, index_indirect> >::execute },
+      { 0x4a38,     0,
+        tst_instruction<B, abs_short>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, tst_instruction<B, abs_short> >::execute },
+      { 0x4a39,     0,
+        tst_instruction<B, abs_long>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, tst_instruction<B, abs_long> >::execute },
+      { 0x4a40,     7,
+        tst_instruction<W, d_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, tst_instruction<W, d_reg_direct> >::execute },
+      { 0x4a50,     7,
+        tst_instruction<W, indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, tst_instruction<W, indirect> >::execute },
+      { 0x4a58,     7,
+        tst_instruction<W, postinc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, tst_instruction<W, postinc_indirect> >::execute },
+      { 0x4a60,     7,
+        tst_instruction<W, predec_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, tst_instruction<W, predec_indirect> >::execute },
+      { 0x4a68,     7,
+        tst_instruction<W, disp_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, tst_instruction<W, disp_indirect> >::execute },
+      { 0x4a70,     7,
+        tst_instruction<W, index_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, tst_instruction<W, index_indirect> >::execute },
+      { 0x4a78,     0,
+        tst_instruction<W, abs_short>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, tst_instruction<W, abs_short> >::execute },
+      { 0x4a79,     0,
+        tst_instruction<W, abs_long>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, tst_instruction<W, abs_long> >::execute },
+      { 0x4a80,     7,
+        tst_instruction<L, d_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, tst_instruction<L, d_reg_direct> >::execute },
+      { 0x4a90,     7,
+        tst_instruction<L, indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, tst_instruction<L, indirect> >::execute },
+      { 0x4a98,     7,
+        tst_instruction<L, postinc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, tst_instruction<L, postinc_indirect> >::execute },
+      { 0x4aa0,     7,
+        tst_instruction<L, predec_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, tst_instruction<L, predec_indirect> >::execute },
+      { 0x4aa8,     7,
+        tst_instruction<L, disp_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, tst_instruction<L, disp_indirect> >::execute },
+      { 0x4ab0,     7,
+        tst_instruction<L, index_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, tst_instruction<L, index_indirect> >::execute },
+      { 0x4ab8,     0,
+        tst_instruction<L, abs_short>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, tst_instruction<L, abs_short> >::execute },
+      { 0x4ab9,     0,
+        tst_instruction<L, abs_long>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, tst_instruction<L, abs_long> >::execute },
+      { 0x5000, 0xe07,
+        addq_instruction<B, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_addq<B>::execute },
+      { 0x5000, 0xe07,
+        addq_instruction<B, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_addq<B>::execute },
+      { 0x5000, 0xe07,
+        addq_instruction<B, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_addq<B>::execute },
+      { 0x5040, 0xe07,
+        addq_instruction<W, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_addq<W>::execute },
+      { 0x5040, 0xe07,
+        addq_instruction<W, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_addq<W>::execute },
+      { 0x5040, 0xe07,
+        addq_instruction<W, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_addq<W>::execute },
+      { 0x5080, 0xe07,
+        addq_instruction<L, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_addq<L>::execute },
+      { 0x5080, 0xe07,
+        addq_instruction<L, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_addq<L>::execute },
+      { 0x5080, 0xe07,
+        addq_instruction<L, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_addq<L>::execute },
+      { 0x5100, 0xe07,
+        subq_instruction<B, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_subq<B>::execute },
+      { 0x5100, 0xe07,
+        subq_instruction<B, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_subq<B>::execute },
+      { 0x5100, 0xe07,
+        subq_instruction<B, d_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, subq_instruction<B, d_reg_direct> >::execute },
+      { 0x5100, 0xe07,
+        subq_instruction<B, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_subq<B>::execute },
+      { 0x5140, 0xe07,
+        subq_instruction<W, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_subq<W>::execute },
+      { 0x5140, 0xe07,
+        subq_instruction<W, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_subq<W>::execute },
+      { 0x5140, 0xe07,
+        subq_instruction<W, d_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, subq_instruction<W, d_reg_direct> >::execute },
+      { 0x5140, 0xe07,
+        subq_instruction<W, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_subq<W>::execute },
+      { 0x5180, 0xe07,
+        subq_instruction<L, d_reg_direct>::execute,
+        0x4a00, 0x00c7,
+        dead_subq<L>::execute },
+      { 0x5180, 0xe07,
+        subq_instruction<L, d_reg_direct>::execute,
+        0x5000, 0x0fc7,
+        dead_subq<L>::execute },
+      { 0x5180, 0xe07,
+        subq_instruction<L, d_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, subq_instruction<L, d_reg_direct> >::execute },
+      { 0x5180, 0xe07,
+        subq_instruction<L, d_reg_direct>::execute,
+        0xb000, 0x0ec7,
+        dead_subq<L>::execute },
+      { 0xb000, 0xe07,
+        cmp_instruction<B, d_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmp_instruction<B, d_reg_direct> >::execute },
+      { 0xb010, 0xe07,
+        cmp_instruction<B, indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmp_instruction<B, indirect> >::execute },
+      { 0xb018, 0xe07,
+        cmp_instruction<B, postinc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmp_instruction<B, postinc_indirect> >::execute },
+      { 0xb020, 0xe07,
+        cmp_instruction<B, predec_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmp_instruction<B, predec_indirect> >::execute },
+      { 0xb028, 0xe07,
+        cmp_instruction<B, disp_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmp_instruction<B, disp_indirect> >::execute },
+      { 0xb030, 0xe07,
+        cmp_instruction<B, index_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmp_instruction<B, index_indirect> >::execute },
+      { 0xb038, 0xe00,
+        cmp_instruction<B, abs_short>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmp_instruction<B, abs_short> >::execute },
+      { 0xb039, 0xe00,
+        cmp_instruction<B, abs_long>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmp_instruction<B, abs_long> >::execute },
+      { 0xb03a, 0xe00,
+        cmp_instruction<B, disp_pc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmp_instruction<B, disp_pc_indirect> >::execute },
+      { 0xb03b, 0xe00,
+        cmp_instruction<B, index_pc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmp_instruction<B, index_pc_indirect> >::execute },
+      { 0xb03c, 0xe00,
+        cmp_instruction<B, immediate>::execute,
+        0x6000, 0x0fff,
+        branch_pair<B, cmp_instruction<B, immediate> >::execute },
+      { 0xb040, 0xe07,
+        cmp_instruction<W, d_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmp_instruction<W, d_reg_direct> >::execute },
+      { 0xb048, 0xe07,
+        cmp_instruction<W, a_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmp_instruction<W, a_reg_direct> >::execute },
+      { 0xb050, 0xe07,
+        cmp_instruction<W, indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmp_instruction<W, indirect> >::execute },
+      { 0xb058, 0xe07,
+        cmp_instruction<W, postinc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmp_instruction<W, postinc_indirect> >::execute },
+      { 0xb060, 0xe07,
+        cmp_instruction<W, predec_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmp_instruction<W, predec_indirect> >::execute },
+      { 0xb068, 0xe07,
+        cmp_instruction<W, disp_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmp_instruction<W, disp_indirect> >::execute },
+      { 0xb070, 0xe07,
+        cmp_instruction<W, index_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmp_instruction<W, index_indirect> >::execute },
+      { 0xb078, 0xe00,
+        cmp_instruction<W, abs_short>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmp_instruction<W, abs_short> >::execute },
+      { 0xb079, 0xe00,
+        cmp_instruction<W, abs_long>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmp_instruction<W, abs_long> >::execute },
+      { 0xb07a, 0xe00,
+        cmp_instruction<W, disp_pc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmp_instruction<W, disp_pc_indirect> >::execute },
+      { 0xb07b, 0xe00,
+        cmp_instruction<W, index_pc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmp_instruction<W, index_pc_indirect> >::execute },
+      { 0xb07c, 0xe00,
+        cmp_instruction<W, immediate>::execute,
+        0x6000, 0x0fff,
+        branch_pair<W, cmp_instruction<W, immediate> >::execute },
+      { 0xb080, 0xe07,
+        cmp_instruction<L, d_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmp_instruction<L, d_reg_direct> >::execute },
+      { 0xb088, 0xe07,
+        cmp_instruction<L, a_reg_direct>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmp_instruction<L, a_reg_direct> >::execute },
+      { 0xb090, 0xe07,
+        cmp_instruction<L, indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmp_instruction<L, indirect> >::execute },
+      { 0xb098, 0xe07,
+        cmp_instruction<L, postinc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmp_instruction<L, postinc_indirect> >::execute },
+      { 0xb0a0, 0xe07,
+        cmp_instruction<L, predec_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmp_instruction<L, predec_indirect> >::execute },
+      { 0xb0a8, 0xe07,
+        cmp_instruction<L, disp_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmp_instruction<L, disp_indirect> >::execute },
+      { 0xb0b0, 0xe07,
+        cmp_instruction<L, index_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmp_instruction<L, index_indirect> >::execute },
+      { 0xb0b8, 0xe00,
+        cmp_instruction<L, abs_short>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmp_instruction<L, abs_short> >::execute },
+      { 0xb0b9, 0xe00,
+        cmp_instruction<L, abs_long>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmp_instruction<L, abs_long> >::execute },
+      { 0xb0ba, 0xe00,
+        cmp_instruction<L, disp_pc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmp_instruction<L, disp_pc_indirect> >::execute },
+      { 0xb0bb, 0xe00,
+        cmp_instruction<L, index_pc_indirect>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmp_instruction<L, index_pc_indirect> >::execute },
+      { 0xb0bc, 0xe00,
+        cmp_instruction<L, immediate>::execute,
+        0x6000, 0x0fff,
+        branch_pair<L, cmp_instruction<L, immediate> >::execute },
+    };
+
+  const std::size_t vm68k_instruction_decoder::fused_size =
+    sizeof fused / sizeof fused[0];
+
+  bool vm68k_instruction_decoder::fuse_pair (uint_fast16_t w1,
+                                             uint_fast16_t w2)
+  {
+    if (_unfused.find (w1) != _unfused.end ())
+      {
+        return false;
+      }
+
+    // A specialized handler is fused as the generic one it replaced.
+    vm68k_instruction original = _instruction[w1];
+    vm68k_instruction generic = original;
+    std::map<uint_least16_t, vm68k_instruction>::const_iterator k =
+      _specialized.find (w1);
+    if (k != _specialized.end ())
+      {
+        generic = k->second;
+      }
+
+    for (std::size_t i = 0; i != fused_size; ++i)
+      {
+        const fused_spec &s = fused[i];
+        if ((w1 & ~s.mask) == s.code && (w2 & ~s.next_mask) == s.next_code
+            && generic == vm68k_instruction (s.first))
+          {
+            _unfused.insert (std::make_pair (w1, original));
+            this->store (w1, vm68k_instruction (s.func));
+            return true;
+          }
+      }
+    return false;
+  }
+}
@@ -0,0 +1,426 @@
+/* -*-c++-*-
+ * fused - fused instruction pairs for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INST_FUSED_H
+#define INST_FUSED_H 1
+
+#include <vm68k/processor>
+#include "arith.h"
+#include "branch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace vx68k_m68k
+{
+  using vx68k::uint_fast16_t;   // avoid ambiguity
+  using vx68k::uint_fast32_t;
+
+  /* Returns true if the instruction at the address after a fused
+     handler may be executed in the same dispatch.  */
+  inline bool fusible (const vm68k_context *c)
+  {
+    return c->fusible () && c->pending () == 0;
+  }
+
+  /* Fetches the operation word at ADDR to W2 for fusion.  Returns false
+     if the fetch faulted; the deferred fault is dropped so that it is
+     taken at that instruction when it runs by itself.  */
+  inline bool fetch_fused (vm68k_context *c, vm68k_address_t addr,
+                           uint_fast16_t &w2)
+  {
+    w2 = c->fetch_unsigned (vm68k_data_size::WORD, addr);
+    if (c->fault_pending ())
+      {
+        c->faulted ();
+        return false;
+      }
+    return true;
+  }
+
+  /**
+   * Handles an instruction that compares, followed by a Bcc
+   * instruction.  The branch is decided from the compared values
+   * without evaluating the status register.  First must have a
+   * compare function, and the status register is still set as it
+   * would be by First.
+   */
+  template<class Size, class First>
+  struct branch_pair
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      assert (c != NULL);
+
+      // The values are left unset if the compare faults.
+      typename Size::udata_type v1 = 0, v2 = 0;
+      vm68k_address_t next = First::compare (pc, w, c, v1, v2);
+      if (!fusible (c))
+        {
+          return next;
+        }
+
+      // Any other operation word is left to the dispatcher.
+      uint_fast16_t w2;
+      if (!fetch_fused (c, next, w2)
+          || (w2 & 0xf000U) != 0x6000U || (w2 & 0x0f00U) == 0x0100U)
+        {
+          return next;
+        }
+
+      return branch (next + 2, w2, c,
+                     compare_condition<Size> (w2 >> 8 & 0xf, v1, v2));
+    }
+  };
+
+  /* Returns the value of size Size at host pointer P.  */
+  template<class Size>
+  inline typename Size::udata_type direct_value (const unsigned char *p)
+  {
+    typename Size::udata_type value = 0;
+    for (uint_fast16_t i = 0; i != Size::data_size (); ++i)
+      {
+        value = value << 8 | p[i];
+      }
+    return value;
+  }
+
+  /* Returns the number of elements of size Size that fit in the pages
+     of both addresses A1 and A2.  */
+  template<class Size>
+  inline uint_fast32_t direct_room (vm68k_address_t a1, vm68k_address_t a2)
+  {
+    std::size_t room1 = PAGE_SIZE - (a1 & (PAGE_SIZE - 1));
+    std::size_t room2 = PAGE_SIZE - (a2 & (PAGE_SIZE - 1));
+    return std::min (room1, room2) / Size::data_size ();
+  }
+
+  /**
+   * Runs MOVE (Ay)+,(Ax)+ in bulk.
+   */
+  template<class Size>
+  struct bulk_copy
+  {
+    /* Makes at most N moves of the loop of operation words W and W2
+       at once and returns the number of moves made.  Only the pages
+       that can be accessed directly are copied, and the copy stops
+       where a forward copy would read what it wrote.  The registers
+       and flags are left as the moves would leave them, except for
+       the loop counter.  */
+    static uint_fast32_t run (vm68k_context *c, uint_fast16_t w,
+                              uint_fast16_t, uint_fast32_t n)
+    {
+      int r1 = vm68k_context::A0 + (w & 7);
+      int r2 = vm68k_context::A0 + (w >> 9 & 7);
+      if (r1 == r2 || (Size::data_size () == 1
+                       && (r1 == vm68k_context::SP
+                           || r2 == vm68k_context::SP)))
+        {
+          // The stack pointer steps by two for bytes.
+          return 0;
+        }
+
+      vm68k_bus *bus = c->bus ();
+      vm68k_bus::function_code func = c->data_function_code ();
+      uint_fast32_t s = c->read_reg_unsigned (vm68k_data_size::LONG_WORD,
+                                              r1);
+      uint_fast32_t d = c->read_reg_unsigned (vm68k_data_size::LONG_WORD,
+                                              r2);
+      if (Size::data_size () != 1 && ((s | d) & 1) != 0)
+        {
+          // Left to the moves for address errors.
+          return 0;
+        }
+
+      uint_fast32_t done = 0;
+      typename Size::udata_type last = 0;
+      while (done != n)
+        {
+          uint_fast32_t k = std::min (n - done, direct_room<Size> (s, d));
+          uint_fast32_t bytes = k * Size::data_size ();
+          if (k == 0 || (d > s && d - s < bytes))
+            {
+              break;
+            }
+
+          unsigned char *p1 = bus->direct (func, s);
+          unsigned char *p2 = bus->direct (func, d);
+          if (p1 == NULL || p2 == NULL)
+            {
+              break;
+            }
+
+          std::memmove (p2, p1, bytes);
+          last = direct_value<Size> (p2 + bytes - Size::data_size ());
+          s += bytes;
+          d += bytes;
+          done += k;
+        }
+
+      if (done != 0)
+        {
+          c->write_reg (vm68k_data_size::LONG_WORD, r1, s);
+          c->write_reg (vm68k_data_size::LONG_WORD, r2, d);
+          c->_status.set_cc (Size::as_signed (last));
+        }
+      return done;
+    }
+  };
+
+  /**
+   * Runs MOVE Dy,(Ax)+ in bulk.
+   */
+  template<class Size>
+  struct bulk_fill
+  {
+    /* Makes at most N moves of the loop of operation words W and W2
+       at once and returns the number of moves made.  Only the pages
+       that can be accessed directly are filled.  */
+    static uint_fast32_t run (vm68k_context *c, uint_fast16_t w,
+                              uint_fast16_t w2, uint_fast32_t n)
+    {
+      // The value would change as the counter.
+      int r2 = vm68k_context::A0 + (w >> 9 & 7);
+      if ((w & 7) == (w2 & 7)
+          || (Size::data_size () == 1 && r2 == vm68k_context::SP))
+        {
+          return 0;
+        }
+
+      vm68k_bus *bus = c->bus ();
+      vm68k_bus::function_code func = c->data_function_code ();
+      typename Size::udata_type value =
+        c->read_reg_unsigned (Size (), vm68k_context::D0 + (w & 7));
+      uint_fast32_t d = c->read_reg_unsigned (vm68k_data_size::LONG_WORD,
+                                              r2);
+      if (Size::data_size () != 1 && (d & 1) != 0)
+        {
+          return 0;
+        }
+
+      unsigned char bytes[4];
+      for (uint_fast16_t i = 0; i != Size::data_size (); ++i)
+        {
+          bytes[i] = value >> 8 * (Size::data_size () - 1 - i) & 0xffU;
+        }
+
+      uint_fast32_t done = 0;
+      while (done != n)
+        {
+          uint_fast32_t k = std::min (n - done, direct_room<Size> (d, d));
+          unsigned char *p = bus->direct (func, d);
+          if (k == 0 || p == NULL)
+            {
+              break;
+            }
+
+          if (Size::data_size () == 1)
+            {
+              std::memset (p, bytes[0], k);
+            }
+          else
+            {
+              for (uint_fast32_t i = 0; i != k; ++i)
+                {
+                  std::memcpy (p + i * Size::data_size (), bytes,
+                               Size::data_size ());
+                }
+            }
+          d += k * Size::data_size ();
+          done += k;
+        }
+
+      if (done != 0)
+        {
+          c->write_reg (vm68k_data_size::LONG_WORD, r2, d);
+        }
+      return done;
+    }
+  };
+
+  /**
+   * Handles an instruction followed by a DBcc instruction, such as
+   * the body of a copy or fill loop.  If the DBcc instruction is DBF
+   * and branches back to First, the remaining iterations are passed
+   * to Bulk, and the loop is finished at once if Bulk makes them all.
+   * Iterations in bulk do not check for interrupts.
+   */
+  template<class First, class Bulk>
+  struct loop_pair
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      assert (c != NULL);
+
+      vm68k_address_t next = First::execute (pc, w, c);
+      if (!fusible (c))
+        {
+          return next;
+        }
+
+      uint_fast16_t w2;
+      if (!fetch_fused (c, next, w2) || (w2 & 0xf0f8U) != 0x50c8U)
+        {
+          return next;
+        }
+
+      int cc = w2 >> 8 & 0xf;
+      vm68k_address_t loop =
+        decrement_branch (next + 2, w2, c,
+                          cc != CC_F && test_condition (c, cc));
+      if (cc != CC_F || loop != pc - 2)
+        {
+          return loop;
+        }
+
+      int r = vm68k_context::D0 + (w2 & 7);
+      uint_fast32_t n = c->read_reg_unsigned (vm68k_data_size::WORD, r) + 1;
+      uint_fast32_t done = Bulk::run (c, w, w2, n);
+      if (done == 0)
+        {
+          return loop;
+        }
+
+      c->write_reg (vm68k_data_size::WORD, r, n - done - 1);
+      if (done != n)
+        {
+          return loop;
+        }
+      return next + 2 + vm68k_word::aligned_data_size ();
+    }
+  };
+
+  /* Flags an instruction overwrites without reading them.  */
+  enum
+  {
+    FLAGS_NONE,
+    FLAGS_CC,
+    FLAGS_CC_X
+  };
+
+  /* Returns the flags that operation word W overwrites if it is TST
+     Dn, CMP Dm,Dn, ADDQ or SUBQ to Dn, or FLAGS_NONE.  */
+  inline int overwritten_flags (uint_fast16_t w)
+  {
+    if ((w >> 6 & 3) == 3)
+      {
+        return FLAGS_NONE;
+      }
+    if ((w & 0xff38U) == 0x4a00U)
+      {
+        return FLAGS_CC;
+      }
+    if ((w & 0xf138U) == 0xb000U)
+      {
+        return FLAGS_CC;
+      }
+    if ((w & 0xf038U) == 0x5000U)
+      {
+        return FLAGS_CC_X;
+      }
+    return FLAGS_NONE;
+  }
+
+  /* Executes operation word W of size Size for which
+     overwritten_flags does not return FLAGS_NONE.  */
+  template<class Size>
+  inline vm68k_address_t execute_overwriting (vm68k_address_t pc,
+                                              uint_fast16_t w,
+                                              vm68k_context *c)
+  {
+    switch (w >> 12)
+      {
+      case 0x4:
+        return tst_instruction<Size, d_reg_direct>::execute (pc, w, c);
+      case 0xb:
+        return cmp_instruction<Size, d_reg_direct>::execute (pc, w, c);
+      default:
+        if ((w & 0x100U) != 0)
+          {
+            return subq_instruction<Size, d_reg_direct>::execute (pc, w, c);
+          }
+        return addq_instruction<Size, d_reg_direct>::execute (pc, w, c);
+      }
+  }
+
+  /* Same as above but for any size.  */
+  inline vm68k_address_t execute_overwriting (vm68k_address_t pc,
+                                              uint_fast16_t w,
+                                              vm68k_context *c)
+  {
+    switch (w >> 6 & 3)
+      {
+      case 0:
+        return execute_overwriting<vm68k_byte> (pc, w, c);
+      case 1:
+        return execute_overwriting<vm68k_word> (pc, w, c);
+      default:
+        return execute_overwriting<vm68k_long_word> (pc, w, c);
+      }
+  }
+
+  /**
+   * Handles an instruction whose flags the next instruction
+   * overwrites.  FirstX is the variant of First that sets only the X
+   * flag, and FirstNone the one that sets no flags.  First must have
+   * no extension words, as the next operation word is read before it
+   * is executed.
+   */
+  template<class First, class FirstX, class FirstNone = FirstX>
+  struct dead_flags_pair
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
+                                    vm68k_context *c)
+    {
+      assert (c != NULL);
+
+      uint_fast16_t w2;
+      if (!fusible (c) || !fetch_fused (c, pc, w2))
+        {
+          return First::execute (pc, w, c);
+        }
+
+      vm68k_address_t next;
+      switch (overwritten_flags (w2))
+        {
+        case FLAGS_CC:
+          next = FirstX::execute (pc, w, c);
+          break;
+        case FLAGS_CC_X:
+          next = FirstNone::execute (pc, w, c);
+          break;
+        default:
+          return First::execute (pc, w, c);
+        }
+
+      // A fault leaves the flags undefined.  Any other pending state,
+      // such as an interrupt posted meanwhile, must wait for the next
+      // instruction to set the flags that First left out.
+      if (c->fault_pending ())
+        {
+          return next;
+        }
+      return execute_overwriting (next + 2, w2, c);
+    }
+  };
+}
+
+#endif
@@ -32,6 +32,7 @@
 #endif
 
 #include <vm68k/processor>
+#include <vm68k/disasm>
 
 #include "transfer.h"
 
@@ -42,98 +43,98 @@ using namespace vx68k_m68k;
 
 namespace
 {
-  typedef vm68k_byte_size B;
+  typedef vm68k_byte B;
 
   static const vm68k_instruction_decoder::spec inst1[] =
     {
-      { 0x1000, 0xe07, move_instruction<B, d_reg_direct_addressing, d_reg_direct_addressing>::execute },
-      { 0x1010, 0xe07, move_instruction<B, indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x1018, 0xe07, move_instruction<B, postinc_indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x1020, 0xe07, move_instruction<B, predec_indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x1028, 0xe07, move_instruction<B, disp_indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x1030, 0xe07, move_instruction<B, index_indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x1038, 0xe00, move_instruction<B, abs_short_addressing, d_reg_direct_addressing>::execute },
-      { 0x1039, 0xe00, move_instruction<B, abs_long_addressing, d_reg_direct_addressing>::execute },
-      { 0x103a, 0xe00, move_instruction<B, disp_pc_indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x103b, 0xe00, move_instruction<B, index_pc_indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x103c, 0xe00, move_instruction<B, immediate_addressing, d_reg_direct_addressing>::execute },
-      { 0x1080, 0xe07, move_instruction<B, d_reg_direct_addressing, indirect_addressing>::execute },
-      { 0x1090, 0xe07, move_instruction<B, indirect_addressing, indirect_addressing>::execute },
-      { 0x1098, 0xe07, move_instruction<B, postinc_indirect_addressing, indirect_addressing>::execute },
-      { 0x10a0, 0xe07, move_instruction<B, predec_indirect_addressing, indirect_addressing>::execute },
-      { 0x10a8, 0xe07, move_instruction<B, disp_indirect_addressing, indirect_addressing>::execute },
-      { 0x10b0, 0xe07, move_instruction<B, index_indirect_addressing, indirect_addressing>::execute },
-      { 0x10b8, 0xe00, move_instruction<B, abs_short_addressing, indirect_addressing>::execute },
-      { 0x10b9, 0xe00, move_instruction<B, abs_long_addressing, indirect_addressing>::execute },
-      { 0x10ba, 0xe00, move_instruction<B, disp_pc_indirect_addressing, indirect_addressing>::execute },
-      { 0x10bb, 0xe00, move_instruction<B, index_pc_indirect_addressing, indirect_addressing>::execute },
-      { 0x10bc, 0xe00, move_instruction<B, immediate_addressing, indirect_addressing>::execute },
-      { 0x10c0, 0xe07, move_instruction<B, d_reg_direct_addressing, postinc_indirect_addressing>::execute },
-      { 0x10d0, 0xe07, move_instruction<B, indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x10d8, 0xe07, move_instruction<B, postinc_indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x10e0, 0xe07, move_instruction<B, predec_indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x10e8, 0xe07, move_instruction<B, disp_indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x10f0, 0xe07, move_instruction<B, index_indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x10f8, 0xe00, move_instruction<B, abs_short_addressing, postinc_indirect_addressing>::execute },
-      { 0x10f9, 0xe00, move_instruction<B, abs_long_addressing, postinc_indirect_addressing>::execute },
-      { 0x10fa, 0xe00, move_instruction<B, disp_pc_indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x10fb, 0xe00, move_instruction<B, index_pc_indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x10fc, 0xe00, move_instruction<B, immediate_addressing, postinc_indirect_addressing>::execute },
-      { 0x1100, 0xe07, move_instruction<B, d_reg_direct_addressing, predec_indirect_addressing>::execute },
-      { 0x1110, 0xe07, move_instruction<B, indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x1118, 0xe07, move_instruction<B, postinc_indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x1120, 0xe07, move_instruction<B, predec_indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x1128, 0xe07, move_instruction<B, disp_indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x1130, 0xe07, move_instruction<B, index_indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x1138, 0xe00, move_instruction<B, abs_short_addressing, predec_indirect_addressing>::execute },
-      { 0x1139, 0xe00, move_instruction<B, abs_long_addressing, predec_indirect_addressing>::execute },
-      { 0x113a, 0xe00, move_instruction<B, disp_pc_indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x113b, 0xe00, move_instruction<B, index_pc_indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x113c, 0xe00, move_instruction<B, immediate_addressing, predec_indirect_addressing>::execute },
-      { 0x1140, 0xe07, move_instruction<B, d_reg_direct_addressing, disp_indirect_addressing>::execute },
-      { 0x1150, 0xe07, move_instruction<B, indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x1158, 0xe07, move_instruction<B, postinc_indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x1160, 0xe07, move_instruction<B, predec_indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x1168, 0xe07, move_instruction<B, disp_indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x1170, 0xe07, move_instruction<B, index_indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x1178, 0xe00, move_instruction<B, abs_short_addressing, disp_indirect_addressing>::execute },
-      { 0x1179, 0xe00, move_instruction<B, abs_long_addressing, disp_indirect_addressing>::execute },
-      { 0x117a, 0xe00, move_instruction<B, disp_pc_indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x117b, 0xe00, move_instruction<B, index_pc_indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x117c, 0xe00, move_instruction<B, immediate_addressing, disp_indirect_addressing>::execute },
-      { 0x1180, 0xe07, move_instruction<B, d_reg_direct_addressing, index_indirect_addressing>::execute },
-      { 0x1190, 0xe07, move_instruction<B, indirect_addressing, index_indirect_addressing>::execute },
-      { 0x1198, 0xe07, move_instruction<B, postinc_indirect_addressing, index_indirect_addressing>::execute },
-      { 0x11a0, 0xe07, move_instruction<B, predec_indirect_addressing, index_indirect_addressing>::execute },
-      { 0x11a8, 0xe07, move_instruction<B, disp_indirect_addressing, index_indirect_addressing>::execute },
-      { 0x11b0, 0xe07, move_instruction<B, index_indirect_addressing, index_indirect_addressing>::execute },
-      { 0x11b8, 0xe00, move_instruction<B, abs_short_addressing, index_indirect_addressing>::execute },
-      { 0x11b9, 0xe00, move_instruction<B, abs_long_addressing, index_indirect_addressing>::execute },
-      { 0x11ba, 0xe00, move_instruction<B, disp_pc_indirect_addressing, index_indirect_addressing>::execute },
-      { 0x11bb, 0xe00, move_instruction<B, index_pc_indirect_addressing, index_indirect_addressing>::execute },
-      { 0x11bc, 0xe00, move_instruction<B, immediate_addressing, index_indirect_addressing>::execute },
-      { 0x11c0,     7, move_instruction<B, d_reg_direct_addressing, abs_short_addressing>::execute },
-      { 0x11d0,     7, move_instruction<B, indirect_addressing, abs_short_addressing>::execute },
-      { 0x11d8,     7, move_instruction<B, postinc_indirect_addressing, abs_short_addressing>::execute },
-      { 0x11e0,     7, move_instruction<B, predec_indirect_addressing, abs_short_addressing>::execute },
-      { 0x11e8,     7, move_instruction<B, disp_indirect_addressing, abs_short_addressing>::execute },
-      { 0x11f0,     7, move_instruction<B, index_indirect_addressing, abs_short_addressing>::execute },
-      { 0x11f8,     0, move_instruction<B, abs_short_addressing, abs_short_addressing>::execute },
-      { 0x11f9,     0, move_instruction<B, abs_long_addressing, abs_short_addressing>::execute },
-      { 0x11fa,     0, move_instruction<B, disp_pc_indirect_addressing, abs_short_addressing>::execute },
-      { 0x11fb,     0, move_instruction<B, index_pc_indirect_addressing, abs_short_addressing>::execute },
-      { 0x11fc,     0, move_instruction<B, immediate_addressing, abs_short_addressing>::execute },
-      { 0x13c0,     7, move_instruction<B, d_reg_direct_addressing, abs_long_addressing>::execute },
-      { 0x13d0,     7, move_instruction<B, indirect_addressing, abs_long_addressing>::execute },
-      { 0x13d8,     7, move_instruction<B, postinc_indirect_addressing, abs_long_addressing>::execute },
-      { 0x13e0,     7, move_instruction<B, predec_indirect_addressing, abs_long_addressing>::execute },
-      { 0x13e8,     7, move_instruction<B, disp_indirect_addressing, abs_long_addressing>::execute },
-      { 0x13f0,     7, move_instruction<B, index_indirect_addressing, abs_long_addressing>::execute },
-      { 0x13f8,     0, move_instruction<B, abs_short_addressing, abs_long_addressing>::execute },
-      { 0x13f9,     0, move_instruction<B, abs_long_addressing, abs_long_addressing>::execute },
-      { 0x13fa,     0, move_instruction<B, disp_pc_indirect_addressing, abs_long_addressing>::execute },
-      { 0x13fb,     0, move_instruction<B, index_pc_indirect_addressing, abs_long_addressing>::execute },
-      { 0x13fc,     0, move_instruction<B, immediate_addressing, abs_long_addressing>::execute },
+      { 0x1000, 0xe07, move_instruction<B, d_reg_direct, d_reg_direct>::execute, move_instruction<B, d_reg_direct, d_reg_direct>::text, 0 },
+      { 0x1010, 0xe07, move_instruction<B, indirect, d_reg_direct>::execute, move_instruction<B, indirect, d_reg_direct>::text, 0 },
+      { 0x1018, 0xe07, move_instruction<B, postinc_indirect, d_reg_direct>::execute, move_instruction<B, postinc_indirect, d_reg_direct>::text, 0 },
+      { 0x1020, 0xe07, move_instruction<B, predec_indirect, d_reg_direct>::execute, move_instruction<B, predec_indirect, d_reg_direct>::text, 0 },
+      { 0x1028, 0xe07, move_instruction<B, disp_indirect, d_reg_direct>::execute, move_instruction<B, disp_indirect, d_reg_direct>::text, 0 },
+      { 0x1030, 0xe07, move_instruction<B, index_indirect, d_reg_direct>::execute, move_instruction<B, index_indirect, d_reg_direct>::text, 0 },
+      { 0x1038, 0xe00, move_instruction<B, abs_short, d_reg_direct>::execute, move_instruction<B, abs_short, d_reg_direct>::text, 0 },
+      { 0x1039, 0xe00, move_instruction<B, abs_long, d_reg_direct>::execute, move_instruction<B, abs_long, d_reg_direct>::text, 0 },
+      { 0x103a, 0xe00, move_instruction<B, disp_pc_indirect, d_reg_direct>::execute, move_instruction<B, disp_pc_indirect, d_reg_direct>::text, 0 },
+      { 0x103b, 0xe00, move_instruction<B, index_pc_indirect, d_reg_direct>::execute, move_instruction<B, index_pc_indirect, d_reg_direct>::text, 0 },
+      { 0x103c, 0xe00, move_instruction<B, immediate, d_reg_direct>::execute, move_instruction<B, immediate, d_reg_direct>::text, 0 },
+      { 0x1080, 0xe07, move_instruction<B, d_reg_direct, indirect>::execute, move_instruction<B, d_reg_direct, indirect>::text, 0 },
+      { 0x1090, 0xe07, move_instruction<B, indirect, indirect>::execute, move_instruction<B, indirect, indirect>::text, 0 },
+      { 0x1098, 0xe07, move_instruction<B, postinc_indirect, indirect>::execute, move_instruction<B, postinc_indirect, indirect>::text, 0 },
+      { 0x10a0, 0xe07, move_instruction<B, predec_indirect, indirect>::execute, move_instruction<B, predec_indirect, indirect>::text, 0 },
+      { 0x10a8, 0xe07, move_instruction<B, disp_indirect, indirect>::execute, move_instruction<B, disp_indirect, indirect>::text, 0 },
+      { 0x10b0, 0xe07, move_instruction<B, index_indirect, indirect>::execute, move_instruction<B, index_indirect, indirect>::text, 0 },
+      { 0x10b8, 0xe00, move_instruction<B, abs_short, indirect>::execute, move_instruction<B, abs_short, indirect>::text, 0 },
+      { 0x10b9, 0xe00, move_instruction<B, abs_long, indirect>::execute, move_instruction<B, abs_long, indirect>::text, 0 },
+      { 0x10ba, 0xe00, move_instruction<B, disp_pc_indirect, indirect>::execute, move_instruction<B, disp_pc_indirect, indirect>::text, 0 },
+      { 0x10bb, 0xe00, move_instruction<B, index_pc_indirect, indirect>::execute, move_instruction<B, index_pc_indirect, indirect>::text, 0 },
+      { 0x10bc, 0xe00, move_instruction<B, immediate, indirect>::execute, move_instruction<B, immediate, indirect>::text, 0 },
+      { 0x10c0, 0xe07, move_instruction<B, d_reg_direct, postinc_indirect>::execute, move_instruction<B, d_reg_direct, postinc_indirect>::text, 0 },
+      { 0x10d0, 0xe07, move_instruction<B, indirect, postinc_indirect>::execute, move_instruction<B, indirect, postinc_indirect>::text, 0 },
+      { 0x10d8, 0xe07, move_instruction<B, postinc_indirect, postinc_indirect>::execute, move_instruction<B, postinc_indirect, postinc_indirect>::text, 0 },
+      { 0x10e0, 0xe07, move_instruction<B, predec_indirect, postinc_indirect>::execute, move_instruction<B, predec_indirect, postinc_indirect>::text, 0 },
+      { 0x10e8, 0xe07, move_instruction<B, disp_indirect, postinc_indirect>::execute, move_instruction<B, disp_indirect, postinc_indirect>::text, 0 },
+      { 0x10f0, 0xe07, move_instruction<B, index_indirect, postinc_indirect>::execute, move_instruction<B, index_indirect, postinc_indirect>::text, 0 },
+      { 0x10f8, 0xe00, move_instruction<B, abs_short, postinc_indirect>::execute, move_instruction<B, abs_short, postinc_indirect>::text, 0 },
+      { 0x10f9, 0xe00, move_instruction<B, abs_long, postinc_indirect>::execute, move_instruction<B, abs_long, postinc_indirect>::text, 0 },
+      { 0x10fa, 0xe00, move_instruction<B, disp_pc_indirect, postinc_indirect>::execute, move_instruction<B, disp_pc_indirect, postinc_indirect>::text, 0 },
+      { 0x10fb, 0xe00, move_instruction<B, index_pc_indirect, postinc_indirect>::execute, move_instruction<B, index_pc_indirect, postinc_indirect>::text, 0 },
+      { 0x10fc, 0xe00, move_instruction<B, immediate, postinc_indirect>::execute, move_instruction<B, immediate, postinc_indirect>::text, 0 },
+      { 0x1100, 0xe07, move_instruction<B, d_reg_direct, predec_indirect>::execute, move_instruction<B, d_reg_direct, predec_indirect>::text, 0 },
+      { 0x1110, 0xe07, move_instruction<B, indirect, predec_indirect>::execute, move_instruction<B, indirect, predec_indirect>::text, 0 },
+      { 0x1118, 0xe07, move_instruction<B, postinc_indirect, predec_indirect>::execute, move_instruction<B, postinc_indirect, predec_indirect>::text, 0 },
+      { 0x1120, 0xe07, move_instruction<B, predec_indirect, predec_indirect>::execute, move_instruction<B, predec_indirect, predec_indirect>::text, 0 },
+      { 0x1128, 0xe07, move_instruction<B, disp_indirect, predec_indirect>::execute, move_instruction<B, disp_indirect, predec_indirect>::text, 0 },
+      { 0x1130, 0xe07, move_instruction<B, index_indirect, predec_indirect>::execute, move_instruction<B, index_indirect, predec_indirect>::text, 0 },
+      { 0x1138, 0xe00, move_instruction<B, abs_short, predec_indirect>::execute, move_instruction<B, abs_short, predec_indirect>::text, 0 },
+      { 0x1139, 0xe00, move_instruction<B, abs_long, predec_indirect>::execute, move_instruction<B, abs_long, predec_indirect>::text, 0 },
+      { 0x113a, 0xe00, move_instruction<B, disp_pc_indirect, predec_indirect>::execute, move_instruction<B, disp_pc_indirect, predec_indirect>::text, 0 },
+      { 0x113b, 0xe00, move_instruction<B, index_pc_indirect, predec_indirect>::execute, move_instruction<B, index_pc_indirect, predec_indirect>::text, 0 },
+      { 0x113c, 0xe00, move_instruction<B, immediate, predec_indirect>::execute, move_instruction<B, immediate, predec_indirect>::text, 0 },
+      { 0x1140, 0xe07, move_instruction<B, d_reg_direct, disp_indirect>::execute, move_instruction<B, d_reg_direct, disp_indirect>::text, 0 },
+      { 0x1150, 0xe07, move_instruction<B, indirect, disp_indirect>::execute, move_instruction<B, indirect, disp_indirect>::text, 0 },
+      { 0x1158, 0xe07, move_instruction<B, postinc_indirect, disp_indirect>::execute, move_instruction<B, postinc_indirect, disp_indirect>::text, 0 },
+      { 0x1160, 0xe07, move_instruction<B, predec_indirect, disp_indirect>::execute, move_instruction<B, predec_indirect, disp_indirect>::text, 0 },
+      { 0x1168, 0xe07, move_instruction<B, disp_indirect, disp_indirect>::execute, move_instruction<B, disp_indirect, disp_indirect>::text, 0 },
+      { 0x1170, 0xe07, move_instruction<B, index_indirect, disp_indirect>::execute, move_instruction<B, index_indirect, disp_indirect>::text, 0 },
+      { 0x1178, 0xe00, move_instruction<B, abs_short, disp_indirect>::execute, move_instruction<B, abs_short, disp_indirect>::text, 0 },
+      { 0x1179, 0xe00, move_instruction<B, abs_long, disp_indirect>::execute, move_instruction<B, abs_long, disp_indirect>::text, 0 },
+      { 0x117a, 0xe00, move_instruction<B, disp_pc_indirect, disp_indirect>::execute, move_instruction<B, disp_pc_indirect, disp_indirect>::text, 0 },
+      { 0x117b, 0xe00, move_instruction<B, index_pc_indirect, disp_indirect>::execute, move_instruction<B, index_pc_indirect, disp_indirect>::text, 0 },
+      { 0x117c, 0xe00, move_instruction<B, immediate, disp_indirect>::execute, move_instruction<B, immediate, disp_indirect>::text, 0 },
+      { 0x1180, 0xe07, move_instruction<B, d_reg_direct, index_indirect>::execute, move_instruction<B, d_reg_direct, index_indirect>::text, 0 },
+      { 0x1190, 0xe07, move_instruction<B, indirect, index_indirect>::execute, move_instruction<B, indirect, index_indirect>::text, 0 },
+      { 0x1198, 0xe07, move_instruction<B, postinc_indirect, index_indirect>::execute, move_instruction<B, postinc_indirect, index_indirect>::text, 0 },
+      { 0x11a0, 0xe07, move_instruction<B, predec_indirect, index_indirect>::execute, move_instruction<B, predec_indirect, index_indirect>::text, 0 },
+      { 0x11a8, 0xe07, move_instruction<B, disp_indirect, index_indirect>::execute, move_instruction<B, disp_indirect, index_indirect>::text, 0 },
+      { 0x11b0, 0xe07, move_instruction<B, index_indirect, index_indirect>::execute, move_instruction<B, index_indirect, index_indirect>::text, 0 },
+      { 0x11b8, 0xe00, move_instruction<B, abs_short, index_indirect>::execute, move_instruction<B, abs_short, index_indirect>::text, 0 },
+      { 0x11b9, 0xe00, move_instruction<B, abs_long, index_indirect>::execute, move_instruction<B, abs_long, index_indirect>::text, 0 },
+      { 0x11ba, 0xe00, move_instruction<B, disp_pc_indirect, index_indirect>::execute, move_instruction<B, disp_pc_indirect, index_indirect>::text, 0 },
+      { 0x11bb, 0xe00, move_instruction<B, index_pc_indirect, index_indirect>::execute, move_instruction<B, index_pc_indirect, index_indirect>::text, 0 },
+      { 0x11bc, 0xe00, move_instruction<B, immediate, index_indirect>::execute, move_instruction<B, immediate, index_indirect>::text, 0 },
+      { 0x11c0,     7, move_instruction<B, d_reg_direct, abs_short>::execute, move_instruction<B, d_reg_direct, abs_short>::text, 0 },
+      { 0x11d0,     7, move_instruction<B, indirect, abs_short>::execute, move_instruction<B, indirect, abs_short>::text, 0 },
+      { 0x11d8,     7, move_instruction<B, postinc_indirect, abs_short>::execute, move_instruction<B, postinc_indirect, abs_short>::text, 0 },
+      { 0x11e0,     7, move_instruction<B, predec_indirect, abs_short>::execute, move_instruction<B, predec_indirect, abs_short>::text, 0 },
+      { 0x11e8,     7, move_instruction<B, disp_indirect, abs_short>::execute, move_instruction<B, disp_indirect, abs_short>::text, 0 },
+      { 0x11f0,     7, move_instruction<B, index_indirect, abs_short>::execute, move_instruction<B, index_indirect, abs_short>::text, 0 },
+      { 0x11f8,     0, move_instruction<B, abs_short, abs_short>::execute, move_instruction<B, abs_short, abs_short>::text, 0 },
+      { 0x11f9,     0, move_instruction<B, abs_long, abs_short>::execute, move_instruction<B, abs_long, abs_short>::text, 0 },
+      { 0x11fa,     0, move_instruction<B, disp_pc_indirect, abs_short>::execute, move_instruction<B, disp_pc_indirect, abs_short>::text, 0 },
+      { 0x11fb,     0, move_instruction<B, index_pc_indirect, abs_short>::execute, move_instruction<B, index_pc_indirect, abs_short>::text, 0 },
+      { 0x11fc,     0, move_instruction<B, immediate, abs_short>::execute, move_instruction<B, immediate, abs_short>::text, 0 },
+      { 0x13c0,     7, move_instruction<B, d_reg_direct, abs_long>::execute, move_instruction<B, d_reg_direct, abs_long>::text, 0 },
+      { 0x13d0,     7, move_instruction<B, indirect, abs_long>::execute, move_instruction<B, indirect, abs_long>::text, 0 },
+      { 0x13d8,     7, move_instruction<B, postinc_indirect, abs_long>::execute, move_instruction<B, postinc_indirect, abs_long>::text, 0 },
+      { 0x13e0,     7, move_instruction<B, predec_indirect, abs_long>::execute, move_instruction<B, predec_indirect, abs_long>::text, 0 },
+      { 0x13e8,     7, move_instruction<B, disp_indirect, abs_long>::execute, move_instruction<B, disp_indirect, abs_long>::text, 0 },
+      { 0x13f0,     7, move_instruction<B, index_indirect, abs_long>::execute, move_instruction<B, index_indirect, abs_long>::text, 0 },
+      { 0x13f8,     0, move_instruction<B, abs_short, abs_long>::execute, move_instruction<B, abs_short, abs_long>::text, 0 },
+      { 0x13f9,     0, move_instruction<B, abs_long, abs_long>::execute, move_instruction<B, abs_long, abs_long>::text, 0 },
+      { 0x13fa,     0, move_instruction<B, disp_pc_indirect, abs_long>::execute, move_instruction<B, disp_pc_indirect, abs_long>::text, 0 },
+      { 0x13fb,     0, move_instruction<B, index_pc_indirect, abs_long>::execute, move_instruction<B, index_pc_indirect, abs_long>::text, 0 },
+      { 0x13fc,     0, move_instruction<B, immediate, abs_long>::execute, move_instruction<B, immediate, abs_long>::text, 0 },
     };
 }
 
@@ -144,4 +145,10 @@ namespace vx68k
     assert (p != NULL);
     p->insert (inst1 + 0, inst1 + sizeof inst1 / sizeof inst1[0]);
   }
+
+  void vm68k_disassembler::insert_inst1 (vm68k_disassembler *p)
+  {
+    assert (p != NULL);
+    p->insert (inst1 + 0, inst1 + sizeof inst1 / sizeof inst1[0]);
+  }
 }
@@ -0,0 +1,67 @@
+/* inst10 - instruction group 10 for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/processor>
+#include <vm68k/disasm>
+
+#include "control.h"
+
+#include <cassert>
+
+using namespace vx68k;
+using namespace vx68k_m68k;
+
+namespace
+{
+  static const vm68k_instruction_decoder::spec inst10[] =
+    {
+      { 0xa000, 0x0fff, unimplemented_instruction<10>::execute, unimplemented_instruction<10>::text, unimplemented_instruction<10>::flow },
+    };
+}
+
+namespace vx68k
+{
+  void
+  vm68k_instruction_decoder::insert_inst10 (vm68k_instruction_decoder *p)
+  {
+    assert (p != NULL);
+    p->insert (inst10 + 0, inst10 + sizeof inst10 / sizeof inst10[0]);
+  }
+
+  void
+  vm68k_disassembler::insert_inst10 (vm68k_disassembler *p)
+  {
+    assert (p != NULL);
+    p->insert (inst10 + 0, inst10 + sizeof inst10 / sizeof inst10[0]);
+  }
+}
@@ -0,0 +1,105 @@
+/* inst11 - instruction group 11 for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/processor>
+#include <vm68k/disasm>
+
+#include "arith.h"
+
+#include <cassert>
+
+using namespace vx68k;
+using namespace vx68k_m68k;
+
+namespace
+{
+  typedef vm68k_byte B;
+  typedef vm68k_word W;
+  typedef vm68k_long_word L;
+
+  static const vm68k_instruction_decoder::spec inst11[] =
+    {
+      { 0xb000, 0xe07, cmp_instruction<B, d_reg_direct>::execute, cmp_instruction<B, d_reg_direct>::text, 0 },
+      { 0xb010, 0xe07, cmp_instruction<B, indirect>::execute, cmp_instruction<B, indirect>::text, 0 },
+      { 0xb018, 0xe07, cmp_instruction<B, postinc_indirect>::execute, cmp_instruction<B, postinc_indirect>::text, 0 },
+      { 0xb020, 0xe07, cmp_instruction<B, predec_indirect>::execute, cmp_instruction<B, predec_indirect>::text, 0 },
+      { 0xb028, 0xe07, cmp_instruction<B, disp_indirect>::execute, cmp_instruction<B, disp_indirect>::text, 0 },
+      { 0xb030, 0xe07, cmp_instruction<B, index_indirect>::execute, cmp_instruction<B, index_indirect>::text, 0 },
+      { 0xb038, 0xe00, cmp_instruction<B, abs_short>::execute, cmp_instruction<B, abs_short>::text, 0 },
+      { 0xb039, 0xe00, cmp_instruction<B, abs_long>::execute, cmp_instruction<B, abs_long>::text, 0 },
+      { 0xb03a, 0xe00, cmp_instruction<B, disp_pc_indirect>::execute, cmp_instruction<B, disp_pc_indirect>::text, 0 },
+      { 0xb03b, 0xe00, cmp_instruction<B, index_pc_indirect>::execute, cmp_instruction<B, index_pc_indirect>::text, 0 },
+      { 0xb03c, 0xe00, cmp_instruction<B, immediate>::execute, cmp_instruction<B, immediate>::text, 0 },
+      { 0xb040, 0xe07, cmp_instruction<W, d_reg_direct>::execute, cmp_instruction<W, d_reg_direct>::text, 0 },
+      { 0xb048, 0xe07, cmp_instruction<W, a_reg_direct>::execute, cmp_instruction<W, a_reg_direct>::text, 0 },
+      { 0xb050, 0xe07, cmp_instruction<W, indirect>::execute, cmp_instruction<W, indirect>::text, 0 },
+      { 0xb058, 0xe07, cmp_instruction<W, postinc_indirect>::execute, cmp_instruction<W, postinc_indirect>::text, 0 },
+      { 0xb060, 0xe07, cmp_instruction<W, predec_indirect>::execute, cmp_instruction<W, predec_indirect>::text, 0 },
+      { 0xb068, 0xe07, cmp_instruction<W, disp_indirect>::execute, cmp_instruction<W, disp_indirect>::text, 0 },
+      { 0xb070, 0xe07, cmp_instruction<W, index_indirect>::execute, cmp_instruction<W, index_indirect>::text, 0 },
+      { 0xb078, 0xe00, cmp_instruction<W, abs_short>::execute, cmp_instruction<W, abs_short>::text, 0 },
+      { 0xb079, 0xe00, cmp_instruction<W, abs_long>::execute, cmp_instruction<W, abs_long>::text, 0 },
+      { 0xb07a, 0xe00, cmp_instruction<W, disp_pc_indirect>::execute, cmp_instruction<W, disp_pc_indirect>::text, 0 },
+      { 0xb07b, 0xe00, cmp_instruction<W, index_pc_indirect>::execute, cmp_instruction<W, index_pc_indirect>::text, 0 },
+      { 0xb07c, 0xe00, cmp_instruction<W, immediate>::execute, cmp_instruction<W, immediate>::text, 0 },
+      { 0xb080, 0xe07, cmp_instruction<L, d_reg_direct>::execute, cmp_instruction<L, d_reg_direct>::text, 0 },
+      { 0xb088, 0xe07, cmp_instruction<L, a_reg_direct>::execute, cmp_instruction<L, a_reg_direct>::text, 0 },
+      { 0xb090, 0xe07, cmp_instruction<L, indirect>::execute, cmp_instruction<L, indirect>::text, 0 },
+      { 0xb098, 0xe07, cmp_instruction<L, postinc_indirect>::execute, cmp_instruction<L, postinc_indirect>::text, 0 },
+      { 0xb0a0, 0xe07, cmp_instruction<L, predec_indirect>::execute, cmp_instruction<L, predec_indirect>::text, 0 },
+      { 0xb0a8, 0xe07, cmp_instruction<L, disp_indirect>::execute, cmp_instruction<L, disp_indirect>::text, 0 },
+      { 0xb0b0, 0xe07, cmp_instruction<L, index_indirect>::execute, cmp_instruction<L, index_indirect>::text, 0 },
+      { 0xb0b8, 0xe00, cmp_instruction<L, abs_short>::execute, cmp_instruction<L, abs_short>::text, 0 },
+      { 0xb0b9, 0xe00, cmp_instruction<L, abs_long>::execute, cmp_instruction<L, abs_long>::text, 0 },
+      { 0xb0ba, 0xe00, cmp_instruction<L, disp_pc_indirect>::execute, cmp_instruction<L, disp_pc_indirect>::text, 0 },
+      { 0xb0bb, 0xe00, cmp_instruction<L, index_pc_indirect>::execute, cmp_instruction<L, index_pc_indirect>::text, 0 },
+      { 0xb0bc, 0xe00, cmp_instruction<L, immediate>::execute, cmp_instruction<L, immediate>::text, 0 },
+    };
+}
+
+namespace vx68k
+{
+  void
+  vm68k_instruction_decoder::insert_inst11 (vm68k_instruction_decoder *p)
+  {
+    assert (p != NULL);
+    p->insert (inst11 + 0, inst11 + sizeof inst11 / sizeof inst11[0]);
+  }
+
+  void
+  vm68k_disassembler::insert_inst11 (vm68k_disassembler *p)
+  {
+    assert (p != NULL);
+    p->insert (inst11 + 0, inst11 + sizeof inst11 / sizeof inst11[0]);
+  }
+}
@@ -32,6 +32,7 @@
 #endif
 
 #include <vm68k/processor>
+#include <vm68k/disasm>
 
 #include "transfer.h"
 
@@ -42,118 +43,118 @@ using namespace vx68k_m68k;
 
 namespace
 {
-  typedef vm68k_long_word_size L;
+  typedef vm68k_long_word L;
 
   static const vm68k_instruction_decoder::spec inst2[] =
     {
-      { 0x2000, 0xe07, move_instruction<L, d_reg_direct_addressing, d_reg_direct_addressing>::execute },
-      { 0x2008, 0xe07, move_instruction<L, a_reg_direct_addressing, d_reg_direct_addressing>::execute },
-      { 0x2010, 0xe07, move_instruction<L, indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x2018, 0xe07, move_instruction<L, postinc_indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x2020, 0xe07, move_instruction<L, predec_indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x2028, 0xe07, move_instruction<L, disp_indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x2030, 0xe07, move_instruction<L, index_indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x2038, 0xe00, move_instruction<L, abs_short_addressing, d_reg_direct_addressing>::execute },
-      { 0x2039, 0xe00, move_instruction<L, abs_long_addressing, d_reg_direct_addressing>::execute },
-      { 0x203a, 0xe00, move_instruction<L, disp_pc_indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x203b, 0xe00, move_instruction<L, index_pc_indirect_addressing, d_reg_direct_addressing>::execute },
-      { 0x203c, 0xe00, move_instruction<L, immediate_addressing, d_reg_direct_addressing>::execute },
-      { 0x2040, 0xe07, movea_instruction<L, d_reg_direct_addressing>::execute },
-      { 0x2048, 0xe07, movea_instruction<L, a_reg_direct_addressing>::execute },
-      { 0x2050, 0xe07, movea_instruction<L, indirect_addressing>::execute },
-      { 0x2058, 0xe07, movea_instruction<L, postinc_indirect_addressing>::execute },
-      { 0x2060, 0xe07, movea_instruction<L, predec_indirect_addressing>::execute },
-      { 0x2068, 0xe07, movea_instruction<L, disp_indirect_addressing>::execute },
-      { 0x2070, 0xe07, movea_instruction<L, index_indirect_addressing>::execute },
-      { 0x2078, 0xe00, movea_instruction<L, abs_short_addressing>::execute },
-      { 0x2079, 0xe00, movea_instruction<L, abs_long_addressing>::execute },
-      { 0x207a, 0xe00, movea_instruction<L, disp_pc_indirect_addressing>::execute },
-      { 0x207b, 0xe00, movea_instruction<L, index_pc_indirect_addressing>::execute },
-      { 0x207c, 0xe00, movea_instruction<L, immediate_addressing>::execute },
-      { 0x2080, 0xe07, move_instruction<L, d_reg_direct_addressing, indirect_addressing>::execute },
-      { 0x2088, 0xe07, move_instruction<L, a_reg_direct_addressing, indirect_addressing>::execute },
-      { 0x2090, 0xe07, move_instruction<L, indirect_addressing, indirect_addressing>::execute },
-      { 0x2098, 0xe07, move_instruction<L, postinc_indirect_addressing, indirect_addressing>::execute },
-      { 0x20a0, 0xe07, move_instruction<L, predec_indirect_addressing, indirect_addressing>::execute },
-      { 0x20a8, 0xe07, move_instruction<L, disp_indirect_addressing, indirect_addressing>::execute },
-      { 0x20b0, 0xe07, move_instruction<L, index_indirect_addressing, indirect_addressing>::execute },
-      { 0x20b8, 0xe00, move_instruction<L, abs_short_addressing, indirect_addressing>::execute },
-      { 0x20b9, 0xe00, move_instruction<L, abs_long_addressing, indirect_addressing>::execute },
-      { 0x20ba, 0xe00, move_instruction<L, disp_pc_indirect_addressing, indirect_addressing>::execute },
-      { 0x20bb, 0xe00, move_instruction<L, index_pc_indirect_addressing, indirect_addressing>::execute },
-      { 0x20bc, 0xe00, move_instruction<L, immediate_addressing, indirect_addressing>::execute },
-      { 0x20c0, 0xe07, move_instruction<L, d_reg_direct_addressing, postinc_indirect_addressing>::execute },
-      { 0x20c8, 0xe07, move_instruction<L, a_reg_direct_addressing, postinc_indirect_addressing>::execute },
-      { 0x20d0, 0xe07, move_instruction<L, indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x20d8, 0xe07, move_instruction<L, postinc_indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x20e0, 0xe07, move_instruction<L, predec_indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x20e8, 0xe07, move_instruction<L, disp_indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x20f0, 0xe07, move_instruction<L, index_indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x20f8, 0xe00, move_instruction<L, abs_short_addressing, postinc_indirect_addressing>::execute },
-      { 0x20f9, 0xe00, move_instruction<L, abs_long_addressing, postinc_indirect_addressing>::execute },
-      { 0x20fa, 0xe00, move_instruction<L, disp_pc_indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x20fb, 0xe00, move_instruction<L, index_pc_indirect_addressing, postinc_indirect_addressing>::execute },
-      { 0x20fc, 0xe00, move_instruction<L, immediate_addressing, postinc_indirect_addressing>::execute },
-      { 0x2100, 0xe07, move_instruction<L, d_reg_direct_addressing, predec_indirect_addressing>::execute },
-      { 0x2108, 0xe07, move_instruction<L, a_reg_direct_addressing, predec_indirect_addressing>::execute },
-      { 0x2110, 0xe07, move_instruction<L, indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x2118, 0xe07, move_instruction<L, postinc_indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x2120, 0xe07, move_instruction<L, predec_indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x2128, 0xe07, move_instruction<L, disp_indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x2130, 0xe07, move_instruction<L, index_indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x2138, 0xe00, move_instruction<L, abs_short_addressing, predec_indirect_addressing>::execute },
-      { 0x2139, 0xe00, move_instruction<L, abs_long_addressing, predec_indirect_addressing>::execute },
-      { 0x213a, 0xe00, move_instruction<L, disp_pc_indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x213b, 0xe00, move_instruction<L, index_pc_indirect_addressing, predec_indirect_addressing>::execute },
-      { 0x213c, 0xe00, move_instruction<L, immediate_addressing, predec_indirect_addressing>::execute },
-      { 0x2140, 0xe07, move_instruction<L, d_reg_direct_addressing, disp_indirect_addressing>::execute },
-      { 0x2148, 0xe07, move_instruction<L, a_reg_direct_addressing, disp_indirect_addressing>::execute },
-      { 0x2150, 0xe07, move_instruction<L, indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x2158, 0xe07, move_instruction<L, postinc_indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x2160, 0xe07, move_instruction<L, predec_indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x2168, 0xe07, move_instruction<L, disp_indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x2170, 0xe07, move_instruction<L, index_indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x2178, 0xe00, move_instruction<L, abs_short_addressing, disp_indirect_addressing>::execute },
-      { 0x2179, 0xe00, move_instruction<L, abs_long_addressing, disp_indirect_addressing>::execute },
-      { 0x217a, 0xe00, move_instruction<L, disp_pc_indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x217b, 0xe00, move_instruction<L, index_pc_indirect_addressing, disp_indirect_addressing>::execute },
-      { 0x217c, 0xe00, move_instruction<L, immediate_addressing, disp_indirect_addressing>::execute },
-      { 0x2180, 0xe07, move_instruction<L, d_reg_direct_addressing, index_indirect_addressing>::execute },
-      { 0x2188, 0xe07, move_instruction<L, a_reg_direct_addressing, index_indirect_addressing>::execute },
-      { 0x2190, 0xe07, move_instruction<L, indirect_addressing, index_indirect_addressing>::execute },
-      { 0x2198, 0xe07, move_instruction<L, postinc_indirect_addressing, index_indirect_addressing>::execute },
-      { 0x21a0, 0xe07, move_instruction<L, predec_indirect_addressing, index_indirect_addressing>::execute },
-      { 0x21a8, 0xe07, move_instruction<L, disp_indirect_addressing, index_indirect_addressing>::execute },
-      { 0x21b0, 0xe07, move_instruction<L, index_indirect_addressing, index_indirect_addressing>::execute },
-      { 0x21b8, 0xe00, move_instruction<L, abs_short_addressing, index_indirect_addressing>::execute },
-      { 0x21b9, 0xe00, move_instruction<L, abs_long_addressing, index_indirect_addressing>::execute },
-      { 0x21ba, 0xe00, move_instruction<L, disp_pc_indirect_addressing, index_indirect_addressing>::execute },
-      { 0x21bb, 0xe00, move_instruction<L, index_pc_indirect_addressing, index_indirect_addressing>::execute },
-      { 0x21bc, 0xe00, move_instruction<L, immediate_addressing, index_indirect_addressing>::execute },
-      { 0x21c0,     7, move_instruction<L, d_reg_direct_addressing, abs_short_addressing>::execute },
-      { 0x21c8,     7, move_instruction<L, a_reg_direct_addressing, abs_short_addressing>::execute },
-      { 0x21d0,     7, move_instruction<L, indirect_addressing, abs_short_addressing>::execute },
-      { 0x21d8,     7, move_instruction<L, postinc_indirect_addressing, abs_short_addressing>::execute },
-      { 0x21e0,     7, move_instruction<L, predec_indirect_addressing, abs_short_addressing>::execute },
-      { 0x21e8,     7, move_instruction<L, disp_indirect_addressing, abs_short_addressing>::execute },
-      { 0x21f0,     7, move_instruction<L, index_indirect_addressing, abs_short_addressing>::execute },
-      { 0x21f8,     0, move_instruction<L, abs_short_addressing, abs_short_addressing>::execute },
-      { 0x21f9,     0, move_instruction<L, abs_long_addressing, abs_short_addressing>::execute },
-      { 0x21fa,     0, move_instruction<L, disp_pc_indirect_addressing, abs_short_addressing>::execute },
-      { 0x21fb,     0, move_instruction<L, index_pc_indirect_addressing, abs_short_addressing>::execute },
-      { 0x21fc,     0, move_instruction<L, immediate_addressing, abs_short_addressing>::execute },
-      { 0x23c0,     7, move_instruction<L, d_reg_direct_addressing, abs_long_addressing>::execute },
-      { 0x23c8,     7, move_instruction<L, a_reg_direct_addressing, abs_long_addressing>::execute },
-      { 0x23d0,     7, move_instruction<L, indirect_addressing, abs_long_addressing>::execute },
-      { 0x23d8,     7, move_instruction<L, postinc_indirect_addressing, abs_long_addressing>::execute },
-      { 0x23e0,     7, move_instruction<L, predec_indirect_addressing, abs_long_addressing>::execute },
-      { 0x23e8,     7, move_instruction<L, disp_indirect_addressing, abs_long_addressing>::execute },
-      { 0x23f0,     7, move_instruction<L, index_indirect_addressing, abs_long_addressing>::execute },
-      { 0x23f8,     0, move_instruction<L, abs_short_addressing, abs_long_addressing>::execute },
-      { 0x23f9,     0, move_instruction<L, abs_long_addressing, abs_long_addressing>::execute },
-      { 0x23fa,     0, move_instruction<L, disp_pc_indirect_addressing, abs_long_addressing>::execute },
-      { 0x23fb,     0, move_instruction<L, index_pc_indirect_addressing, abs_long_addressing>::execute },
-      { 0x23fc,     0, move_instruction<L, immediate_addressing, abs_long_addressing>::execute },
+      { 0x2000, 0xe07, move_instruction<L, d_reg_direct, d_reg_direct>::execute, move_instruction<L, d_reg_direct, d_reg_direct>::text, 0 },
+      { 0x2008, 0xe07, move_instruction<L, a_reg_direct, d_reg_direct>::execute, move_instruction<L, a_reg_direct, d_reg_direct>::text, 0 },
+      { 0x2010, 0xe07, move_instruction<L, indirect, d_reg_direct>::execute, move_instruction<L, indirect, d_reg_direct>::text, 0 },
+      { 0x2018, 0xe07, move_instruction<L, postinc_indirect, d_reg_direct>::execute, move_instruction<L, postinc_indirect, d_reg_direct>::text, 0 },
+      { 0x2020, 0xe07, move_instruction<L, predec_indirect, d_reg_direct>::execute, move_instruction<L, predec_indirect, d_reg_direct>::text, 0 },
+      { 0x2028, 0xe07, move_instruction<L, disp_indirect, d_reg_direct>::execute, move_instruction<L, disp_indirect, d_reg_direct>::text, 0 },
+      { 0x2030, 0xe07, move_instruction<L, index_indirect, d_reg_direct>::execute, move_instruction<L, index_indirect, d_reg_direct>::text, 0 },
+      { 0x2038, 0xe00, move_instruction<L, abs_short, d_reg_direct>::execute, move_instruction<L, abs_short, d_reg_direct>::text, 0 },
+      { 0x2039, 0xe00, move_instruction<L, abs_long, d_reg_direct>::execute, move_instruction<L, abs_long, d_reg_direct>::text, 0 },
+      { 0x203a, 0xe00, move_instruction<L, disp_pc_indirect, d_reg_direct>::execute, move_instruction<L, disp_pc_indirect, d_reg_direct>::text, 0 },
+      { 0x203b, 0xe00, move_instruction<L, index_pc_indirect, d_reg_direct>::execute, move_instruction<L, index_pc_indirect, d_reg_direct>::text, 0 },
+      { 0x203c, 0xe00, move_instruction<L, immediate, d_reg_direct>::execute, move_instruction<L, immediate, d_reg_direct>::text, 0 },
+      { 0x2040, 0xe07, movea_instruction<L, d_reg_direct>::execute, movea_instruction<L, d_reg_direct>::text, 0 },
+      { 0x2048, 0xe07, movea_instruction<L, a_reg_direct>::execute, movea_instruction<L, a_reg_direct>::text, 0 },
+      { 0x2050, 0xe07, movea_instruction<L, indirect>::execute, movea_instruction<L, indirect>::text, 0 },
+      { 0x2058, 0xe07, movea_instruction<L, postinc_indirect>::execute, movea_instruction<L, postinc_indirect>::text, 0 },
+      { 0x2060, 0xe07, movea_instruction<L, predec_indirect>::execute, movea_instruction<L, predec_indirect>::text, 0 },
+      { 0x2068, 0xe07, movea_instruction<L, disp_indirect>::execute, movea_instruction<L, disp_indirect>::text, 0 },
+      { 0x2070, 0xe07, movea_instruction<L, index_indirect>::execute, movea_instruction<L, index_indirect>::text, 0 },
+      { 0x2078, 0xe00, movea_instruction<L, abs_short>::execute, movea_instruction<L, abs_short>::text, 0 },
+      { 0x2079, 0xe00, movea_instruction<L, abs_long>::execute, movea_instruction<L, abs_long>::text, 0 },
+      { 0x207a, 0xe00, movea_instruction<L, disp_pc_indirect>::execute, movea_instruction<L, disp_pc_indirect>::text, 0 },
+      { 0x207b, 0xe00, movea_instruction<L, index_pc_indirect>::execute, movea_instruction<L, index_pc_indirect>::text, 0 },
+      { 0x207c, 0xe00, movea_instruction<L, immediate>::execute, movea_instruction<L, immediate>::text, 0 },
+      { 0x2080, 0xe07, move_instruction<L, d_reg_direct, indirect>::execute, move_instruction<L, d_reg_direct, indirect>::text, 0 },
+      { 0x2088, 0xe07, move_instruction<L, a_reg_direct, indirect>::execute, move_instruction<L, a_reg_direct, indirect>::text, 0 },
+      { 0x2090, 0xe07, move_instruction<L, indirect, indirect>::execute, move_instruction<L, indirect, indirect>::text, 0 },
+      { 0x2098, 0xe07, move_instruction<L, postinc_indirect, indirect>::execute, move_instruction<L, postinc_indirect, indirect>::text, 0 },
+      { 0x20a0, 0xe07, move_instruction<L, predec_indirect, indirect>::execute, move_instruction<L, predec_indirect, indirect>::text, 0 },
+      { 0x20a8, 0xe07, move_instruction<L, disp_indirect, indirect>::execute, move_instruction<L, disp_indirect, indirect>::text, 0 },
+      { 0x20b0, 0xe07, move_instruction<L, index_indirect, indirect>::execute, move_instruction<L, index_indirect, indirect>::text, 0 },
+      { 0x20b8, 0xe00, move_instruction<L, abs_short, indirect>::execute, move_instruction<L, abs_short, indirect>::text, 0 },
+      { 0x20b9, 0xe00, move_instruction<L, abs_long, indirect>::execute, move_instruction<L, abs_long, indirect>::text, 0 },
+      { 0x20ba, 0xe00, move_instruction<L, disp_pc_indirect, indirect>::execute, move_instruction<L, disp_pc_indirect, indirect>::text, 0 },
+      { 0x20bb, 0xe00, move_instruction<L, index_pc_indirect, indirect>::execute, move_instruction<L, index_pc_indirect, indirect>::text, 0 },
+      { 0x20bc, 0xe00, move_instruction<L, immediate, indirect>::execute, move_instruction<L, immediate, indirect>::text, 0 },
+      { 0x20c0, 0xe07, move_instruction<L, d_reg_direct, postinc_indirect>::execute, move_instruction<L, d_reg_direct, postinc_indirect>::text, 0 },
+      { 0x20c8, 0xe07, move_instruction<L, a_reg_direct, postinc_indirect>::execute, move_instruction<L, a_reg_direct, postinc_indirect>::text, 0 },
+      { 0x20d0, 0xe07, move_instruction<L, indirect, postinc_indirect>::execute, move_instruction<L, indirect, postinc_indirect>::text, 0 },
+      { 0x20d8, 0xe07, move_instruction<L, postinc_indirect, postinc_indirect>::execute, move_instruction<L, postinc_indirect, postinc_indirect>::text, 0 },
+      { 0x20e0, 0xe07, move_instruction<L, predec_indirect, postinc_indirect>::execute, move_instruction<L, predec_indirect, postinc_indirect>::text, 0 },
+      { 0x20e8, 0xe07, move_instruction<L, disp_indirect, postinc_indirect>::execute, move_instruction<L, disp_indirect, postinc_indirect>::text, 0 },
+      { 0x20f0, 0xe07, move_instruction<L, index_indirect, postinc_indirect>::execute, move_instruction<L, index_indirect, postinc_indirect>::text, 0 },
+      { 0x20f8, 0xe00, move_instruction<L, abs_short, postinc_indirect>::execute, move_instruction<L, abs_short, postinc_indirect>::text, 0 },
+      { 0x20f9, 0xe00, move_instruction<L, abs_long, postinc_indirect>::execute, move_instruction<L, abs_long, postinc_indirect>::text, 0 },
+      { 0x20fa, 0xe00, move_instruction<L, disp_pc_indirect, postinc_indirect>::execute, move_instruction<L, disp_pc_indirect, postinc_indirect>::text, 0 },
+      { 0x20fb, 0xe00, move_instruction<L, index_pc_indirect, postinc_indirect>::execute, move_instruction<L, index_pc_indirect, postinc_indirect>::text, 0 },
+      { 0x20fc, 0xe00, move_instruction<L, immediate, postinc_indirect>::execute, move_instruction<L, immediate, postinc_indirect>::text, 0 },
+      { 0x2100, 0xe07, move_instruction<L, d_reg_direct, predec_indirect>::execute, move_instruction<L, d_reg_direct, predec_indirect>::text, 0 },
+      { 0x2108, 0xe07, move_instruction<L, a_reg_direct, predec_indirect>::execute, move_instruction<L, a_reg_direct, predec_indirect>::text, 0 },
+      { 0x2110, 0xe07, move_instruction<L, indirect, predec_indirect>::execute, move_instruction<L, indirect, predec_indirect>::text, 0 },
+      { 0x2118, 0xe07, move_instruction<L, postinc_indirect, predec_indirect>::execute, move_instruction<L, postinc_indirect, predec_indirect>::text, 0 },
+      { 0x2120, 0xe07, move_instruction<L, predec_indirect, predec_indirect>::execute, move_instruction<L, predec_indirect, predec_indirect>::text, 0 },
+      { 0x2128, 0xe07, move_instruction<L, disp_indirect, predec_indirect>::execute, move_instruction<L, disp_indirect, predec_indirect>::text, 0 },
+      { 0x2130, 0xe07, move_instruction<L, index_indirect, predec_indirect>::execute, move_instruction<L, index_indirect, predec_indirect>::text, 0 },
+      { 0x2138, 0xe00, move_instruction<L, abs_short, predec_indirect>::execute, move_instruction<L, abs_short, predec_indirect>::text, 0 },
+      { 0x2139, 0xe00, move_instruction<L, abs_long, predec_indirect>::execute, move_instruction<L, abs_long, predec_indirect>::text, 0 },
+      { 0x213a, 0xe00, move_instruction<L, disp_pc_indirect, predec_indirect>::execute, move_instruction<L, disp_pc_indirect, predec_indirect>::text, 0 },
+      { 0x213b, 0xe00, move_instruction<L, index_pc_indirect, predec_indirect>::execute, move_instruction<L, index_pc_indirect, predec_indirect>::text, 0 },
+      { 0x213c, 0xe00, move_instruction<L, immediate, predec_indirect>::execute, move_instruction<L, immediate, predec_indirect>::text, 0 },
+      { 0x2140, 0xe07, move_instruction<L, d_reg_direct, disp_indirect>::execute, move_instruction<L, d_reg_direct, disp_indirect>::text, 0 },
+      { 0x2148, 0xe07, move_instruction<L, a_reg_direct, disp_indirect>::execute, move_instruction<L, a_reg_direct, disp_indirect>::text, 0 },
+      { 0x2150, 0xe07, move_instruction<L, indirect, disp_indirect>::execute, move_instruction<L, indirect, disp_indirect>::text, 0 },
+      { 0x2158, 0xe07, move_instruction<L, postinc_indirect, disp_indirect>::execute, move_instruction<L, postinc_indirect, disp_indirect>::text, 0 },
+      { 0x2160, 0xe07, move_instruction<L, predec_indirect, disp_indirect>::execute, move_instruction<L, predec_indirect, disp_indirect>::text, 0 },
+      { 0x2168, 0xe07, move_instruction<L, disp_indirect, disp_indirect>::execute, move_instruction<L, disp_indirect, disp_indirect>::text, 0 },
+      { 0x2170, 0xe07, move_instruction<L, index_indirect, disp_indirect>::execute, move_instruction<L, index_indirect, disp_indirect>::text, 0 },
+      { 0x2178, 0xe00, move_instruction<L, abs_short, disp_indirect>::execute, move_instruction<L, abs_short, disp_indirect>::text, 0 },
+      { 0x2179, 0xe00, move_instruction<L, abs_long, disp_indirect>::execute, move_instruction<L, abs_long, disp_indirect>::text, 0 },
+      { 0x217a, 0xe00, move_instruction<L, disp_pc_indirect, disp_indirect>::execute, move_instruction<L, disp_pc_indirect, disp_indirect>::text, 0 },
+      { 0x217b, 0xe00, move_instruction<L, index_pc_indirect, disp_indirect>::execute, move_instruction<L, index_pc_indirect, disp_indirect>::text, 0 },
+      { 0x217c, 0xe00, move_instruction<L, immediate, disp_indirect>::execute, move_instruction<L, immediate, disp_indirect>::text, 0 },
+      { 0x2180, 0xe07, move_instruction<L, d_reg_direct, index_indirect>::execute, move_instruction<L, d_reg_direct, index_indirect>::text, 0 },
+      { 0x2188, 0xe07, move_instruction<L, a_reg_direct, index_indirect>::execute, move_instruction<L, a_reg_direct, index_indirect>::text, 0 },
+      { 0x2190, 0xe07, move_instruction<L, indirect, index_indirect>::execute, move_instruction<L, indirect, index_indirect>::text, 0 },
+      { 0x2198, 0xe07, move_instruction<L, postinc_indirect, index_indirect>::execute, move_instruction<L, postinc_indirect, index_indirect>::text, 0 },
+      { 0x21a0, 0xe07, move_instruction<L, predec_indirect, index_indirect>::execute, move_instruction<L, predec_indirect, index_indirect>::text, 0 },
+      { 0x21a8, 0xe07, move_instruction<L, disp_indirect, index_indirect>::execute, move_instruction<L, disp_indirect, index_indirect>::text, 0 },
+      { 0x21b0, 0xe07, move_instruction<L, index_indirect, index_indirect>::execute, move_instruction<L, index_indirect, index_indirect>::text, 0 },
+      { 0x21b8, 0xe00, move_instruction<L, abs_short, index_indirect>::execute, move_instruction<L, abs_short, index_indirect>::text, 0 },
+      { 0x21b9, 0xe00, move_instruction<L, abs_long, index_indirect>::execute, move_instruction<L, abs_long, index_indirect>::text, 0 },
+      { 0x21ba, 0xe00, move_instruction<L, disp_pc_indirect, index_indirect>::execute, move_instruction<L, disp_pc_indirect, index_indirect>::text, 0 },
+      { 0x21bb, 0xe00, move_instruction<L, index_pc_indirect, index_indirect>::execute, move_instruction<L, index_pc_indirect, index_indirect>::text, 0 },
+      { 0x21bc, 0xe00, move_instruction<L, immediate, index_indirect>::execute, move_instruction<L, immediate, index_indirect>::text, 0 },
+      { 0x21c0,     7, move_instruction<L, d_reg_direct, abs_short>::execute, move_instruction<L, d_reg_direct, abs_short>::text, 0 },
+      { 0x21c8,     7, move_instruction<L, a_reg_direct, abs_short>::execute, move_instruction<L, a_reg_direct, abs_short>::text, 0 },
+      { 0x21d0,     7, move_instruction<L, indirect, abs_short>::execute, move_instruction<L, indirect, abs_short>::text, 0 },
+      { 0x21d8,     7, move_instruction<L, postinc_indirect, abs_short>::execute, move_instruction<L, postinc_indirect, abs_short>::text, 0 },
+      { 0x21e0,     7, move_instruction<L, predec_indirect, abs_short>::execute, move_instruction<L, predec_indirect, abs_short>::text, 0 },
+      { 0x21e8,     7, move_instruction<L, disp_indirect, abs_short>::execute, move_instruction<L, disp_indirect, abs_short>::text, 0 },
+      { 0x21f0,     7, move_instruction<L, index_indirect, abs_short>::execute, move_instruction<L, index_indirect, abs_short>::text, 0 },
+      { 0x21f8,     0, move_instruction<L, abs_short, abs_short>::execute, move_instruction<L, abs_short, abs_short>::text, 0 },
+      { 0x21f9,     0, move_instruction<L, abs_long, abs_short>::execute, move_instruction<L, abs_long, abs_short>::text, 0 },
+      { 0x21fa,     0, move_instruction<L, disp_pc_indirect, abs_short>::execute, move_instruction<L, disp_pc_indirect, abs_short>::text, 0 },
+      { 0x21fb,     0, move_instruction<L, index_pc_indirect, abs_short>::execute, move_instruction<L, index_pc_indirect, abs_short>::text, 0 },
+      { 0x21fc,     0, move_instruction<L, immediate, abs_short>::execute, move_instruction<L, immediate, abs_short>::text, 0 },
+      { 0x23c0,     7, move_instruction<L, d_reg_direct, abs_long>::execute, move_instruction<L, d_reg_direct, abs_long>::text, 0 },
+      { 0x23c8,     7, move_instruction<L, a_reg_direct, abs_long>::execute, move_instruction<L, a_reg_direct, abs_long>::text, 0 },
+      { 0x23d0,     7, move_instruction<L, indirect, abs_long>::execute, move_instruction<L, indirect, abs_long>::text, 0 },
+      { 0x23d8,     7, move_instruction<L, postinc_indirect, abs_long>::execute, move_instruction<L, postinc_indirect, abs_long>::text, 0 },
+      { 0x23e0,     7, move_instruction<L, predec_indirect, abs_long>::execute, move_instruction<L, predec_indirect, abs_long>::text, 0 },
+      { 0x23e8,     7, move_instruction<L, disp_indirect, abs_long>::execute, move_instruction<L, disp_indirect, abs_long>::text, 0 },
+      { 0x23f0,     7, move_instruction<L, index_indirect, abs_long>::execute, move_instruction<L, index_indirect, abs_long>::text, 0 },
+      { 0x23f8,     0, move_instruction<L, abs_short, abs_long>::execute, move_instruction<L, abs_short, abs_long>::text, 0 },
+      { 0x23f9,     0, move_instruction<L, abs_long, abs_long>::execute, move_instruction<L, abs_long, abs_long>::text, 0 },
+      { 0x23fa,     0, move_instruction<L, disp_pc_indirect, abs_long>::execute, move_instruction<L, disp_pc_indirect, abs_long>::text, 0 },
+      { 0x23fb,     0, move_instruction<L, index_pc_indirect, abs_long>::execute, move_instruction<L, index_pc_indirect, abs_long>::text, 0 },
+      { 0x23fc,     0, move_instruction<L, immediate, abs_long>::execute, move_instruction<L, immediate, abs_long>::text, 0 },
     };
 }
 
@@ -164,4 +165,10 @@ namespace vx68k
     assert (p != NULL);
     p->insert (inst2 + 0, inst2 + sizeof inst2 / sizeof inst2[0]);
   }
+
+  void vm68k_disassembler::insert_inst2 (vm68k_disassembler *p)
+  {
+    assert (p != NULL);
+    p->insert (inst2 + 0, inst2 + sizeof inst2 / sizeof inst2[0]);
+  }
 }
@@ -0,0 +1,110 @@
+/* inst4 - instruction group 4 for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/processor>
+#include <vm68k/disasm>
+
+#include "arith.h"
+#include "control.h"
+
+#include <cassert>
+
+using namespace vx68k;
+using namespace vx68k_m68k;
+
+namespace
+{
+  typedef vm68k_byte B;
+  typedef vm68k_word W;
+  typedef vm68k_long_word L;
+
+  static const vm68k_instruction_decoder::spec inst4[] =
+    {
+      { 0x4a00,     7, tst_instruction<B, d_reg_direct>::execute, tst_instruction<B, d_reg_direct>::text, 0 },
+      { 0x4a10,     7, tst_instruction<B, indirect>::execute, tst_instruction<B, indirect>::text, 0 },
+      { 0x4a18,     7, tst_instruction<B, postinc_indirect>::execute, tst_instruction<B, postinc_indirect>::text, 0 },
+      { 0x4a20,     7, tst_instruction<B, predec_indirect>::execute, tst_instruction<B, predec_indirect>::text, 0 },
+      { 0x4a28,     7, tst_instruction<B, disp_indirect>::execute, tst_instruction<B, disp_indirect>::text, 0 },
+      { 0x4a30,     7, tst_instruction<B, index_indirect>::execute, tst_instruction<B, index_indirect>::text, 0 },
+      { 0x4a38,     0, tst_instruction<B, abs_short>::execute, tst_instruction<B, abs_short>::text, 0 },
+      { 0x4a39,     0, tst_instruction<B, abs_long>::execute, tst_instruction<B, abs_long>::text, 0 },
+      { 0x4a40,     7, tst_instruction<W, d_reg_direct>::execute, tst_instruction<W, d_reg_direct>::text, 0 },
+      { 0x4a50,     7, tst_instruction<W, indirect>::execute, tst_instruction<W, indirect>::text, 0 },
+      { 0x4a58,     7, tst_instruction<W, postinc_indirect>::execute, tst_instruction<W, postinc_indirect>::text, 0 },
+      { 0x4a60,     7, tst_instruction<W, predec_indirect>::execute, tst_instruction<W, predec_indirect>::text, 0 },
+      { 0x4a68,     7, tst_instruction<W, disp_indirect>::execute, tst_instruction<W, disp_indirect>::text, 0 },
+      { 0x4a70,     7, tst_instruction<W, index_indirect>::execute, tst_instruction<W, index_indirect>::text, 0 },
+      { 0x4a78,     0, tst_instruction<W, abs_short>::execute, tst_instruction<W, abs_short>::text, 0 },
+      { 0x4a79,     0, tst_instruction<W, abs_long>::execute, tst_instruction<W, abs_long>::text, 0 },
+      { 0x4a80,     7, tst_instruction<L, d_reg_direct>::execute, tst_instruction<L, d_reg_direct>::text, 0 },
+      { 0x4a90,     7, tst_instruction<L, indirect>::execute, tst_instruction<L, indirect>::text, 0 },
+      { 0x4a98,     7, tst_instruction<L, postinc_indirect>::execute, tst_instruction<L, postinc_indirect>::text, 0 },
+      { 0x4aa0,     7, tst_instruction<L, predec_indirect>::execute, tst_instruction<L, predec_indirect>::text, 0 },
+      { 0x4aa8,     7, tst_instruction<L, disp_indirect>::execute, tst_instruction<L, disp_indirect>::text, 0 },
+      { 0x4ab0,     7, tst_instruction<L, index_indirect>::execute, tst_instruction<L, index_indirect>::text, 0 },
+      { 0x4ab8,     0, tst_instruction<L, abs_short>::execute, tst_instruction<L, abs_short>::text, 0 },
+      { 0x4ab9,     0, tst_instruction<L, abs_long>::execute, tst_instruction<L, abs_long>::text, 0 },
+      { 0x4e40,   0xf, trap_instruction::execute, trap_instruction::text, trap_instruction::flow },
+      { 0x4e72,     0, stop_instruction::execute, stop_instruction::text, 0 },
+      { 0x4e73,     0, rte_instruction::execute, rte_instruction::text, rte_instruction::flow },
+      { 0x4e90,     7, jsr_instruction<indirect>::execute, jsr_instruction<indirect>::text, jsr_instruction<indirect>::flow },
+      { 0x4ea8,     7, jsr_instruction<disp_indirect>::execute, jsr_instruction<disp_indirect>::text, jsr_instruction<disp_indirect>::flow },
+      { 0x4eb0,     7, jsr_instruction<index_indirect>::execute, jsr_instruction<index_indirect>::text, jsr_instruction<index_indirect>::flow },
+      { 0x4eb8,     0, jsr_instruction<abs_short>::execute, jsr_instruction<abs_short>::text, jsr_instruction<abs_short>::flow },
+      { 0x4eb9,     0, jsr_instruction<abs_long>::execute, jsr_instruction<abs_long>::text, jsr_instruction<abs_long>::flow },
+      { 0x4eba,     0, jsr_instruction<disp_pc_indirect>::execute, jsr_instruction<disp_pc_indirect>::text, jsr_instruction<disp_pc_indirect>::flow },
+      { 0x4ebb,     0, jsr_instruction<index_pc_indirect>::execute, jsr_instruction<index_pc_indirect>::text, jsr_instruction<index_pc_indirect>::flow },
+      { 0x4ed0,     7, jmp_instruction<indirect>::execute, jmp_instruction<indirect>::text, jmp_instruction<indirect>::flow },
+      { 0x4ee8,     7, jmp_instruction<disp_indirect>::execute, jmp_instruction<disp_indirect>::text, jmp_instruction<disp_indirect>::flow },
+      { 0x4ef0,     7, jmp_instruction<index_indirect>::execute, jmp_instruction<index_indirect>::text, jmp_instruction<index_indirect>::flow },
+      { 0x4ef8,     0, jmp_instruction<abs_short>::execute, jmp_instruction<abs_short>::text, jmp_instruction<abs_short>::flow },
+      { 0x4ef9,     0, jmp_instruction<abs_long>::execute, jmp_instruction<abs_long>::text, jmp_instruction<abs_long>::flow },
+      { 0x4efa,     0, jmp_instruction<disp_pc_indirect>::execute, jmp_instruction<disp_pc_indirect>::text, jmp_instruction<disp_pc_indirect>::flow },
+      { 0x4efb,     0, jmp_instruction<index_pc_indirect>::execute, jmp_instruction<index_pc_indirect>::text, jmp_instruction<index_pc_indirect>::flow },
+    };
+}
+
+namespace vx68k
+{
+  void vm68k_instruction_decoder::insert_inst4 (vm68k_instruction_decoder *p)
+  {
+    assert (p != NULL);
+    p->insert (inst4 + 0, inst4 + sizeof inst4 / sizeof inst4[0]);
+  }
+
+  void vm68k_disassembler::insert_inst4 (vm68k_disassembler *p)
+  {
+    assert (p != NULL);
+    p->insert (inst4 + 0, inst4 + sizeof inst4 / sizeof inst4[0]);
+  }
+}
@@ -0,0 +1,137 @@
+/* inst5 - instruction group 5 for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/processor>
+#include <vm68k/disasm>
+
+#include "arith.h"
+#include "branch.h"
+
+#include <cassert>
+
+using namespace vx68k;
+using namespace vx68k_m68k;
+
+namespace
+{
+  typedef vm68k_byte B;
+  typedef vm68k_word W;
+  typedef vm68k_long_word L;
+
+  static const vm68k_instruction_decoder::spec inst5[] =
+    {
+      { 0x5000, 0xe07, addq_instruction<B, d_reg_direct>::execute, addq_instruction<B, d_reg_direct>::text, 0 },
+      { 0x5010, 0xe07, addq_instruction<B, indirect>::execute, addq_instruction<B, indirect>::text, 0 },
+      { 0x5018, 0xe07, addq_instruction<B, postinc_indirect>::execute, addq_instruction<B, postinc_indirect>::text, 0 },
+      { 0x5020, 0xe07, addq_instruction<B, predec_indirect>::execute, addq_instruction<B, predec_indirect>::text, 0 },
+      { 0x5028, 0xe07, addq_instruction<B, disp_indirect>::execute, addq_instruction<B, disp_indirect>::text, 0 },
+      { 0x5030, 0xe07, addq_instruction<B, index_indirect>::execute, addq_instruction<B, index_indirect>::text, 0 },
+      { 0x5038, 0xe00, addq_instruction<B, abs_short>::execute, addq_instruction<B, abs_short>::text, 0 },
+      { 0x5039, 0xe00, addq_instruction<B, abs_long>::execute, addq_instruction<B, abs_long>::text, 0 },
+      { 0x5040, 0xe07, addq_instruction<W, d_reg_direct>::execute, addq_instruction<W, d_reg_direct>::text, 0 },
+      { 0x5048, 0xe07, addqa_instruction::execute, addqa_instruction::text, 0 },
+      { 0x5050, 0xe07, addq_instruction<W, indirect>::execute, addq_instruction<W, indirect>::text, 0 },
+      { 0x5058, 0xe07, addq_instruction<W, postinc_indirect>::execute, addq_instruction<W, postinc_indirect>::text, 0 },
+      { 0x5060, 0xe07, addq_instruction<W, predec_indirect>::execute, addq_instruction<W, predec_indirect>::text, 0 },
+      { 0x5068, 0xe07, addq_instruction<W, disp_indirect>::execute, addq_instruction<W, disp_indirect>::text, 0 },
+      { 0x5070, 0xe07, addq_instruction<W, index_indirect>::execute, addq_instruction<W, index_indirect>::text, 0 },
+      { 0x5078, 0xe00, addq_instruction<W, abs_short>::execute, addq_instruction<W, abs_short>::text, 0 },
+      { 0x5079, 0xe00, addq_instruction<W, abs_long>::execute, addq_instruction<W, abs_long>::text, 0 },
+      { 0x5080, 0xe07, addq_instruction<L, d_reg_direct>::execute, addq_instruction<L, d_reg_direct>::text, 0 },
+      { 0x5088, 0xe07, addqa_instruction::execute, addqa_instruction::text, 0 },
+      { 0x5090, 0xe07, addq_instruction<L, indirect>::execute, addq_instruction<L, indirect>::text, 0 },
+      { 0x5098, 0xe07, addq_instruction<L, postinc_indirect>::execute, addq_instruction<L, postinc_indirect>::text, 0 },
+      { 0x50a0, 0xe07, addq_instruction<L, predec_indirect>::execute, addq_instruction<L, predec_indirect>::text, 0 },
+      { 0x50a8, 0xe07, addq_instruction<L, disp_indirect>::execute, addq_instruction<L, disp_indirect>::text, 0 },
+      { 0x50b0, 0xe07, addq_instruction<L, index_indirect>::execute, addq_instruction<L, index_indirect>::text, 0 },
+      { 0x50b8, 0xe00, addq_instruction<L, abs_short>::execute, addq_instruction<L, abs_short>::text, 0 },
+      { 0x50b9, 0xe00, addq_instruction<L, abs_long>::execute, addq_instruction<L, abs_long>::text, 0 },
+      { 0x50c8,     7, dbcc_instruction<CC_T>::execute, dbcc_instruction<CC_T>::text, dbcc_instruction<CC_T>::flow },
+      { 0x5100, 0xe07, subq_instruction<B, d_reg_direct>::execute, subq_instruction<B, d_reg_direct>::text, 0 },
+      { 0x5110, 0xe07, subq_instruction<B, indirect>::execute, subq_instruction<B, indirect>::text, 0 },
+      { 0x5118, 0xe07, subq_instruction<B, postinc_indirect>::execute, subq_instruction<B, postinc_indirect>::text, 0 },
+      { 0x5120, 0xe07, subq_instruction<B, predec_indirect>::execute, subq_instruction<B, predec_indirect>::text, 0 },
+      { 0x5128, 0xe07, subq_instruction<B, disp_indirect>::execute, subq_instruction<B, disp_indirect>::text, 0 },
+      { 0x5130, 0xe07, subq_instruction<B, index_indirect>::execute, subq_instruction<B, index_indirect>::text, 0 },
+      { 0x5138, 0xe00, subq_instruction<B, abs_short>::execute, subq_instruction<B, abs_short>::text, 0 },
+      { 0x5139, 0xe00, subq_instruction<B, abs_long>::execute, subq_instruction<B, abs_long>::text, 0 },
+      { 0x5140, 0xe07, subq_instruction<W, d_reg_direct>::execute, subq_instruction<W, d_reg_direct>::text, 0 },
+      { 0x5148, 0xe07, subqa_instruction::execute, subqa_instruction::text, 0 },
+      { 0x5150, 0xe07, subq_instruction<W, indirect>::execute, subq_instruction<W, indirect>::text, 0 },
+      { 0x5158, 0xe07, subq_instruction<W, postinc_indirect>::execute, subq_instruction<W, postinc_indirect>::text, 0 },
+      { 0x5160, 0xe07, subq_instruction<W, predec_indirect>::execute, subq_instruction<W, predec_indirect>::text, 0 },
+      { 0x5168, 0xe07, subq_instruction<W, disp_indirect>::execute, subq_instruction<W, disp_indirect>::text, 0 },
+      { 0x5170, 0xe07, subq_instruction<W, index_indirect>::execute, subq_instruction<W, index_indirect>::text, 0 },
+      { 0x5178, 0xe00, subq_instruction<W, abs_short>::execute, subq_instruction<W, abs_short>::text, 0 },
+      { 0x5179, 0xe00, subq_instruction<W, abs_long>::execute, subq_instruction<W, abs_long>::text, 0 },
+      { 0x5180, 0xe07, subq_instruction<L, d_reg_direct>::execute, subq_instruction<L, d_reg_direct>::text, 0 },
+      { 0x5188, 0xe07, subqa_instruction::execute, subqa_instruction::text, 0 },
+      { 0x5190, 0xe07, subq_instruction<L, indirect>::execute, subq_instruction<L, indirect>::text, 0 },
+      { 0x5198, 0xe07, subq_instruction<L, postinc_indirect>::execute, subq_instruction<L, postinc_indirect>::text, 0 },
+      { 0x51a0, 0xe07, subq_instruction<L, predec_indirect>::execute, subq_instruction<L, predec_indirect>::text, 0 },
+      { 0x51a8, 0xe07, subq_instruction<L, disp_indirect>::execute, subq_instruction<L, disp_indirect>::text, 0 },
+      { 0x51b0, 0xe07, subq_instruction<L, index_indirect>::execute, subq_instruction<L, index_indirect>::text, 0 },
+      { 0x51b8, 0xe00, subq_instruction<L, abs_short>::execute, subq_instruction<L, abs_short>::text, 0 },
+      { 0x51b9, 0xe00, subq_instruction<L, abs_long>::execute, subq_instruction<L, abs_long>::text, 0 },
+      { 0x51c8,     7, dbcc_instruction<CC_F>::execute, dbcc_instruction<CC_F>::text, dbcc_instruction<CC_F>::flow },
+      { 0x52c8,     7, dbcc_instruction<CC_HI>::execute, dbcc_instruction<CC_HI>::text, dbcc_instruction<CC_HI>::flow },
+      { 0x53c8,     7, dbcc_instruction<CC_LS>::execute, dbcc_instruction<CC_LS>::text, dbcc_instruction<CC_LS>::flow },
+      { 0x54c8,     7, dbcc_instruction<CC_CC>::execute, dbcc_instruction<CC_CC>::text, dbcc_instruction<CC_CC>::flow },
+      { 0x55c8,     7, dbcc_instruction<CC_CS>::execute, dbcc_instruction<CC_CS>::text, dbcc_instruction<CC_CS>::flow },
+      { 0x56c8,     7, dbcc_instruction<CC_NE>::execute, dbcc_instruction<CC_NE>::text, dbcc_instruction<CC_NE>::flow },
+      { 0x57c8,     7, dbcc_instruction<CC_EQ>::execute, dbcc_instruction<CC_EQ>::text, dbcc_instruction<CC_EQ>::flow },
+      { 0x58c8,     7, dbcc_instruction<CC_VC>::execute, dbcc_instruction<CC_VC>::text, dbcc_instruction<CC_VC>::flow },
+      { 0x59c8,     7, dbcc_instruction<CC_VS>::execute, dbcc_instruction<CC_VS>::text, dbcc_instruction<CC_VS>::flow },
+      { 0x5ac8,     7, dbcc_instruction<CC_PL>::execute, dbcc_instruction<CC_PL>::text, dbcc_instruction<CC_PL>::flow },
+      { 0x5bc8,     7, dbcc_instruction<CC_MI>::execute, dbcc_instruction<CC_MI>::text, dbcc_instruction<CC_MI>::flow },
+      { 0x5cc8,     7, dbcc_instruction<CC_GE>::execute, dbcc_instruction<CC_GE>::text, dbcc_instruction<CC_GE>::flow },
+      { 0x5dc8,     7, dbcc_instruction<CC_LT>::execute, dbcc_instruction<CC_LT>::text, dbcc_instruction<CC_LT>::flow },
+      { 0x5ec8,     7, dbcc_instruction<CC_GT>::execute, dbcc_instruction<CC_GT>::text, dbcc_instruction<CC_GT>::flow },
+      { 0x5fc8,     7, dbcc_instruction<CC_LE>::execute, dbcc_instruction<CC_LE>::text, dbcc_instruction<CC_LE>::flow },
+    };
+}
+
+namespace vx68k
+{
+  void vm68k_instruction_decoder::insert_inst5 (vm68k_instruction_decoder *p)
+  {
+    assert (p != NULL);
+    p->insert (inst5 + 0, inst5 + sizeof inst5 / sizeof inst5[0]);
+  }
+
+  void vm68k_disassembler::insert_inst5 (vm68k_disassembler *p)
+  {
+    assert (p != NULL);
+    p->insert (inst5 + 0, inst5 + sizeof inst5 / sizeof inst5[0]);
+  }
+}
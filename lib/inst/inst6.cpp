@@ -0,0 +1,80 @@
+/* inst6 - instruction group 6 for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/processor>
+#include <vm68k/disasm>
+
+#include "branch.h"
+
+#include <cassert>
+
+using namespace vx68k;
+using namespace vx68k_m68k;
+
+namespace
+{
+  static const vm68k_instruction_decoder::spec inst6[] =
+    {
+      { 0x6000,  0xff, bcc_instruction<CC_T>::execute, bcc_instruction<CC_T>::text, bcc_instruction<CC_T>::flow },
+      { 0x6100,  0xff, bsr_instruction::execute, bsr_instruction::text, bsr_instruction::flow },
+      { 0x6200,  0xff, bcc_instruction<CC_HI>::execute, bcc_instruction<CC_HI>::text, bcc_instruction<CC_HI>::flow },
+      { 0x6300,  0xff, bcc_instruction<CC_LS>::execute, bcc_instruction<CC_LS>::text, bcc_instruction<CC_LS>::flow },
+      { 0x6400,  0xff, bcc_instruction<CC_CC>::execute, bcc_instruction<CC_CC>::text, bcc_instruction<CC_CC>::flow },
+      { 0x6500,  0xff, bcc_instruction<CC_CS>::execute, bcc_instruction<CC_CS>::text, bcc_instruction<CC_CS>::flow },
+      { 0x6600,  0xff, bcc_instruction<CC_NE>::execute, bcc_instruction<CC_NE>::text, bcc_instruction<CC_NE>::flow },
+      { 0x6700,  0xff, bcc_instruction<CC_EQ>::execute, bcc_instruction<CC_EQ>::text, bcc_instruction<CC_EQ>::flow },
+      { 0x6800,  0xff, bcc_instruction<CC_VC>::execute, bcc_instruction<CC_VC>::text, bcc_instruction<CC_VC>::flow },
+      { 0x6900,  0xff, bcc_instruction<CC_VS>::execute, bcc_instruction<CC_VS>::text, bcc_instruction<CC_VS>::flow },
+      { 0x6a00,  0xff, bcc_instruction<CC_PL>::execute, bcc_instruction<CC_PL>::text, bcc_instruction<CC_PL>::flow },
+      { 0x6b00,  0xff, bcc_instruction<CC_MI>::execute, bcc_instruction<CC_MI>::text, bcc_instruction<CC_MI>::flow },
+      { 0x6c00,  0xff, bcc_instruction<CC_GE>::execute, bcc_instruction<CC_GE>::text, bcc_instruction<CC_GE>::flow },
+      { 0x6d00,  0xff, bcc_instruction<CC_LT>::execute, bcc_instruction<CC_LT>::text, bcc_instruction<CC_LT>::flow },
+      { 0x6e00,  0xff, bcc_instruction<CC_GT>::execute, bcc_instruction<CC_GT>::text, bcc_instruction<CC_GT>::flow },
+      { 0x6f00,  0xff, bcc_instruction<CC_LE>::execute, bcc_instruction<CC_LE>::text, bcc_instruction<CC_LE>::flow },
+    };
+}
+
+namespace vx68k
+{
+  void vm68k_instruction_decoder::insert_inst6 (vm68k_instruction_decoder *p)
+  {
+    assert (p != NULL);
+    p->insert (inst6 + 0, inst6 + sizeof inst6 / sizeof inst6[0]);
+  }
+
+  void vm68k_disassembler::insert_inst6 (vm68k_disassembler *p)
+  {
+    assert (p != NULL);
+    p->insert (inst6 + 0, inst6 + sizeof inst6 / sizeof inst6[0]);
+  }
+}
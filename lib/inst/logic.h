@@ -22,6 +22,7 @@
 
 #include <vm68k/context>
 #include "addressing.h"
+#include "flags.h"
 
 #include <cassert>
 
@@ -30,7 +31,7 @@ namespace vx68k_m68k
   /**
    * Handles an ANDI instruction.
    */
-  template<class Size, template<class Size> class D>
+  template<class Size, template<class> class D, class Flags = all_flags>
   struct andi_instruction
   {
     static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
@@ -43,9 +44,17 @@ namespace vx68k_m68k
       D<Size> ea1 (w & 7, pc + Size::aligned_data_size ());
 
       udata_type v1 = ea1.get (c);
+      if (c->fault_pending ())
+        {
+          return pc;
+        }
       udata_type v = v1 & v2;
       ea1.put (c, v);
-      c->_status.set_cc (v);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
+      Flags::set_cc (c, v);
 
       ea1.finish (c);
       return pc + Size::aligned_data_size () + D<Size>::extension_size ();
@@ -64,6 +73,10 @@ namespace vx68k_m68k
       assert (c != NULL);
 
       udata_type v2 = c->fetch_unsigned (vm68k_data_size::BYTE, pc);
+      if (c->fault_pending ())
+        {
+          return pc;
+        }
 
       udata_type v1 = c->_status & 0xff;
       udata_type v = v1 & v2;
@@ -85,6 +98,10 @@ namespace vx68k_m68k
       assert (c != NULL);
 
       udata_type v2 = c->fetch_unsigned (vm68k_data_size::WORD, pc);
+      if (c->fault_pending ())
+        {
+          return pc;
+        }
 
       // This instruction is privileged.
       if (!c->super ())
@@ -103,7 +120,7 @@ namespace vx68k_m68k
   /**
    * Handles an EORI instruction.
    */
-  template<class Size, template<class Size> class D>
+  template<class Size, template<class> class D, class Flags = all_flags>
   struct eori_instruction
   {
     static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
@@ -116,9 +133,17 @@ namespace vx68k_m68k
       D<Size> ea1 (w & 7, pc + Size::aligned_data_size ());
 
       udata_type v1 = ea1.get (c);
+      if (c->fault_pending ())
+        {
+          return pc;
+        }
       udata_type v = v1 ^ v2;
       ea1.put (c, v);
-      c->_status.set_cc (v);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
+      Flags::set_cc (c, v);
 
       ea1.finish (c);
       return pc + Size::aligned_data_size () + D<Size>::extension_size ();
@@ -128,7 +153,7 @@ namespace vx68k_m68k
   /**
    * Handles an ORI instruction.
    */
-  template<class Size, template<class Size> class D>
+  template<class Size, template<class> class D, class Flags = all_flags>
   struct ori_instruction
   {
     static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
@@ -141,9 +166,17 @@ namespace vx68k_m68k
       D<Size> ea1 (w & 7, pc + Size::aligned_data_size ());
 
       udata_type v1 = ea1.get (c);
+      if (c->fault_pending ())
+        {
+          return pc;
+        }
       udata_type v = v1 | v2;
       ea1.put (c, v);
-      c->_status.set_cc (v);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
+      Flags::set_cc (c, v);
 
       ea1.finish (c);
       return pc + Size::aligned_data_size () + D<Size>::extension_size ();
@@ -162,6 +195,10 @@ namespace vx68k_m68k
       assert (c != NULL);
 
       udata_type v2 = c->fetch_unsigned (vm68k_data_size::BYTE, pc);
+      if (c->fault_pending ())
+        {
+          return pc;
+        }
 
       udata_type v1 = c->_status & 0xff;
       udata_type v = v1 | v2;
@@ -183,6 +220,10 @@ namespace vx68k_m68k
       assert (c != NULL);
 
       udata_type v2 = c->fetch_unsigned (vm68k_data_size::WORD, pc);
+      if (c->fault_pending ())
+        {
+          return pc;
+        }
 
       // This instruction is privileged.
       if (!c->super ())
@@ -0,0 +1,143 @@
+/* special - specialized handlers for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/processor>
+
+#include "branch.h"
+#include "transfer.h"
+#include "arith.h"
+
+#include <cassert>
+
+using namespace vx68k;
+using namespace vx68k_m68k;
+
+namespace
+{
+  /* Handler Inst for the fixed operation word CODE.  The register
+     numbers and other fields of the word fold into constants, so that
+     register accesses take fixed offsets in the context.  */
+  template<class Inst, uint_least16_t Code>
+  struct fixed_word
+  {
+    static vm68k_address_t execute (vm68k_address_t pc, vx68k::uint_fast16_t,
+                                    vm68k_context *c)
+    {
+      return Inst::execute (pc, Code, c);
+    }
+  };
+
+#if ENABLE_SPECIAL_HANDLERS
+  typedef vm68k_byte B;
+  typedef vm68k_word W;
+  typedef vm68k_long_word L;
+
+  typedef move_instruction<B, postinc_indirect, d_reg_direct> move_b_pi_d;
+  typedef move_instruction<W, postinc_indirect, d_reg_direct> move_w_pi_d;
+  typedef move_instruction<L, d_reg_direct, d_reg_direct> move_l_d_d;
+  typedef move_instruction<L, postinc_indirect, d_reg_direct> move_l_pi_d;
+  typedef move_instruction<L, d_reg_direct, postinc_indirect> move_l_d_pi;
+  typedef move_instruction<L, postinc_indirect, postinc_indirect>
+    move_l_pi_pi;
+  typedef addq_instruction<W, d_reg_direct> addq_w_d;
+  typedef addq_instruction<L, d_reg_direct> addq_l_d;
+  typedef subq_instruction<L, d_reg_direct> subq_l_d;
+  typedef cmp_instruction<W, d_reg_direct> cmp_w_d;
+  typedef cmp_instruction<L, d_reg_direct> cmp_l_d;
+  typedef tst_instruction<W, d_reg_direct> tst_w_d;
+  typedef tst_instruction<L, d_reg_direct> tst_l_d;
+  typedef bcc_instruction<CC_T> bra;
+  typedef bcc_instruction<CC_NE> bne;
+  typedef bcc_instruction<CC_EQ> beq;
+
+  /* Operation words to specialize.  This list is edited by hand and is
+     not generated: each entry adds a handler, so keep it short and take
+     the words from the top of the counts that vm68k-trace -c reports
+     for the workloads.  */
+  const struct
+  {
+    uint_least16_t code;
+    vm68k_instruction::function generic;
+    vm68k_instruction::function func;
+  } special[] =
+    {
+      { 0x1018, move_b_pi_d::execute,
+        fixed_word<move_b_pi_d, 0x1018>::execute },
+      { 0x3018, move_w_pi_d::execute,
+        fixed_word<move_w_pi_d, 0x3018>::execute },
+      { 0x2200, move_l_d_d::execute,
+        fixed_word<move_l_d_d, 0x2200>::execute },
+      { 0x2018, move_l_pi_d::execute,
+        fixed_word<move_l_pi_d, 0x2018>::execute },
+      { 0x20c0, move_l_d_pi::execute,
+        fixed_word<move_l_d_pi, 0x20c0>::execute },
+      { 0x22d8, move_l_pi_pi::execute,
+        fixed_word<move_l_pi_pi, 0x22d8>::execute },
+      { 0x5240, addq_w_d::execute,
+        fixed_word<addq_w_d, 0x5240>::execute },
+      { 0x5280, addq_l_d::execute,
+        fixed_word<addq_l_d, 0x5280>::execute },
+      { 0x5380, subq_l_d::execute,
+        fixed_word<subq_l_d, 0x5380>::execute },
+      { 0xb041, cmp_w_d::execute,
+        fixed_word<cmp_w_d, 0xb041>::execute },
+      { 0xb081, cmp_l_d::execute,
+        fixed_word<cmp_l_d, 0xb081>::execute },
+      { 0x4a40, tst_w_d::execute,
+        fixed_word<tst_w_d, 0x4a40>::execute },
+      { 0x4a80, tst_l_d::execute,
+        fixed_word<tst_l_d, 0x4a80>::execute },
+      { 0x6000, bra::execute,
+        fixed_word<bra, 0x6000>::execute },
+      { 0x6600, bne::execute,
+        fixed_word<bne, 0x6600>::execute },
+      { 0x6700, beq::execute,
+        fixed_word<beq, 0x6700>::execute },
+    };
+#endif
+}
+
+namespace vx68k
+{
+  void
+  vm68k_instruction_decoder::insert_special (vm68k_instruction_decoder *p)
+  {
+    assert (p != NULL);
+#if ENABLE_SPECIAL_HANDLERS
+    for (std::size_t i = 0; i != sizeof special / sizeof special[0]; ++i)
+      {
+        p->specialize (special[i].code, special[i].generic, special[i].func);
+      }
+#endif
+  }
+}
@@ -0,0 +1,138 @@
+/* -*-c++-*-
+ * text - instruction text writers for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INST_TEXT_H
+#define INST_TEXT_H 1
+
+#include <vm68k/disasm>
+
+namespace vx68k_m68k
+{
+  using namespace vx68k;
+  using vx68k::int_fast32_t;    // avoid ambiguity
+  using vx68k::uint_fast16_t;
+  using vx68k::uint_fast32_t;
+
+  /* Writes string S to P.  Returns the end of the text.  */
+  inline char *write_string (char *p, const char *s)
+  {
+    while (*s != '\0')
+      {
+        *p++ = *s++;
+      }
+    return p;
+  }
+
+  /* Writes V in hexadecimal with the 0x prefix.  */
+  inline char *write_hex (char *p, uint_fast32_t v)
+  {
+    static const char digits[] = "0123456789abcdef";
+
+    *p++ = '0';
+    *p++ = 'x';
+    int shift = 28;
+    while (shift > 0 && (v >> shift & 0xfU) == 0)
+      {
+        shift -= 4;
+      }
+    for (; shift >= 0; shift -= 4)
+      {
+        *p++ = digits[v >> shift & 0xfU];
+      }
+    return p;
+  }
+
+  /* Writes V in signed decimal.  */
+  inline char *write_decimal (char *p, int_fast32_t v)
+  {
+    uint_fast32_t u = v;
+    if (v < 0)
+      {
+        *p++ = '-';
+        u = -u;
+      }
+    char buf[10];
+    char *q = buf;
+    do
+      {
+        *q++ = '0' + u % 10;
+        u /= 10;
+      }
+    while (u != 0);
+    while (q != buf)
+      {
+        *p++ = *--q;
+      }
+    return p;
+  }
+
+  /* Writes register REGNO as %d0 through %a7.  */
+  inline char *write_reg (char *p, int regno)
+  {
+    *p++ = '%';
+    *p++ = regno >= vm68k_context::A0 ? 'a' : 'd';
+    *p++ = '0' + (regno & 7);
+    return p;
+  }
+
+  /* Writes the mnemonic MNEMONIC with the suffix of Size and a
+     space.  */
+  template<class Size>
+  inline char *write_mnemonic (char *p, const char *mnemonic)
+  {
+    p = write_string (p, mnemonic);
+    p = write_string (p, Size::suffix ());
+    *p++ = ' ';
+    return p;
+  }
+
+  /* Writes the quick data in bits 11-9 of operation word W, which
+     stands for 1 through 8.  */
+  inline char *write_quick (char *p, uint_fast16_t w)
+  {
+    *p++ = '#';
+    *p++ = '0' + ((((w >> 9) - 1) & 7) + 1);
+    return p;
+  }
+
+  /* Writes an index extension word W of an indexed address, such as
+     (4,%d1:w).  */
+  inline char *write_index (char *p, uint_fast16_t w)
+  {
+    *p++ = '(';
+    p = write_decimal (p, vm68k_byte::as_signed (w & 0xffU));
+    *p++ = ',';
+    p = write_reg (p, w >> 12 & 0xf);
+    *p++ = ':';
+    *p++ = (w & 0x800) != 0 ? 'l' : 'w';
+    *p++ = ')';
+    return p;
+  }
+
+  /* Writes the name of condition COND as in Bcc.  */
+  inline char *write_condition (char *p, int cond)
+  {
+    static const char names[16][3] = {
+      "t",  "f",  "hi", "ls", "cc", "cs", "ne", "eq",
+      "vc", "vs", "pl", "mi", "ge", "lt", "gt", "le"
+    };
+    return write_string (p, names[cond & 0xf]);
+  }
+}
+
+#endif
@@ -21,6 +21,7 @@
 
 #include <vm68k/context>
 #include "addressing.h"
+#include "flags.h"
 
 #include <cassert>
 
@@ -29,7 +30,8 @@ namespace vx68k_m68k
   /**
    * Handles a MOVE instruction.
    */
-  template<class Size, template<class Size> class S, template<class Size> class D>
+  template<class Size, template<class> class S, template<class> class D,
+           class Flags = all_flags>
   struct move_instruction
   {
     static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
@@ -42,19 +44,40 @@ namespace vx68k_m68k
       D<Size> ea2 (w >> 9 & 7, pc + S<Size>::extension_size ());
 
       data_type v = ea1.get (c);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
       ea2.put (c, v);
-      c->_status.set_cc (v);
+      if (ea2.faulted (c))
+        {
+          return pc;
+        }
+      Flags::set_cc (c, v);
 
       ea1.finish (c);
       ea2.finish (c);
       return pc + S<Size>::extension_size () + D<Size>::extension_size ();
     }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &code, char *&p)
+    {
+      S<Size> ea1 (w & 7, pc);
+      D<Size> ea2 (w >> 9 & 7, pc + S<Size>::extension_size ());
+
+      p = write_mnemonic<Size> (p, "move");
+      p = ea1.text (code, p);
+      *p++ = ',';
+      p = ea2.text (code, p);
+      return pc + S<Size>::extension_size () + D<Size>::extension_size ();
+    }
   };
 
   /**
    * Handles a MOVEA instruction.  This instruction does not change CCR.
    */
-  template<class Size, template<class Size> class S>
+  template<class Size, template<class> class S>
   struct movea_instruction
   {
     static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
@@ -67,17 +90,33 @@ namespace vx68k_m68k
       int r2 = w >> 9 & 7;
 
       data_type v = ea1.get (c);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
       c->write_reg (vm68k_data_size::LONG_WORD, vm68k_context::A0 + r2, v);
 
       ea1.finish (c);
       return pc + S<Size>::extension_size ();
     }
+
+    static vm68k_address_t text (vm68k_address_t pc, uint_fast16_t w,
+                                 const vm68k_code_image &code, char *&p)
+    {
+      S<Size> ea1 (w & 7, pc);
+
+      p = write_mnemonic<Size> (p, "movea");
+      p = ea1.text (code, p);
+      *p++ = ',';
+      p = write_reg (p, vm68k_context::A0 + (w >> 9 & 7));
+      return pc + S<Size>::extension_size ();
+    }
   };
 
   /**
    * Handles a LEA instruction.  This instruction does not change CCR.
    */
-  template<template<class Size> class S>
+  template<template<class> class S>
   struct lea_instruction
   {
     static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
@@ -89,6 +128,10 @@ namespace vx68k_m68k
       int r2 = w >> 9 & 7;
 
       vm68k_address_t a = ea1.address (c);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
       c->write_reg (vm68k_data_size::LONG_WORD, vm68k_context::A0 + r2, a);
 
       return pc + S<vm68k_word>::extension_size ();
@@ -98,7 +141,7 @@ namespace vx68k_m68k
   /**
    * Handles a PEA instruction.  This instruction does not change CCR.
    */
-  template<template<class Size> class S>
+  template<template<class> class S>
   struct pea_instruction
   {
     static vm68k_address_t execute (vm68k_address_t pc, uint_fast16_t w,
@@ -109,6 +152,10 @@ namespace vx68k_m68k
       S<vm68k_word> ea1 (w & 7, pc);
 
       vm68k_address_t a = ea1.address (c);
+      if (ea1.faulted (c))
+        {
+          return pc;
+        }
       c->push (vm68k_data_size::LONG_WORD, a);
 
       return pc + S<vm68k_word>::extension_size ();
@@ -0,0 +1,555 @@
+/* Virtual M68000 Toolkit
+   Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307
+   USA.  */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/journal>
+
+#include <cstring>
+#include <cassert>
+
+using std::FILE;
+using std::size_t;
+using std::vector;
+
+namespace
+{
+  using namespace vx68k;
+
+  /* Magic bytes at the start of a journal file.  */
+  const char JOURNAL_MAGIC[8] = {'V', 'M', '6', '8', 'K', 'J', 'N', '1'};
+
+  /* Writes X in seven bits a byte, with the high bit set on all but
+     the last byte.  */
+  bool write_number (FILE *stream, unsigned long long x)
+  {
+    while (x >= 0x80U)
+      {
+        if (std::putc ((int) (x & 0x7fU) | 0x80, stream) == EOF)
+          {
+            return false;
+          }
+        x >>= 7;
+      }
+    return std::putc ((int) x, stream) != EOF;
+  }
+
+  bool read_number (FILE *stream, unsigned long long &x)
+  {
+    x = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+      {
+        int c = std::getc (stream);
+        if (c == EOF)
+          {
+            return false;
+          }
+        x |= (unsigned long long) (c & 0x7f) << shift;
+        if ((c & 0x80) == 0)
+          {
+            return true;
+          }
+      }
+    return false;
+  }
+}
+
+namespace vx68k
+{
+  /* Filter that records or replays the reads from a device page.  */
+  class vm68k_journal::device_filter : public vm68k_bus::filter
+  {
+  public:
+    device_filter (vm68k_journal *journal, vm68k_bus *bus,
+                   vm68k_bus::function_code func, vm68k_address_t addr)
+    {
+      _journal = journal;
+      _bus = bus;
+      _func = func;
+      _address = addr;
+    }
+
+  public:
+    vm68k_bus *bus () const
+    {
+      return _bus;
+    }
+
+    vm68k_bus::function_code func () const
+    {
+      return _func;
+    }
+
+    vm68k_address_t address () const
+    {
+      return _address;
+    }
+
+  public:
+    uint_fast8_t read8 (vm68k_bus::function_code func,
+                        vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      return _journal->read (this->next (), func, addr, 1);
+    }
+
+    uint_fast16_t read16 (vm68k_bus::function_code func,
+                          vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      return _journal->read (this->next (), func, addr, 2);
+    }
+
+    uint_fast32_t read32 (vm68k_bus::function_code func,
+                          vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      return _journal->read (this->next (), func, addr, 4);
+    }
+
+  private:
+    vm68k_journal *_journal;
+    vm68k_bus *_bus;
+    vm68k_bus::function_code _func;
+    vm68k_address_t _address;
+  };
+
+  vm68k_journal::vm68k_journal ()
+    : _stores (HOST_STORE_MAX, vm68k_trace_buffer::STORES)
+  {
+    this->start_recording ();
+  }
+
+  vm68k_journal::~vm68k_journal ()
+  {
+    this->remove_devices ();
+  }
+
+  void vm68k_journal::start_recording ()
+  {
+    _mode = RECORDING;
+    _events.clear ();
+    _next = 0;
+    _count = 0;
+    _next_interrupt = ~0ULL;
+    _diverged = false;
+    _rewound = false;
+  }
+
+  void vm68k_journal::start_replay ()
+  {
+    _mode = REPLAYING;
+    _next = 0;
+    _count = 0;
+    _diverged = false;
+    _rewound = false;
+    this->find_next_interrupt ();
+  }
+
+  void vm68k_journal::rewind (vector<event>::size_type position,
+                              unsigned long long count)
+  {
+    assert (position <= _events.size ());
+    if (_mode == RECORDING)
+      {
+        _rewound = true;
+        _end = _count;
+      }
+
+    _mode = REPLAYING;
+    _next = position;
+    _count = count;
+    _diverged = false;
+    this->find_next_interrupt ();
+  }
+
+  void vm68k_journal::add_device (vm68k_bus *bus, int func_mask,
+                                  vm68k_address_t addr, uint_fast32_t size)
+  {
+    if (size == 0)
+      {
+        return;
+      }
+
+    vm68k_address_t first = addr & ~(PAGE_SIZE - 1);
+    vm68k_address_t last = (addr + (size - 1)) & ~(PAGE_SIZE - 1);
+    for (int func = 0; func != 7; func_mask >>= 1, ++func)
+      {
+        if ((func_mask & 1U) == 0)
+          {
+            continue;
+          }
+
+        vm68k_address_t page = first;
+        for (;;)
+          {
+            device_filter *f =
+              new device_filter (this, bus, (vm68k_bus::function_code) func,
+                                 page);
+            _filters.push_back (f);
+            bus->attach_filter ((vm68k_bus::function_code) func, page, f);
+            if (page == last)
+              {
+                break;
+              }
+            page += PAGE_SIZE;
+          }
+      }
+  }
+
+  void vm68k_journal::remove_devices ()
+  {
+    for (vector<device_filter *>::iterator i = _filters.begin ();
+         i != _filters.end (); ++i)
+      {
+        (*i)->bus ()->detach_filter ((*i)->func (), (*i)->address (), *i);
+        delete *i;
+      }
+    _filters.clear ();
+  }
+
+  uint_fast32_t vm68k_journal::read (const vm68k_bus::mappable *device,
+                                     vm68k_bus::function_code func,
+                                     vm68k_address_t addr, int size)
+  {
+    if (_mode == REPLAYING)
+      {
+        if (_next != _events.size ())
+          {
+            const event &e = _events[_next];
+            if ((e.kind == READ || e.kind == READ_ERROR)
+                && e.address == addr && e.size == size)
+              {
+                ++_next;
+                if (e.kind == READ_ERROR)
+                  {
+                    throw vm68k_bus_error (vm68k_bus::READ | func, addr);
+                  }
+                return e.value;
+              }
+          }
+
+        // The device is read as a last resort.
+        _diverged = true;
+      }
+
+    uint_fast32_t value;
+    try
+      {
+        switch (size)
+          {
+          case 1:
+            value = device->read8 (func, addr);
+            break;
+          case 2:
+            value = device->read16 (func, addr);
+            break;
+          default:
+            value = device->read32 (func, addr);
+            break;
+          }
+      }
+    catch (const vm68k_bus_error &)
+      {
+        if (_mode == RECORDING)
+          {
+            this->append (READ_ERROR, size, addr, 0);
+          }
+        throw;
+      }
+
+    if (_mode == RECORDING)
+      {
+        this->append (READ, size, addr, value);
+      }
+    return value;
+  }
+
+  const vm68k_journal::event *vm68k_journal::next_event (int kind)
+  {
+    if (_next == _events.size () || _events[_next].kind != kind)
+      {
+        _diverged = true;
+        return NULL;
+      }
+    return &_events[_next++];
+  }
+
+  void vm68k_journal::find_next_interrupt ()
+  {
+    _next_interrupt = _rewound ? _end : ~0ULL;
+    for (vector<event>::size_type i = _next; i != _events.size (); ++i)
+      {
+        if (_events[i].kind == INTERRUPT)
+          {
+            _next_interrupt = _events[i].count;
+            break;
+          }
+      }
+  }
+
+  void vm68k_journal::deliver_interrupts (vm68k_context &c)
+  {
+    while (_next_interrupt == _count)
+      {
+        // Events before the interrupt that were not replayed are
+        // skipped.
+        while (_next != _events.size ()
+               && _events[_next].kind != INTERRUPT)
+          {
+            _diverged = true;
+            ++_next;
+          }
+        if (_next == _events.size ())
+          {
+            // The replay has caught up with the rewound recording.
+            _mode = RECORDING;
+            _rewound = false;
+            _next_interrupt = ~0ULL;
+            return;
+          }
+
+        const event &e = _events[_next++];
+        c.queue_interrupt (e.address, e.value);
+        this->find_next_interrupt ();
+      }
+  }
+
+  vm68k_address_t vm68k_journal::call_host (vm68k_host_call &call,
+                                            vm68k_address_t pc,
+                                            uint_fast16_t w,
+                                            vm68k_context &c)
+  {
+    if (_mode == REPLAYING)
+      {
+        if (_next != _events.size () && _events[_next].kind == HOST_LOST)
+          {
+            // The effects were not recorded in full, so the host
+            // function is called again.  Its reads from devices are
+            // replayed as they are made.
+            ++_next;
+            _diverged = true;
+            vm68k_address_t next = call (pc, w, c);
+            while (_next != _events.size ()
+                   && _events[_next++].kind != HOST_RETURN)
+              {
+              }
+            return next;
+          }
+
+        // Replays the stores and the register changes up to the return
+        // address.
+        while (_next != _events.size ())
+          {
+            const event &e = _events[_next];
+            if (e.kind == READ || e.kind == READ_ERROR)
+              {
+                // The host function made the read, and it is not
+                // called.
+              }
+            else if (e.kind == HOST_STORE)
+              {
+                switch (e.size)
+                  {
+                  case 1:
+                    c.store (vm68k_data_size::BYTE, e.address, e.value);
+                    break;
+                  case 2:
+                    c.store (vm68k_data_size::WORD, e.address, e.value);
+                    break;
+                  default:
+                    c.store (vm68k_data_size::LONG_WORD, e.address,
+                             e.value);
+                    break;
+                  }
+              }
+            else if (e.kind == HOST_REGISTER)
+              {
+                if (e.address == vm68k_trace_record::REGISTER_SR)
+                  {
+                    c.set_status (e.value);
+                  }
+                else
+                  {
+                    c.write_reg (vm68k_data_size::LONG_WORD, e.address,
+                                 e.value);
+                  }
+              }
+            else if (e.kind == HOST_RETURN)
+              {
+                ++_next;
+                return e.value;
+              }
+            else
+              {
+                break;
+              }
+            ++_next;
+          }
+
+        // The host function is called as a last resort.
+        _diverged = true;
+        return call (pc, w, c);
+      }
+
+    uint_least32_t regs[vm68k_context::REGISTER_MAX];
+    for (int i = 0; i != vm68k_context::REGISTER_MAX; ++i)
+      {
+        regs[i] = c.read_reg_unsigned (vm68k_data_size::LONG_WORD, i);
+      }
+    uint_fast16_t status = c.status ();
+
+    // The stores are caught by tracing them to a buffer of the
+    // journal.  Reads from devices are recorded as they are made.
+    vector<event>::size_type first = _events.size ();
+    unsigned long lost = _stores.lost ();
+    vm68k_trace_buffer *trace = c.trace ();
+    c.set_trace (&_stores);
+    vm68k_address_t next;
+    try
+      {
+        next = call (pc, w, c);
+      }
+    catch (...)
+      {
+        c.set_trace (trace);
+        throw;
+      }
+    c.set_trace (trace);
+
+    vm68k_trace_record records[256];
+    size_t n;
+    vector<event>::size_type stores = _events.size ();
+    while ((n = _stores.read (records, 256)) != 0)
+      {
+        for (size_t i = 0; i != n; ++i)
+          {
+            this->append (HOST_STORE, records[i].size, records[i].address,
+                          records[i].value);
+          }
+      }
+    if (_stores.lost () != lost)
+      {
+        // The stores overflowed the buffer.  The call is marked so
+        // that it is made again when replayed.
+        _events.resize (stores);
+        event e;
+        e.count = _count;
+        e.address = 0;
+        e.value = _stores.lost () - lost;
+        e.kind = HOST_LOST;
+        e.size = 0;
+        _events.insert (_events.begin () + first, e);
+        this->append (HOST_RETURN, 4, 0, next);
+        return next;
+      }
+
+    for (int i = 0; i != vm68k_context::REGISTER_MAX; ++i)
+      {
+        uint_fast32_t value =
+          c.read_reg_unsigned (vm68k_data_size::LONG_WORD, i);
+        if (value != regs[i])
+          {
+            this->append (HOST_REGISTER, 4, i, value);
+          }
+      }
+    if (c.status () != status)
+      {
+        this->append (HOST_REGISTER, 2, vm68k_trace_record::REGISTER_SR,
+                      c.status ());
+      }
+    this->append (HOST_RETURN, 4, 0, next);
+    return next;
+  }
+
+  bool vm68k_journal::save (FILE *stream) const
+  {
+    if (std::fwrite (JOURNAL_MAGIC, sizeof JOURNAL_MAGIC, 1, stream) != 1)
+      {
+        return false;
+      }
+
+    // Each event takes a count delta, a byte of the kind and the size,
+    // the address and the value, all but the byte in variable length.
+    unsigned long long count = 0;
+    for (vector<event>::const_iterator i = _events.begin ();
+         i != _events.end (); ++i)
+      {
+        if (!write_number (stream, i->count - count)
+            || std::putc (i->kind << 4 | i->size, stream) == EOF
+            || !write_number (stream, i->address)
+            || !write_number (stream, i->value))
+          {
+            return false;
+          }
+        count = i->count;
+      }
+    return true;
+  }
+
+  bool vm68k_journal::load (FILE *stream)
+  {
+    this->start_recording ();
+
+    char magic[sizeof JOURNAL_MAGIC];
+    if (std::fread (magic, sizeof magic, 1, stream) != 1
+        || std::memcmp (magic, JOURNAL_MAGIC, sizeof magic) != 0)
+      {
+        return false;
+      }
+
+    unsigned long long count = 0;
+    unsigned long long delta;
+    while (read_number (stream, delta))
+      {
+        int kind_size = std::getc (stream);
+        unsigned long long address, value;
+        if (kind_size == EOF
+            || !read_number (stream, address)
+            || !read_number (stream, value))
+          {
+            _events.clear ();
+            return false;
+          }
+
+        count += delta;
+        event e;
+        e.count = count;
+        e.address = address;
+        e.value = value;
+        e.kind = kind_size >> 4;
+        e.size = kind_size & 0xf;
+        _events.push_back (e);
+      }
+    return std::feof (stream) != 0;
+  }
+}
@@ -0,0 +1,290 @@
+/* Virtual M68000 Toolkit
+   Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307
+   USA.  */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/perf>
+
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+#if HAVE_LINUX_PERF_EVENT_H
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using std::FILE;
+using std::fprintf;
+
+namespace
+{
+  using namespace vx68k;
+  using vx68k::uint_fast32_t;   // avoid ambiguity
+
+  /* Handler groups by the high four bits of the operation word.  */
+  const char *const group_names[vm68k_perf_profile::GROUP_MAX] = {
+    "bit/movep/immediate",
+    "move.b",
+    "move.l",
+    "move.w",
+    "miscellaneous",
+    "addq/subq/scc/dbcc",
+    "bcc/bsr/bra",
+    "moveq",
+    "or/div/sbcd",
+    "sub/subx",
+    "line a",
+    "cmp/eor",
+    "and/mul/abcd/exg",
+    "add/addx",
+    "shift/rotate",
+    "line f",
+  };
+
+#if HAVE_LINUX_PERF_EVENT_H
+  /* Opens a counter of the calling thread in group GROUP_FD.  */
+  int open_counter (uint_fast32_t type, __u64 config, int group_fd)
+  {
+    struct perf_event_attr attr;
+    std::memset (&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall (__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+  }
+#endif
+
+  /* Returns the ratio of X to N, or zero.  */
+  inline double ratio (unsigned long long x, unsigned long long n)
+  {
+    return n != 0 ? (double) x / n : 0.0;
+  }
+}
+
+namespace vx68k
+{
+  vm68k_perf_profile::vm68k_perf_profile ()
+  {
+    std::fill (_fds + 0, _fds + EVENT_MAX, -1);
+    std::fill (_index + 0, _index + EVENT_MAX, -1);
+    _nr = 0;
+    _group = -1;
+    _span = 0;
+    this->reset ();
+  }
+
+  vm68k_perf_profile::~vm68k_perf_profile ()
+  {
+    this->close ();
+  }
+
+  bool vm68k_perf_profile::open ()
+  {
+    this->close ();
+#if HAVE_LINUX_PERF_EVENT_H
+    const struct
+    {
+      uint_fast32_t type;
+      __u64 config;
+    } events[EVENT_MAX] = {
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+      {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+                           | PERF_COUNT_HW_CACHE_OP_READ << 8
+                           | PERF_COUNT_HW_CACHE_RESULT_MISS << 16},
+    };
+
+    // The cycle counter leads the group so that all the counters are
+    // read at once.
+    for (int e = 0; e != EVENT_MAX; ++e)
+      {
+        _fds[e] = open_counter (events[e].type, events[e].config,
+                                _fds[CYCLES]);
+        if (_fds[e] >= 0)
+          {
+            _index[e] = _nr++;
+          }
+        else if (e == CYCLES)
+          {
+            return false;
+          }
+      }
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  void vm68k_perf_profile::close ()
+  {
+#if HAVE_LINUX_PERF_EVENT_H
+    // The leader is closed last.
+    for (int e = EVENT_MAX; e-- != 0; )
+      {
+        if (_fds[e] >= 0)
+          {
+            ::close (_fds[e]);
+          }
+      }
+#endif
+    std::fill (_fds + 0, _fds + EVENT_MAX, -1);
+    std::fill (_index + 0, _index + EVENT_MAX, -1);
+    _nr = 0;
+    _group = -1;
+    _span = 0;
+  }
+
+  void vm68k_perf_profile::reset ()
+  {
+    std::fill (_count + 0, _count + GROUP_MAX, 0ULL);
+    for (int g = 0; g != GROUP_MAX; ++g)
+      {
+        std::fill (_values[g] + 0, _values[g] + EVENT_MAX, 0ULL);
+      }
+  }
+
+  bool vm68k_perf_profile::read (unsigned long long *v) const
+  {
+#if HAVE_LINUX_PERF_EVENT_H
+    if (_nr == 0)
+      {
+        return false;
+      }
+
+    __u64 buf[1 + EVENT_MAX];
+    ssize_t size = (1 + _nr) * sizeof buf[0];
+    if (::read (_fds[CYCLES], buf, size) != size || buf[0] != (__u64) _nr)
+      {
+        return false;
+      }
+
+    for (int e = 0; e != EVENT_MAX; ++e)
+      {
+        v[e] = _index[e] >= 0 ? buf[1 + _index[e]] : 0;
+      }
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  void vm68k_perf_profile::switch_group (int group)
+  {
+    if (_group < 0 && group < 0)
+      {
+        return;
+      }
+
+    unsigned long long v[EVENT_MAX];
+    if (!this->read (v))
+      {
+        // The instructions since the last read are dropped.
+        _group = -1;
+        _span = 0;
+        return;
+      }
+
+    if (_group >= 0)
+      {
+        _count[_group] += _span;
+        for (int e = 0; e != EVENT_MAX; ++e)
+          {
+            _values[_group][e] += v[e] - _start[e];
+          }
+      }
+    std::copy (v + 0, v + EVENT_MAX, _start);
+    _group = group;
+    _span = 0;
+  }
+
+  void vm68k_perf_profile::report (FILE *stream) const
+  {
+    assert (stream != NULL);
+
+    int order[GROUP_MAX];
+    unsigned long long total = 0;
+    for (int g = 0; g != GROUP_MAX; ++g)
+      {
+        order[g] = g;
+        total += _values[g][CYCLES];
+      }
+    // Sorted by cycles with a simple insertion sort.
+    for (int i = 1; i != GROUP_MAX; ++i)
+      {
+        int g = order[i];
+        int j = i;
+        for (; j != 0 && _values[order[j - 1]][CYCLES] < _values[g][CYCLES];
+             --j)
+          {
+            order[j] = order[j - 1];
+          }
+        order[j] = g;
+      }
+
+    fprintf (stream, "%-4s %-20s %12s %6s %9s %9s %9s %9s\n",
+             "grp", "handlers", "count", "cyc%", "cyc/ins", "hins/ins",
+             "brm/kins", "l1dm/kins");
+    for (int i = 0; i != GROUP_MAX; ++i)
+      {
+        int g = order[i];
+        unsigned long long n = _count[g];
+        if (n == 0)
+          {
+            continue;
+          }
+
+        const unsigned long long *v = _values[g];
+        fprintf (stream, "%-4x %-20s %12llu %6.2f %9.1f %9.1f %9.3f %9.3f\n",
+                 g, group_names[g], n, 100.0 * ratio (v[CYCLES], total),
+                 ratio (v[CYCLES], n), ratio (v[INSTRUCTIONS], n),
+                 1000.0 * ratio (v[BRANCH_MISSES], n),
+                 1000.0 * ratio (v[L1D_MISSES], n));
+      }
+
+    for (int e = INSTRUCTIONS; e != EVENT_MAX; ++e)
+      {
+        if (!this->counted ((event_type) e))
+          {
+            static const char *const names[EVENT_MAX] = {
+              "cycles", "instructions", "branch misses", "L1d misses"
+            };
+            fprintf (stream, "(%s not counted)\n", names[e]);
+          }
+      }
+  }
+}
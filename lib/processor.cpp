@@ -1,5 +1,5 @@
-/* Libvm68k - M68000 virtual machine library
-   Copyright (C) 1998-2002 Hypercore Software Design, Ltd.
+/* Virtual M68000 Toolkit
+   Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License as
@@ -17,115 +17,1007 @@
    02111-1307, USA.  */
 
 #ifdef HAVE_CONFIG_H
-# include <config.h>
+#include <config.h>
 #endif
-#undef const
-#undef inline
 
-#define _GNU_SOURCE 1
-#define _POSIX_C_SOURCE 199506L	// POSIX.1c
+#if _WIN32
+#include <windows.h>
+#endif
 
-#include "instr.h"
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
 
 #include <vm68k/processor>
-#include <vm68k/size>
+#include <vm68k/journal>
+#include <vm68k/aot>
+#include <vm68k/tcache>
+
 #include <algorithm>
-#include <cstdio>
+#include <cassert>
 
 #ifdef HAVE_NANA_H
-# include <nana.h>
-#else
-# include <cassert>
-# define I assert
+#include <nana.h>
 #endif
 
-using namespace std;
+using namespace vx68k;
 
 #ifdef HAVE_NANA_H
 bool nana_instruction_trace = false;
 #endif
 
-namespace vm68k
+namespace
 {
-  uint32_type
-  processor::run(uint32_type pc, context &c) const
-    throw (processor_exception)
+  using vx68k::uint_fast16_t;   // avoid ambiguity
+  using vx68k::uint_fast32_t;
+
+  /* Number of instructions in a slice for the unbounded run.  */
+  const unsigned long RUN_SLICE = 0x10000;
+
+  /* Executes an illegal instruction.  */
+  vm68k_address_t illegal (vm68k_address_t pc, uint_fast16_t,
+                           vm68k_context *)
   {
+    throw vm68k_illegal_instruction_exception (pc);
+  }
+
+  /* Stands for the handler of an instruction bound to a host
+     function.  The run loop makes the call.  */
+  vm68k_address_t host_call_stub (vm68k_address_t pc, uint_fast16_t,
+                                  vm68k_context *c)
+  {
+    c->trap_host_call ();
+    return pc - 2;
+  }
+
+  /* Processes a bus or address error of the instruction at PC, or
+     throws it as a processor exception if the context does not
+     process exceptions.  An error in the processing is a double fault
+     and is always thrown.  */
+  template<class Exception, class Error>
+  vm68k_address_t take_group0 (vm68k_context &c, uint_fast16_t vecno,
+                               vm68k_address_t pc, uint_fast16_t ir,
+                               const Error &e)
+  {
+    if (!c.exception_processing ())
+      {
+        throw Exception (pc, e);
+      }
+
     try
       {
-	for (;;)
-	  {
-	    if (c.interrupted())
-	      pc = c.handle_interrupts(pc);
+        return c.take_group0_exception (vecno, pc, ir, e.status (),
+                                        e.address ());
+      }
+    catch (const vm68k_bus_error &f)
+      {
+        throw vm68k_bus_error_exception (pc, f);
+      }
+    catch (const vm68k_address_error &f)
+      {
+        throw vm68k_address_error_exception (pc, f);
+      }
+  }
 
-#ifdef LG
-# ifdef DUMP_REGISTERS
-	    for (unsigned int i = 0; i != 8; ++i)
-	      {
-		LG(nana_instruction_trace,
-		   "| %%d%u = 0x%08lx, %%a%u = 0x%08lx\n",
-		   i, (unsigned long) c.regs.d[i],
-		   i, (unsigned long) c.regs.a[i]);
-	      }
-# endif
-	    LG(nana_instruction_trace, "| 0x%08lx (0x%04x)\n",
-	       long_word::normal_u(pc) + 0UL, c.fetch_u(word(), pc));
-#endif
-	    pc = dispatch(pc, c, c.fetch_u(word(), pc));
-	  }
+  /* Processes processor exception E.  LAST is the address of the
+     instruction that caused it.  */
+  vm68k_address_t take_exception (vm68k_context &c, const vm68k_exception &e,
+                                  vm68k_address_t last)
+  {
+    // These exceptions return to the instruction that caused them.
+    vm68k_address_t pc = e.pc ();
+    switch (e.vecno ())
+      {
+      case 4:
+      case 8:
+      case 10:
+      case 11:
+        pc = last;
+        break;
+      }
+
+    try
+      {
+        return c.take_exception (e.vecno (), pc);
+      }
+    catch (const vm68k_bus_error &f)
+      {
+        throw vm68k_bus_error_exception (last, f);
+      }
+    catch (const vm68k_address_error &f)
+      {
+        throw vm68k_address_error_exception (last, f);
+      }
+  }
+
+  /* Delivers the posted writes of a bus when a run loop is left by an
+     exception, so that the host handles it with the device state the
+     guest left.  */
+  class posted_write_guard
+  {
+  public:
+    explicit posted_write_guard (vm68k_bus *bus)
+    {
+      _bus = bus;
+    }
+
+    ~posted_write_guard ()
+    {
+      if (_bus != NULL)
+        {
+          // An error in the delivery must not replace the exception
+          // being thrown.
+          try
+            {
+              _bus->flush_posted_writes ();
+            }
+          catch (...)
+            {
+            }
+        }
+    }
+
+    /* Delivers the posted writes normally.  */
+    void flush ()
+    {
+      vm68k_bus *bus = _bus;
+      _bus = NULL;
+      bus->flush_posted_writes ();
+    }
+
+  private:
+    vm68k_bus *_bus;
+  };
+
+  /* Detects idle loops from the state at backward branches.  */
+  class idle_detector
+  {
+  public:
+    idle_detector ()
+    {
+      _valid = false;
+      _count = 0;
+    }
+
+    /* Notes a backward branch to ADDR and returns the number of
+       times the loop was taken in a row without any change.  */
+    unsigned int update (vm68k_address_t addr, const vm68k_context &c);
+
+    void reset ()
+    {
+      _valid = false;
+      _count = 0;
+    }
+
+  private:
+    bool _valid;
+    unsigned int _count;
+    vm68k_address_t _addr;
+    uint_fast32_t _store_count;
+    uint_fast16_t _status;
+    uint_least32_t _reg[vm68k_context::REGISTER_MAX];
+  };
+
+  unsigned int idle_detector::update (vm68k_address_t addr,
+                                      const vm68k_context &c)
+  {
+    bool same = _valid && addr == _addr
+      && c.store_count () == _store_count && c.status () == _status;
+    for (int i = 0; i != vm68k_context::REGISTER_MAX; ++i)
+      {
+        uint_fast32_t v =
+          c.read_reg_unsigned (vm68k_data_size::LONG_WORD, i);
+        if (v != _reg[i])
+          {
+            same = false;
+            _reg[i] = v;
+          }
+      }
+
+    if (same)
+      {
+        ++_count;
+      }
+    else
+      {
+        _valid = true;
+        _count = 0;
+        _addr = addr;
+        _store_count = c.store_count ();
+        _status = c.status ();
+      }
+
+    return _count;
+  }
+
+  /* Tracer that records nothing.  */
+  struct null_tracer
+  {
+    bool run_block (vm68k_address_t, vm68k_context &,
+                    const vm68k_instruction *, vm68k_compiled_frame &,
+                    vm68k_address_t &) const
+    {
+      return false;
+    }
+
+    void instruction (vm68k_address_t, uint_fast16_t)
+    {
+    }
+
+    void finish (const vm68k_context &)
+    {
+    }
+  };
+
+  /* Tracer that records nothing but runs the compiled blocks.  */
+  class compiled_tracer : public null_tracer
+  {
+  public:
+    explicit compiled_tracer (const vm68k_compiled_code *code)
+    {
+      _code = code;
+    }
+
+    bool run_block (vm68k_address_t pc, vm68k_context &c,
+                    const vm68k_instruction *handlers,
+                    vm68k_compiled_frame &f, vm68k_address_t &next) const
+    {
+      vm68k_compiled_block b = _code->find (pc);
+      if (b == NULL)
+        {
+          return false;
+        }
+      f.enter (_code->drops ());
+      next = b (&c, handlers, &f);
+      return true;
+    }
+
+  private:
+    const vm68k_compiled_code *_code;
+  };
+
+  /* Tracer that records nothing but runs the cached blocks.  */
+  class cache_tracer : public null_tracer
+  {
+  public:
+    explicit cache_tracer (const vm68k_translation_cache *cache)
+    {
+      _cache = cache;
+    }
+
+    bool run_block (vm68k_address_t pc, vm68k_context &c,
+                    const vm68k_instruction *handlers,
+                    vm68k_compiled_frame &f, vm68k_address_t &next) const
+    {
+      return _cache->run (pc, &c, handlers, &f, next);
+    }
+
+  private:
+    const vm68k_translation_cache *_cache;
+  };
+
+  /* Tracer that attributes host performance counts to the handler
+     groups.  */
+  class perf_tracer
+  {
+  public:
+    explicit perf_tracer (vm68k_perf_profile *profile)
+    {
+      _profile = profile;
+    }
+
+    ~perf_tracer ()
+    {
+      // The last instructions are counted when the run ends.
+      _profile->stop ();
+    }
+
+    bool run_block (vm68k_address_t, vm68k_context &,
+                    const vm68k_instruction *, vm68k_compiled_frame &,
+                    vm68k_address_t &) const
+    {
+      return false;
+    }
+
+    void instruction (vm68k_address_t, uint_fast16_t w)
+    {
+      _profile->start (w);
+    }
+
+    void finish (const vm68k_context &)
+    {
+    }
+
+  private:
+    vm68k_perf_profile *_profile;
+  };
+
+  /* Tracer that counts instructions for a journal.  */
+  class journal_tracer
+  {
+  public:
+    explicit journal_tracer (vm68k_journal *journal)
+    {
+      _journal = journal;
+    }
+
+    bool run_block (vm68k_address_t, vm68k_context &,
+                    const vm68k_instruction *, vm68k_compiled_frame &,
+                    vm68k_address_t &) const
+    {
+      return false;
+    }
+
+    void instruction (vm68k_address_t, uint_fast16_t)
+    {
+    }
+
+    void finish (vm68k_context &c)
+    {
+      // Host call stubs are not counted, as the instructions they
+      // stand for are finished again.
+      if ((c.pending () & vm68k_context::HOST_CALL) == 0)
+        {
+          _journal->instruction (c);
+        }
+    }
+
+  private:
+    vm68k_journal *_journal;
+  };
+
+  /* Tracer that appends records to a trace buffer.  */
+  class buffer_tracer
+  {
+  public:
+    buffer_tracer (vm68k_trace_buffer *buffer, const vm68k_context &c);
+
+    bool run_block (vm68k_address_t, vm68k_context &,
+                    const vm68k_instruction *, vm68k_compiled_frame &,
+                    vm68k_address_t &) const
+    {
+      return false;
+    }
+
+    void instruction (vm68k_address_t pc, uint_fast16_t w)
+    {
+      _buffer->append (vm68k_trace_record::INSTRUCTION, 2, pc, w);
+    }
+
+    void finish (const vm68k_context &c)
+    {
+      if (_registers)
+        {
+          this->compare_registers (c);
+        }
+    }
+
+  protected:
+    void compare_registers (const vm68k_context &c);
+
+  private:
+    vm68k_trace_buffer *_buffer;
+    bool _registers;
+    uint_least32_t _reg[vm68k_context::REGISTER_MAX];
+    uint_least16_t _status;
+  };
+
+  buffer_tracer::buffer_tracer (vm68k_trace_buffer *buffer,
+                                const vm68k_context &c)
+  {
+    _buffer = buffer;
+    _registers = (buffer->options () & vm68k_trace_buffer::REGISTERS) != 0;
+    for (int i = 0; i != vm68k_context::REGISTER_MAX; ++i)
+      {
+        _reg[i] = c.read_reg_unsigned (vm68k_data_size::LONG_WORD, i);
+      }
+    _status = c.status ();
+  }
+
+  void buffer_tracer::compare_registers (const vm68k_context &c)
+  {
+    for (int i = 0; i != vm68k_context::REGISTER_MAX; ++i)
+      {
+        uint_fast32_t v = c.read_reg_unsigned (vm68k_data_size::LONG_WORD, i);
+        if (v != _reg[i])
+          {
+            _buffer->append (vm68k_trace_record::REGISTER, 4, i, v);
+            _reg[i] = v;
+          }
+      }
+
+    uint_fast16_t status = c.status ();
+    if (status != _status)
+      {
+        _buffer->append (vm68k_trace_record::REGISTER, 2,
+                         vm68k_trace_record::REGISTER_SR, status);
+        _status = status;
+      }
+  }
+}
+
+namespace vx68k
+{
+  vm68k_exception::vm68k_exception (vm68k_address_t pc)
+  {
+    _pc = pc;
+  }
+
+  vm68k_instruction::vm68k_instruction ()
+  {
+    _func = &illegal;
+  }
+
+  vm68k_instruction::vm68k_instruction (function func)
+  {
+    assert (func != NULL);
+    _func = func;
+  }
+
+  vm68k_host_call::~vm68k_host_call ()
+  {
+  }
+
+  vm68k_instruction_decoder::vm68k_instruction_decoder ()
+  {
+    _idle_loop_size = 0;
+    _idle_loop_count = 0;
+    _compact = false;
+    _compiled = NULL;
+    _cache = NULL;
+
+    insert_inst1 (this);
+    insert_inst2 (this);
+    insert_inst3 (this);
+    insert_inst4 (this);
+    insert_inst5 (this);
+    insert_inst6 (this);
+    insert_inst10 (this);
+    insert_inst11 (this);
+    insert_inst15 (this);
+    insert_special (this);
+  }
+
+  vm68k_instruction_decoder::~vm68k_instruction_decoder ()
+  {
+  }
+
+  void vm68k_instruction_decoder::insert (uint_fast16_t code,
+                                          vm68k_instruction::function i)
+  {
+    assert ((code & ~0xffffU) == 0);
+    // An inserted handler replaces a fused one.
+    _unfused.erase (code);
+    _specialized.erase (code);
+    this->store (code, vm68k_instruction (i));
+  }
+
+  void vm68k_instruction_decoder::insert (const spec &s)
+  {
+    uint_fast16_t code = s.code & ~s.mask;
+    for (uint_fast32_t i = code; i <= (code | s.mask); ++i)
+      {
+        if ((i & ~s.mask) == code)
+          {
+            this->insert (i, s.func);
+          }
       }
-    catch (const bus_error &e)
+  }
+
+  void vm68k_instruction_decoder::store (uint_fast16_t code,
+                                         const vm68k_instruction &i)
+  {
+    _instruction[code] = i;
+    if (!_compact)
+      {
+        return;
+      }
+
+    const uint_fast32_t BLOCK_SIZE = 1U << COMPACT_SHIFT;
+    uint_fast16_t h = this->handler_number (i);
+    std::size_t b = code >> COMPACT_SHIFT;
+    uint_fast32_t offset = _block_offset[b];
+    if (_blocks[offset + (code & (BLOCK_SIZE - 1))] == h)
       {
-	throw bus_error_exception(pc, e);
+        return;
       }
-    catch (const address_error &e)
+
+    // A shared block is copied before it is changed.
+    if (_block_refs[offset / BLOCK_SIZE] > 1)
       {
-	throw address_error_exception(pc, e);
+        --_block_refs[offset / BLOCK_SIZE];
+        uint_fast32_t copy = _blocks.size ();
+        _blocks.resize (copy + BLOCK_SIZE);
+        std::copy (_blocks.begin () + offset,
+                   _blocks.begin () + offset + BLOCK_SIZE,
+                   _blocks.begin () + copy);
+        _block_refs.push_back (1);
+        _block_offset[b] = copy;
+        offset = copy;
       }
+    _blocks[offset + (code & (BLOCK_SIZE - 1))] = h;
+  }
+
+  uint_fast16_t
+  vm68k_instruction_decoder::handler_number (const vm68k_instruction &i)
+  {
+    std::map<vm68k_instruction::function, uint_least16_t>::const_iterator k =
+      _handler_numbers.find (i.func ());
+    if (k != _handler_numbers.end ())
+      {
+        return k->second;
+      }
+
+    uint_fast16_t h = _handlers.size ();
+    assert (h < 0x10000);
+    _handlers.push_back (i);
+    _handler_numbers.insert (std::make_pair (i.func (), h));
+    return h;
+  }
+
+  void vm68k_instruction_decoder::set_compact (bool compact)
+  {
+    _compact = false;
+    std::vector<vm68k_instruction> ().swap (_handlers);
+    _handler_numbers.clear ();
+    std::vector<uint_least16_t> ().swap (_blocks);
+    std::vector<uint_least32_t> ().swap (_block_offset);
+    std::vector<unsigned int> ().swap (_block_refs);
+    if (!compact)
+      {
+        return;
+      }
+
+    const uint_fast32_t BLOCK_SIZE = 1U << COMPACT_SHIFT;
+    std::map<std::vector<uint_least16_t>, uint_least32_t> shared;
+    std::vector<uint_least16_t> block (BLOCK_SIZE);
+    _block_offset.resize (0x10000 / BLOCK_SIZE);
+    for (uint_fast32_t b = 0; b != 0x10000 / BLOCK_SIZE; ++b)
+      {
+        for (uint_fast32_t j = 0; j != BLOCK_SIZE; ++j)
+          {
+            block[j] = this->handler_number (_instruction[b * BLOCK_SIZE + j]);
+          }
+
+        std::map<std::vector<uint_least16_t>, uint_least32_t>::iterator k =
+          shared.find (block);
+        if (k == shared.end ())
+          {
+            k = shared.insert (std::make_pair (block, _blocks.size ())).first;
+            _blocks.insert (_blocks.end (), block.begin (), block.end ());
+            _block_refs.push_back (0);
+          }
+        _block_offset[b] = k->second;
+        ++_block_refs[k->second / BLOCK_SIZE];
+      }
+    _compact = true;
+  }
+
+  std::size_t vm68k_instruction_decoder::compact_size () const
+  {
+    if (!_compact)
+      {
+        return 0;
+      }
+    return _handlers.size () * sizeof (vm68k_instruction)
+      + _blocks.size () * sizeof (uint_least16_t)
+      + _block_offset.size () * sizeof (uint_least32_t);
   }
 
   void
-  processor::set_instruction(int code, int mask, const instruction_type &in)
+  vm68k_instruction_decoder::specialize (uint_fast16_t code,
+                                         vm68k_instruction::function generic,
+                                         vm68k_instruction::function func)
+  {
+    vm68k_instruction original = _instruction[code];
+    if (original == vm68k_instruction (generic))
+      {
+        _specialized[code] = original;
+        this->store (code, vm68k_instruction (func));
+      }
+  }
+
+  std::size_t vm68k_instruction_decoder::fuse (const pair_count *first,
+                                               const pair_count *last,
+                                               unsigned long min_count)
+  {
+    std::size_t n = 0;
+    while (first != last)
+      {
+        if (first->count >= min_count
+            && this->fuse_pair (first->first, first->second))
+          {
+            ++n;
+          }
+        ++first;
+      }
+    return n;
+  }
+
+  std::size_t vm68k_instruction_decoder::fuse (std::FILE *stream,
+                                               unsigned long min_count)
+  {
+    assert (stream != NULL);
+
+    std::size_t n = 0;
+    unsigned int w1, w2;
+    unsigned long count;
+    while (std::fscanf (stream, "%x %x %lu", &w1, &w2, &count) == 3)
+      {
+        if (count >= min_count
+            && this->fuse_pair (w1 & 0xffffU, w2 & 0xffffU))
+          {
+            ++n;
+          }
+      }
+    return n;
+  }
+
+  void vm68k_instruction_decoder::unfuse ()
   {
-    I (code >= 0);
-    I (code < 0x10000);
+    for (std::map<uint_least16_t, vm68k_instruction>::const_iterator k =
+           _unfused.begin ();
+         k != _unfused.end (); ++k)
+      {
+        this->store (k->first, k->second);
+      }
+    _unfused.clear ();
+  }
+
+  void vm68k_instruction_decoder::insert_host_call (uint_fast16_t code,
+                                                    uint_fast16_t mask,
+                                                    vm68k_host_call *call)
+  {
+    assert (call != NULL);
     code &= ~mask;
-    for (int i = code; i <= (code | mask); ++i)
-      {
-	if ((i & ~mask) == code)
-	  {
-	    instruction_type old_value = set_instruction(i, in);
-#ifdef L
-	    if (old_value.first != &illegal)
-	      L("warning: Replacing instruction handler at 0x%04x\n", i);
-#endif
-	  }
-      }
-  }
-  
-  processor::processor()
-    : instructions(0x10000, instruction_type(&illegal, 0))
-  {
-    install_instructions_0(*this, 0);
-    install_instructions_1(*this, 0);
-    install_instructions_2(*this, 0);
-    install_instructions_3(*this, 0);
-    install_instructions_4(*this, 0);
-    install_instructions_5(*this, 0);
-    install_instructions_6(*this, 0);
-    install_instructions_7(*this, 0);
-    install_instructions_8(*this, 0);
-    install_instructions_9(*this, 0);
-    install_instructions_11(*this, 0);
-    install_instructions_12(*this, 0);
-    install_instructions_13(*this, 0);
-    install_instructions_14(*this, 0);
-  }
-  
-  /* Executes an illegal instruction.  */
-  uint32_type
-  processor::illegal(uint32_type pc, context &, uint16_type, void *)
+    for (uint_fast32_t i = code; i <= (code | mask); ++i)
+      {
+        if ((i & ~mask) == code)
+          {
+            _host_calls[i] = call;
+            this->insert (i, &host_call_stub);
+          }
+      }
+  }
+
+  vm68k_address_t
+  vm68k_instruction_decoder::call_host (vm68k_address_t pc, uint_fast16_t w,
+                                        vm68k_context *c) const
+  {
+    std::map<uint_least16_t, vm68k_host_call *>::const_iterator k =
+      _host_calls.find (w);
+    assert (k != _host_calls.end ());
+    vm68k_journal *journal = c->journal ();
+    if (journal != NULL)
+      {
+        return journal->call_host (*k->second, pc, w, *c);
+      }
+    return (*k->second) (pc, w, *c);
+  }
+
+  void vm68k_instruction_decoder::set_idle_loop (uint_fast16_t size,
+                                                 unsigned int count)
+  {
+    _idle_loop_size = size;
+    _idle_loop_count = count;
+  }
+
+  void vm68k_instruction_decoder::set_breakpoint (const vm68k_context &,
+                                                  vm68k_address_t addr)
+  {
+    _breakpoints.insert (addr);
+  }
+
+  void vm68k_instruction_decoder::remove_breakpoint (vm68k_address_t addr)
   {
-    throw illegal_instruction_exception(pc);
+    _breakpoints.erase (addr);
+  }
+
+  vm68k_address_t
+  vm68k_instruction_decoder::run (vm68k_address_t pc, vm68k_context &c) const
+    throw (vm68k_exception)
+  {
+    do
+      {
+        pc = this->run (pc, c, RUN_SLICE);
+      }
+    while (c.stop_reason () == vm68k_context::STOP_NONE);
+
+    return pc;
+  }
+
+  vm68k_address_t
+  vm68k_instruction_decoder::run (vm68k_address_t pc, vm68k_context &c,
+                                  unsigned long count) const
+    throw (vm68k_exception)
+  {
+    // The loop is instantiated for each tracer so that no test is
+    // left in it when tracing is off.
+    // Fused handlers would count two instructions as one.
+    vm68k_journal *journal = c.journal ();
+    if (journal != NULL)
+      {
+        c.set_fusible (false);
+        journal->resume (c);
+        journal_tracer t (journal);
+        return this->run_tracer<journal_tracer, false> (pc, c, count, t);
+      }
+
+    vm68k_trace_buffer *trace = c.trace ();
+    // Fused handlers would hide instructions from the tracer.
+    if (trace != NULL)
+      {
+        c.set_fusible (false);
+        buffer_tracer t (trace, c);
+        return this->run_tracer<buffer_tracer, false> (pc, c, count, t);
+      }
+
+    // Fused handlers would count two instructions in the group of the
+    // first.
+    vm68k_perf_profile *profile = c.perf_profile ();
+    if (profile != NULL && profile->is_open ())
+      {
+        c.set_fusible (false);
+        perf_tracer t (profile);
+        return this->run_tracer<perf_tracer, false> (pc, c, count, t);
+      }
+
+    // Fused handlers, compiled blocks and cached blocks would run past
+    // breakpoints.
+    c.set_fusible (_breakpoints.empty ());
+    if (_compiled != NULL && _breakpoints.empty ())
+      {
+        compiled_tracer t (_compiled);
+        if (_compact)
+          {
+            return this->run_tracer<compiled_tracer, true> (pc, c, count, t);
+          }
+        return this->run_tracer<compiled_tracer, false> (pc, c, count, t);
+      }
+    if (_cache != NULL && _breakpoints.empty ())
+      {
+        cache_tracer t (_cache);
+        if (_compact)
+          {
+            return this->run_tracer<cache_tracer, true> (pc, c, count, t);
+          }
+        return this->run_tracer<cache_tracer, false> (pc, c, count, t);
+      }
+
+    null_tracer t;
+    if (_compact)
+      {
+        return this->run_tracer<null_tracer, true> (pc, c, count, t);
+      }
+    return this->run_tracer<null_tracer, false> (pc, c, count, t);
+  }
+
+  template<class Tracer, bool Compact>
+  vm68k_address_t
+  vm68k_instruction_decoder::run_tracer (vm68k_address_t pc,
+                                         vm68k_context &c,
+                                         unsigned long count,
+                                         Tracer &t) const
+  {
+    if (!_breakpoints.empty ())
+      {
+        return this->run_slice<Tracer, Compact, true> (pc, c, count, t);
+      }
+    return this->run_slice<Tracer, Compact, false> (pc, c, count, t);
+  }
+
+  template<class Tracer, bool Compact, bool Breakpoints>
+  vm68k_address_t
+  vm68k_instruction_decoder::run_slice (vm68k_address_t pc,
+                                        vm68k_context &c,
+                                        unsigned long count,
+                                        Tracer &t) const
+  {
+    vm68k_bus *bus = c.bus ();
+    posted_write_guard guard (bus);
+    // Only the accesses of the run defer faults; the host accesses
+    // outside it still throw.
+    vm68k_context::deferred_fault_guard deferral (c);
+    idle_detector idle;
+
+    // A run from the breakpoint it stopped at executes the instruction
+    // there.
+    vm68k_address_t resume = pc;
+    bool resuming = c.stop_reason () == vm68k_context::STOP_BREAKPOINT;
+    c.set_stop_reason (vm68k_context::STOP_NONE);
+
+    // Address and operation word of the last instruction executed,
+    // for faults.
+    vm68k_address_t last = pc;
+    uint_fast16_t ir = 0;
+
+    bool done = false;
+    while (!done)
+      {
+        try
+          {
+            for (;;)
+              {
+                // Pending state is handled before the count is checked
+                // so that a stub executed last is resolved in this
+                // slice.
+                if (c.pending () != 0)
+                  {
+                    if (c.host_call_trapped ())
+                      {
+                        ir = c.fetch_unsigned (vm68k_data_size::WORD, pc);
+                        last = pc;
+                        vm68k_address_t next =
+                          this->call_host (pc + 2, ir, &c);
+                        t.finish (c);
+                        pc = next;
+                        continue;
+                      }
+                    if (c.faulted ())
+                      {
+                        if (!c.exception_processing ())
+                          {
+                            c.set_stop_reason (vm68k_context::STOP_FAULT);
+                            pc = last;
+                            break;
+                          }
+
+                        pc = c.take_group0_exception
+                          (c.fault_address_error () ? 3 : 2, last, ir,
+                           c.fault_status (), c.fault_address ());
+                        if (c.faulted ())
+                          {
+                            // A double fault halts the processor.
+                            c.set_stop_reason (vm68k_context::STOP_FAULT);
+                            pc = last;
+                            break;
+                          }
+                      }
+                    if (c.stop_requested ())
+                      {
+                        c.set_stop_reason (vm68k_context::STOP_REQUESTED);
+                        break;
+                      }
+                    if (c.interrupted ())
+                      {
+                        pc = c.handle_interrupts (pc);
+                      }
+                    if (c.stopped ())
+                      {
+                        // The processor stays stopped until an
+                        // interrupt is accepted.
+                        bus->flush_posted_writes ();
+                        c.wait_interrupt ();
+                        continue;
+                      }
+                  }
+
+                if (count == 0)
+                  {
+                    break;
+                  }
+
+                // Blocks begin with the instruction at PC.
+                vm68k_compiled_frame f;
+                f.pc = pc;
+                f.ir = ir;
+                f.count = count;
+                vm68k_address_t next;
+                bool ran;
+                try
+                  {
+                    ran = t.run_block (pc, c, _instruction, f, next);
+                  }
+                catch (...)
+                  {
+                    // The handlers below take the exception at the
+                    // instruction that raised it.
+                    pc = last = f.pc;
+                    ir = f.ir;
+                    count = f.count;
+                    throw;
+                  }
+                if (ran)
+                  {
+                    last = f.pc;
+                    ir = f.ir;
+                    count = f.count;
+
+                    // Only the last instruction of a block can branch.
+                    if (next < last && last - next <= _idle_loop_size)
+                      {
+                        if (idle.update (next, c) >= _idle_loop_count)
+                          {
+                            bus->flush_posted_writes ();
+                            c.wait_interrupt ();
+                            idle.reset ();
+                          }
+                      }
+                    pc = next;
+                    continue;
+                  }
+
+                // The address is checked at dispatch so that the
+                // breakpoint holds for code loaded or changed after it
+                // was set.
+                if (Breakpoints)
+                  {
+                    if (!(resuming && pc == resume)
+                        && this->breakpoint (pc))
+                      {
+                        c.set_stop_reason (vm68k_context::STOP_BREAKPOINT);
+                        break;
+                      }
+                    resuming = false;
+                  }
+
+                if (--count == 0)
+                  {
+                    c.set_fusible (false);
+                  }
+
+                ir = c.fetch_unsigned (vm68k_data_size::WORD, pc);
+                if (c.fault_pending ())
+                  {
+                    // The fault is taken at PC before anything runs.
+                    last = pc;
+                    continue;
+                  }
+#ifdef LG
+                LG (nana_instruction_trace, "| 0x%08lx (0x%04x)\n",
+                    (unsigned long) pc, (unsigned int) ir);
+#endif
+                t.instruction (pc, ir);
+                last = pc;
+                next = Compact
+                  ? this->dispatch_compact (pc + 2, ir, &c)
+                  : this->dispatch (pc + 2, ir, &c);
+                t.finish (c);
+
+                // Only short backward branches are checked for idle
+                // loops.
+                if (next < pc && pc - next <= _idle_loop_size)
+                  {
+                    if (idle.update (next, c) >= _idle_loop_count)
+                      {
+                        bus->flush_posted_writes ();
+                        c.wait_interrupt ();
+                        idle.reset ();
+                      }
+                  }
+                pc = next;
+              }
+            done = true;
+          }
+        catch (const vm68k_bus_error &e)
+          {
+            pc = take_group0<vm68k_bus_error_exception> (c, 2, pc, ir, e);
+            // The instruction that raised an exception is finished
+            // after the exception is taken.
+            t.finish (c);
+          }
+        catch (const vm68k_address_error &e)
+          {
+            pc = take_group0<vm68k_address_error_exception> (c, 3, pc, ir,
+                                                             e);
+            t.finish (c);
+          }
+        catch (const vm68k_exception &e)
+          {
+            if (!c.exception_processing ())
+              {
+                throw;
+              }
+            pc = take_exception (c, e, last);
+            t.finish (c);
+          }
+      }
+
+    guard.flush ();
+    return pc;
   }
 }
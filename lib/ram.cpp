@@ -0,0 +1,178 @@
+/* Virtual M68000 Toolkit
+   Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307
+   USA.  */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/ram>
+
+#include <algorithm>
+#include <cstdio>
+#include <cassert>
+
+#if HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+using std::size_t;
+
+namespace
+{
+  using namespace vx68k;
+
+  /* Rounds N up to a multiple of ALIGN, which is a power of two.  */
+  inline size_t round_up (size_t n, size_t align)
+  {
+    return (n + align - 1) & ~(align - 1);
+  }
+
+#if HAVE_SYS_MMAN_H
+  /* Maps SIZE bytes aligned to huge pages with normal pages, and
+     advises huge pages to the host.  Returns null on error.  */
+  unsigned char *map_aligned (size_t size)
+  {
+    // Extra bytes are mapped to align the start, and unmapped later.
+    size_t extra = vm68k_ram::HUGE_PAGE_SIZE;
+    void *p = mmap (NULL, size + extra, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+      {
+        return NULL;
+      }
+
+    unsigned char *start = static_cast<unsigned char *> (p);
+    unsigned char *aligned = reinterpret_cast<unsigned char *>
+      (round_up (reinterpret_cast<size_t> (start), extra));
+    if (aligned != start)
+      {
+        munmap (start, aligned - start);
+      }
+    if (aligned + size != start + size + extra)
+      {
+        munmap (aligned + size, start + extra - aligned);
+      }
+
+#ifdef MADV_HUGEPAGE
+    madvise (aligned, size, MADV_HUGEPAGE);
+#endif
+    return aligned;
+  }
+#endif
+}
+
+namespace vx68k
+{
+  vm68k_ram::vm68k_ram (vm68k_address_t base, size_t size)
+  {
+    assert ((base & (PAGE_SIZE - 1)) == 0);
+    assert ((size & (PAGE_SIZE - 1)) == 0);
+    _base = base & ((1UL << ADDRESS_BIT) - 1);
+    _size = size;
+
+    _mapped_size = round_up (size, HUGE_PAGE_SIZE);
+    _bytes = NULL;
+#if HAVE_SYS_MMAN_H
+#ifdef MAP_HUGETLB
+    void *p = mmap (NULL, _mapped_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED)
+      {
+        _bytes = static_cast<unsigned char *> (p);
+        _allocation = HUGE_PAGES;
+        return;
+      }
+#endif
+    _bytes = map_aligned (_mapped_size);
+    if (_bytes != NULL)
+      {
+        _allocation = MAPPED;
+        return;
+      }
+#endif
+    _bytes = new unsigned char [size];
+    std::fill (_bytes, _bytes + size, 0);
+    _mapped_size = 0;
+    _allocation = HEAP;
+  }
+
+  vm68k_ram::~vm68k_ram ()
+  {
+#if HAVE_SYS_MMAN_H
+    if (_allocation != HEAP)
+      {
+        munmap (_bytes, _mapped_size);
+        return;
+      }
+#endif
+    delete [] _bytes;
+  }
+
+  size_t vm68k_ram::huge_page_bytes () const
+  {
+    switch (_allocation)
+      {
+      case HUGE_PAGES:
+        return _mapped_size;
+      case MAPPED:
+        break;
+      default:
+        return 0;
+      }
+
+    // The host reports transparent huge pages for each mapping.
+    std::FILE *smaps = std::fopen ("/proc/self/smaps", "r");
+    if (smaps == NULL)
+      {
+        return 0;
+      }
+
+    size_t bytes = 0;
+    bool inside = false;
+    unsigned long start = reinterpret_cast<unsigned long> (_bytes);
+    unsigned long end = start + _mapped_size;
+    char line[256];
+    while (std::fgets (line, sizeof line, smaps) != NULL)
+      {
+        unsigned long first, last, kib;
+        if (std::sscanf (line, "%lx-%lx ", &first, &last) == 2)
+          {
+            inside = first < end && start < last;
+          }
+        else if (inside
+                 && std::sscanf (line, "AnonHugePages: %lu kB", &kib) == 1)
+          {
+            bytes += kib * 1024;
+          }
+      }
+    std::fclose (smaps);
+    return bytes;
+  }
+}
@@ -0,0 +1,493 @@
+/* Virtual M68000 Toolkit
+   Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307
+   USA.  */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+#include <vm68k/tcache>
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#if HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+using std::FILE;
+using std::size_t;
+using std::vector;
+
+namespace
+{
+  using namespace vx68k;
+
+  typedef vm68k_translation_cache::block_record block_record;
+  typedef vm68k_translation_cache::instruction_record instruction_record;
+
+  /* Function codes that may write code.  */
+  const int CODE_WRITERS =
+    1 << vm68k_bus::USER_DATA | 1 << vm68k_bus::SUPER_DATA;
+
+  const char CACHE_MAGIC[8] = {'V', 'M', '6', '8', 'K', 'T', 'C', '1'};
+
+  /* Header of a cache file, which is followed by the block records
+     and the instruction records.  */
+  struct file_header
+  {
+    char magic[8];
+    uint_least32_t byte_order;
+    uint_least16_t block_size;
+    uint_least16_t instruction_size;
+    uint_least32_t block_count;
+    uint_least32_t instruction_count;
+  };
+
+  /* Value of byte_order as written by this host.  */
+  const uint_least32_t BYTE_ORDER_MARK = 0x01020304;
+}
+
+namespace vx68k
+{
+  const char *const vm68k_translation_cache::SUFFIX = ".vtc";
+
+  vm68k_translation_cache::vm68k_translation_cache ()
+  {
+    _mapping = NULL;
+    _mapping_size = 0;
+    _blocks = NULL;
+    _block_count = 0;
+    _instructions = NULL;
+    _bus = NULL;
+    _drops = 0;
+  }
+
+  vm68k_translation_cache::~vm68k_translation_cache ()
+  {
+    this->close ();
+  }
+
+  void vm68k_translation_cache::build (const vm68k_control_flow_graph &g)
+  {
+    this->close ();
+
+    const vm68k_disassembler *d = g.disassembler ();
+    const vm68k_control_flow_graph::block_map &blocks = g.blocks ();
+    for (vm68k_control_flow_graph::block_map::const_iterator i =
+           blocks.begin (); i != blocks.end (); ++i)
+      {
+        const vm68k_control_flow_graph::block &b = i->second;
+        vm68k_code_image code = g.find_image (b.start);
+
+        // The records are cleared so that the file has no stray bytes
+        // in padding.
+        block_record r;
+        std::memset (&r, 0, sizeof r);
+        r.start = b.start;
+        r.end = b.end;
+        r.first = _built_instructions.size ();
+        r.hash = vm68k_compiled_code::INITIAL_HASH;
+        for (vm68k_address_t a = b.start; a != b.end; a += 2)
+          {
+            uint_fast16_t w = code.fetch_word (a);
+            unsigned char data[2];
+            data[0] = w >> 8;
+            data[1] = w;
+            r.hash = vm68k_compiled_code::hash (data, 2, r.hash);
+          }
+
+        vm68k_address_t a = b.start;
+        for (;;)
+          {
+            vm68k_address_t next, target;
+            d->flow (code, a, next, target);
+
+            instruction_record k;
+            std::memset (&k, 0, sizeof k);
+            k.word = code.fetch_word (a);
+            k.length = next - a;
+            _built_instructions.push_back (k);
+            if (a == b.last)
+              {
+                break;
+              }
+            a = next;
+          }
+        r.count = _built_instructions.size () - r.first;
+        _built_blocks.push_back (r);
+      }
+
+    _blocks = _built_blocks.empty () ? NULL : &_built_blocks[0];
+    _block_count = _built_blocks.size ();
+    _instructions =
+      _built_instructions.empty () ? NULL : &_built_instructions[0];
+  }
+
+  bool vm68k_translation_cache::save (const char *name) const
+  {
+    FILE *stream = std::fopen (name, "wb");
+    if (stream == NULL)
+      {
+        return false;
+      }
+
+    file_header h;
+    std::memset (&h, 0, sizeof h);
+    std::memcpy (h.magic, CACHE_MAGIC, sizeof h.magic);
+    h.byte_order = BYTE_ORDER_MARK;
+    h.block_size = sizeof (block_record);
+    h.instruction_size = sizeof (instruction_record);
+    h.block_count = _block_count;
+    h.instruction_count = 0;
+    if (_block_count != 0)
+      {
+        const block_record &last = _blocks[_block_count - 1];
+        h.instruction_count = last.first + last.count;
+      }
+
+    bool ok = std::fwrite (&h, sizeof h, 1, stream) == 1
+      && std::fwrite (_blocks, sizeof (block_record), h.block_count,
+                      stream) == h.block_count
+      && std::fwrite (_instructions, sizeof (instruction_record),
+                      h.instruction_count, stream) == h.instruction_count;
+    return std::fclose (stream) == 0 && ok;
+  }
+
+  bool vm68k_translation_cache::open (const char *name)
+  {
+    this->close ();
+
+    FILE *stream = std::fopen (name, "rb");
+    if (stream == NULL)
+      {
+        return false;
+      }
+
+    long size = -1;
+    if (std::fseek (stream, 0, SEEK_END) == 0)
+      {
+        size = std::ftell (stream);
+      }
+    if (size <= 0)
+      {
+        std::fclose (stream);
+        return false;
+      }
+
+#if HAVE_SYS_MMAN_H
+    // The mapping is kept after the file is closed.
+    void *p = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fileno (stream), 0);
+    if (p != MAP_FAILED)
+      {
+        std::fclose (stream);
+        _mapping = p;
+        _mapping_size = size;
+        if (!this->set_records (static_cast<unsigned char *> (p), size))
+          {
+            this->close ();
+            return false;
+          }
+        return true;
+      }
+#endif
+
+    _data.resize (size);
+    std::rewind (stream);
+    bool ok = std::fread (&_data[0], 1, size, stream) == (size_t) size;
+    std::fclose (stream);
+    if (!ok || !this->set_records (&_data[0], size))
+      {
+        this->close ();
+        return false;
+      }
+    return true;
+  }
+
+  bool vm68k_translation_cache::set_records (const unsigned char *data,
+                                             size_t size)
+  {
+    if (size < sizeof (file_header))
+      {
+        return false;
+      }
+
+    file_header h;
+    std::memcpy (&h, data, sizeof h);
+    if (std::memcmp (h.magic, CACHE_MAGIC, sizeof h.magic) != 0
+        || h.byte_order != BYTE_ORDER_MARK
+        || h.block_size != sizeof (block_record)
+        || h.instruction_size != sizeof (instruction_record))
+      {
+        return false;
+      }
+    if ((size - sizeof h) / sizeof (block_record) < h.block_count
+        || size - sizeof h - h.block_count * sizeof (block_record)
+        != h.instruction_count * sizeof (instruction_record))
+      {
+        return false;
+      }
+
+    const block_record *blocks =
+      reinterpret_cast<const block_record *> (data + sizeof h);
+    const instruction_record *instructions =
+      reinterpret_cast<const instruction_record *> (blocks + h.block_count);
+
+    // Each block must be made of its instructions so that it cannot
+    // run past the records.
+    for (uint_fast32_t i = 0; i != h.block_count; ++i)
+      {
+        const block_record &b = blocks[i];
+        if (b.count == 0 || b.first > h.instruction_count
+            || b.count > h.instruction_count - b.first)
+          {
+            return false;
+          }
+
+        vm68k_address_t a = b.start;
+        for (uint_fast32_t j = b.first; j != b.first + b.count; ++j)
+          {
+            if (instructions[j].length < 2)
+              {
+                return false;
+              }
+            a += instructions[j].length;
+          }
+        if (a != b.end)
+          {
+            return false;
+          }
+      }
+
+    _blocks = blocks;
+    _block_count = h.block_count;
+    _instructions = instructions;
+    return true;
+  }
+
+  void vm68k_translation_cache::close ()
+  {
+    this->unbind ();
+#if HAVE_SYS_MMAN_H
+    if (_mapping != NULL)
+      {
+        munmap (_mapping, _mapping_size);
+      }
+#endif
+    _mapping = NULL;
+    _mapping_size = 0;
+    _built_blocks.clear ();
+    _built_instructions.clear ();
+    _data.clear ();
+    _blocks = NULL;
+    _block_count = 0;
+    _instructions = NULL;
+  }
+
+  size_t vm68k_translation_cache::bind (vm68k_bus *bus,
+                                        vm68k_bus::function_code func)
+  {
+    assert (bus != NULL);
+    this->unbind ();
+
+    vm68k_disassembler d;
+    vector<unsigned char> data;
+    for (uint_fast32_t i = 0; i != _block_count; ++i)
+      {
+        const block_record &b = _blocks[i];
+        data.resize (b.end - b.start);
+        try
+          {
+            bus->read (func, b.start, &data[0], data.size ());
+          }
+        catch (const vm68k_bus_error &)
+          {
+            continue;
+          }
+        if (vm68k_compiled_code::hash (&data[0], data.size (),
+                                       vm68k_compiled_code::INITIAL_HASH)
+            != b.hash)
+          {
+            continue;
+          }
+        vm68k_code_image code (b.start, &data[0], data.size ());
+        if (!this->decoded_as (d, code, b))
+          {
+            continue;
+          }
+
+        _enabled.push_back (i);
+        bus->mark_code (CODE_WRITERS, b.start, b.end - b.start, this);
+      }
+
+    _bus = bus;
+    _bus->add_code_listener (this);
+    this->rehash ();
+    return _enabled.size ();
+  }
+
+  bool
+  vm68k_translation_cache::decoded_as (const vm68k_disassembler &d,
+                                       const vm68k_code_image &code,
+                                       const block_record &b) const
+  {
+    vm68k_address_t a = b.start;
+    const instruction_record *last = _instructions + (b.first + b.count - 1);
+    for (const instruction_record *k = _instructions + b.first; ; ++k)
+      {
+        vm68k_address_t next, target;
+        vm68k_instruction::flow_type flow = d.flow (code, a, next, target);
+        if (k->word != code.fetch_word (a) || k->length != next - a)
+          {
+            return false;
+          }
+        if (k == last)
+          {
+            return next == b.end;
+          }
+
+        // Only the last instruction may go elsewhere.
+        if (flow != vm68k_instruction::FLOW_NEXT)
+          {
+            return false;
+          }
+        a = next;
+      }
+  }
+
+  void vm68k_translation_cache::unbind ()
+  {
+    if (_bus != NULL)
+      {
+        // Only the marks of this cache are cleared, including those
+        // left by the blocks that were dropped.
+        for (uint_fast32_t i = 0; i != _block_count; ++i)
+          {
+            const block_record &b = _blocks[i];
+            _bus->unmark_code (CODE_WRITERS, b.start, b.end - b.start, this);
+          }
+        _bus->remove_code_listener (this);
+        _bus = NULL;
+      }
+    _enabled.clear ();
+    _table.clear ();
+  }
+
+  void vm68k_translation_cache::code_written (vm68k_bus::function_code,
+                                              vm68k_address_t addr,
+                                              int size)
+  {
+    vm68k_address_t end = addr + size;
+    vector<uint_least32_t>::iterator k = _enabled.begin ();
+    bool dropped = false;
+    while (k != _enabled.end ())
+      {
+        const block_record &b = _blocks[*k];
+        if (b.start < end && addr < b.end)
+          {
+            k = _enabled.erase (k);
+            dropped = true;
+          }
+        else
+          {
+            ++k;
+          }
+      }
+
+    if (dropped)
+      {
+        // A block that is running returns before its next instruction.
+        ++_drops;
+        this->rehash ();
+      }
+  }
+
+  vm68k_address_t
+  vm68k_translation_cache::run_block (const block_record &b,
+                                      vm68k_context *c,
+                                      const vm68k_instruction *handlers,
+                                      vm68k_compiled_frame *f) const
+  {
+    const instruction_record *i = _instructions + b.first;
+    const instruction_record *last = i + (b.count - 1);
+    vm68k_address_t addr = b.start;
+    f->begin (c, addr, i->word);
+    for (;;)
+      {
+        vm68k_address_t pc = handlers[i->word] (addr + 2, i->word, c);
+        if (i == last)
+          {
+            return pc;
+          }
+
+        // The instruction goes to the next unless its handler is
+        // replaced by a stub or a fused one.
+        addr += i->length;
+        ++i;
+        if (pc != addr)
+          {
+            return pc;
+          }
+        if (!f->start (c, addr, i->word))
+          {
+            return addr;
+          }
+      }
+  }
+
+  void vm68k_translation_cache::rehash ()
+  {
+    _table.clear ();
+    if (_enabled.empty ())
+      {
+        return;
+      }
+
+    // The table is kept at most half full.
+    size_t size = 16;
+    while (size < 2 * _enabled.size ())
+      {
+        size *= 2;
+      }
+    _table.resize (size, NULL);
+
+    size_t mask = size - 1;
+    for (vector<uint_least32_t>::const_iterator k = _enabled.begin ();
+         k != _enabled.end (); ++k)
+      {
+        const block_record *b = _blocks + *k;
+        size_t i = (b->start >> 1) * 0x9e3779b1U & mask;
+        while (_table[i] != NULL)
+          {
+            i = (i + 1) & mask;
+          }
+        _table[i] = b;
+      }
+  }
+}
@@ -0,0 +1,205 @@
+/* trace - execution trace recorder for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+#if _WIN32
+#define VM68K_PUBLIC __declspec (dllexport)
+#elif __GNUC__
+#define VM68K_PUBLIC __attribute__ ((__visibility__ ("default")))
+#else
+#define VM68K_PUBLIC
+#endif
+
+#include <vm68k/trace>
+
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+using std::FILE;
+using std::size_t;
+
+namespace
+{
+  using namespace vx68k;
+  using vx68k::uint_fast32_t;   // avoid ambiguity
+
+  /* Magic bytes at the start of a trace file.  */
+  const char TRACE_MAGIC[8] = {'V', 'M', '6', '8', 'K', 'T', 'R', '1'};
+
+  inline unsigned long load_head (const volatile unsigned long *head)
+  {
+#if defined __ATOMIC_ACQUIRE
+    return __atomic_load_n (head, __ATOMIC_ACQUIRE);
+#else
+    unsigned long value = *head;
+#if __GNUC__
+    __sync_synchronize ();
+#endif
+    return value;
+#endif
+  }
+
+  /* Stores VALUE at P in the little-endian byte order.  */
+  inline void put32 (unsigned char *p, uint_fast32_t value)
+  {
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+  }
+
+  inline uint_fast32_t get32 (const unsigned char *p)
+  {
+    return (uint_fast32_t) p[0] | (uint_fast32_t) p[1] << 8
+      | (uint_fast32_t) p[2] << 16 | (uint_fast32_t) p[3] << 24;
+  }
+}
+
+namespace vx68k
+{
+  vm68k_trace_buffer::vm68k_trace_buffer (size_t capacity,
+                                          unsigned int options)
+  {
+    unsigned long n = 2;
+    while (n < capacity)
+      {
+        n <<= 1;
+      }
+
+    _records = new vm68k_trace_record [n];
+    _mask = n - 1;
+    _head = 0;
+    _tail = 0;
+    _lost = 0;
+    _options = options;
+  }
+
+  vm68k_trace_buffer::~vm68k_trace_buffer ()
+  {
+    delete [] _records;
+  }
+
+  size_t vm68k_trace_buffer::read (vm68k_trace_record *first, size_t n)
+  {
+    unsigned long capacity = _mask + 1;
+    unsigned long head = load_head (&_head);
+    // The writer may be overwriting the record at HEAD - CAPACITY
+    // before it publishes the next head.
+    if (head - _tail >= capacity)
+      {
+        _lost += head - capacity + 1 - _tail;
+        _tail = head - capacity + 1;
+      }
+
+    size_t k = 0;
+    while (k != n && _tail != head)
+      {
+        first[k++] = _records[_tail & _mask];
+        ++_tail;
+      }
+
+    // Drop the records that were overwritten while they were copied.
+    unsigned long start = _tail - k;
+    head = load_head (&_head);
+    if (head - start >= capacity)
+      {
+        size_t bad = std::min<unsigned long> (k,
+                                              head - capacity - start + 1);
+        std::copy (first + bad, first + k, first);
+        k -= bad;
+        _lost += bad;
+      }
+
+    return k;
+  }
+
+  size_t vm68k_trace_buffer::save (FILE *stream)
+  {
+    assert (stream != NULL);
+
+    size_t count = 0;
+    vm68k_trace_record buf[256];
+    for (;;)
+      {
+        size_t n = this->read (buf, sizeof buf / sizeof buf[0]);
+        if (n == 0)
+          {
+            break;
+          }
+
+        unsigned char data[sizeof buf / sizeof buf[0] * RECORD_SIZE];
+        unsigned char *p = data;
+        for (size_t i = 0; i != n; ++i)
+          {
+            put32 (p + 0, buf[i].address);
+            put32 (p + 4, buf[i].value);
+            p[8] = buf[i].kind;
+            p[9] = buf[i].size;
+            p[10] = 0;
+            p[11] = 0;
+            p += RECORD_SIZE;
+          }
+
+        if (std::fwrite (data, RECORD_SIZE, n, stream) != n)
+          {
+            break;
+          }
+        count += n;
+      }
+
+    return count;
+  }
+
+  bool vm68k_write_trace_header (FILE *stream)
+  {
+    return std::fwrite (TRACE_MAGIC, sizeof TRACE_MAGIC, 1, stream) == 1;
+  }
+
+  bool vm68k_read_trace_header (FILE *stream)
+  {
+    char magic[sizeof TRACE_MAGIC];
+    if (std::fread (magic, sizeof magic, 1, stream) != 1)
+      {
+        return false;
+      }
+
+    return std::memcmp (magic, TRACE_MAGIC, sizeof magic) == 0;
+  }
+
+  bool vm68k_read_trace_record (FILE *stream, vm68k_trace_record *r)
+  {
+    unsigned char data[vm68k_trace_buffer::RECORD_SIZE];
+    if (std::fread (data, sizeof data, 1, stream) != 1)
+      {
+        return false;
+      }
+
+    r->address = get32 (data + 0);
+    r->value = get32 (data + 4);
+    r->kind = data[8];
+    r->size = data[9];
+    return true;
+  }
+}
@@ -0,0 +1,250 @@
+/* -*-c++-*-
+ * aot - ahead-of-time compiled code private header for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM68K_AOT_H
+#define _VM68K_AOT_H 1
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace vx68k
+{
+  /**
+   * State of the run loop that a compiled block keeps while it runs,
+   * so that the loop can take the exceptions and handle the pending
+   * state the block leaves.
+   */
+  struct vm68k_compiled_frame
+  {
+    /* Address and operation word of the instruction being
+       executed.  */
+    vm68k_address_t pc;
+    uint_fast16_t ir;
+
+    /* Number of instructions left in the slice.  */
+    unsigned long count;
+
+    /* Count of the drops of blocks from the code the block is taken
+       from, and its value when the block was entered.  A write that
+       drops blocks while one runs makes it return to the run loop
+       before its next instruction, so that the written code is
+       decoded anew.  */
+    const unsigned long *drops;
+    unsigned long entry_drops;
+
+    /* Enters a block of code whose drops are counted at D.  */
+    void enter (const unsigned long *d)
+    {
+      drops = d;
+      entry_drops = *d;
+    }
+
+    /* Starts the first instruction of a block at ADDR with operation
+       word W.  The run loop calls the block only with a nonzero
+       count.  */
+    void begin (vm68k_context *c, vm68k_address_t addr, uint_fast16_t w)
+    {
+      if (--count == 0)
+        {
+          c->set_fusible (false);
+        }
+      pc = addr;
+      ir = w;
+    }
+
+    /* Starts a following instruction.  Returns false if the block must
+       return to the run loop before it, as the loop would stop or
+       handle pending state there.  */
+    bool start (vm68k_context *c, vm68k_address_t addr, uint_fast16_t w)
+    {
+      if (c->pending () != 0 || count == 0 || *drops != entry_drops)
+        {
+          return false;
+        }
+      this->begin (c, addr, w);
+      return true;
+    }
+  };
+
+  /* Compiled block.  It executes the instructions of a basic block
+     with HANDLERS, the dispatch table of the decoder, and returns the
+     address of the next instruction.  */
+  typedef vm68k_address_t (*vm68k_compiled_block)
+    (vm68k_context *c, const vm68k_instruction *handlers,
+     vm68k_compiled_frame *f);
+
+  /* Compiled block in generated code.  END is the address after the
+     last instruction.  */
+  struct vm68k_compiled_block_entry
+  {
+    vm68k_address_t start;
+    vm68k_address_t end;
+    vm68k_compiled_block func;
+  };
+
+  /* Page of guest code in generated code.  HASH is that of the bytes
+     of the blocks that start in the page, in order, and the blocks
+     are COUNT entries from FIRST.  */
+  struct vm68k_compiled_page_entry
+  {
+    vm68k_address_t addr;
+    unsigned long long hash;
+    uint_least32_t first;
+    uint_least32_t count;
+  };
+
+  /* Contents of a shared object made from generated code, which is
+     exported as vm68k_compiled_blocks.  */
+  struct vm68k_compiled_image
+  {
+    /* Version of the layout, which must be VERSION.  */
+    unsigned int version;
+    uint_least32_t page_count;
+    const vm68k_compiled_page_entry *pages;
+    const vm68k_compiled_block_entry *blocks;
+
+    static const unsigned int VERSION = 2;
+  };
+
+  /**
+   * Guest code compiled ahead of time into a shared object.  The
+   * blocks of the control flow graph are written as C++ source that
+   * calls the instruction handlers with constant operands, which
+   * saves the fetch and decode of each instruction.  At run time the
+   * blocks of a page are used only if the code on the bus has the
+   * same hash as when compiled, and they are dropped when the code is
+   * written.  The rest of the code is left to the interpreter.
+   */
+  class VM68K_PUBLIC vm68k_compiled_code : public vm68k_bus::code_listener
+  {
+  public:
+    /* Name of the exported image.  */
+    static const char *const SYMBOL;
+
+    /* Returns the hash of SIZE bytes at DATA, continued from H.  The
+       first call should give INITIAL_HASH.  */
+    static unsigned long long hash (const unsigned char *data,
+                                    std::size_t size,
+                                    unsigned long long h);
+
+    static const unsigned long long INITIAL_HASH = 0xcbf29ce484222325ULL;
+
+    /* Writes the source of a shared object for the blocks of G to
+       STREAM.  The code must have been added to G.  */
+    static void write_source (std::FILE *stream,
+                              const vm68k_control_flow_graph &g);
+
+  public:
+    vm68k_compiled_code ();
+    ~vm68k_compiled_code ();
+
+  private:
+    // XXX: These functions are left unimplemented.
+    vm68k_compiled_code (const vm68k_compiled_code &);
+    vm68k_compiled_code &operator= (const vm68k_compiled_code &);
+
+  public:
+    /* Opens the shared object NAME, with the extension for the host if
+       it has none.  Returns false if it cannot be loaded or has no
+       image of this version.  */
+    bool open (const char *name);
+
+    /* Same as above but uses an image linked in the program.  */
+    void open (const vm68k_compiled_image *image);
+
+    /* Unbinds and closes the shared object.  */
+    void close ();
+
+    /* Enables the blocks of the pages whose code in function code FUNC
+       on BUS has the same hash as when compiled, and marks the code of
+       the blocks so that writes drop them.  Returns the number of
+       pages enabled.  BUS must outlive the binding.  */
+    std::size_t bind (vm68k_bus *bus, vm68k_bus::function_code func);
+
+    /* Disables all the blocks.  */
+    void unbind ();
+
+    /* Returns the number of pages in the image.  */
+    std::size_t page_count () const
+    {
+      return _image != NULL ? _image->page_count : 0;
+    }
+
+    /* Returns the number of pages enabled.  */
+    std::size_t enabled_page_count () const
+    {
+      return _enabled.size ();
+    }
+
+    /* Returns the enabled block at ADDR, or null.  */
+    vm68k_compiled_block find (vm68k_address_t addr) const
+    {
+      if (_table.empty ())
+        {
+          return NULL;
+        }
+
+      std::size_t mask = _table.size () - 1;
+      for (std::size_t i = (addr >> 1) * 0x9e3779b1U & mask; ;
+           i = (i + 1) & mask)
+        {
+          const slot &s = _table[i];
+          if (s.func == NULL || s.addr == addr)
+            {
+              return s.func;
+            }
+        }
+    }
+
+    /* Returns the count of the drops of blocks for
+       vm68k_compiled_frame::enter.  */
+    const unsigned long *drops () const
+    {
+      return &_drops;
+    }
+
+    void code_written (vm68k_bus::function_code func, vm68k_address_t addr,
+                       int size);
+
+  protected:
+    /* Rebuilds the lookup table from the enabled pages.  */
+    void rehash ();
+
+  private:
+    void *_handle;
+    const vm68k_compiled_image *_image;
+
+    vm68k_bus *_bus;
+
+    /* Indices of the enabled pages.  */
+    std::vector<uint_least32_t> _enabled;
+    unsigned long _drops;
+
+    /* Open addressing table of the enabled blocks.  */
+    struct slot
+    {
+      vm68k_address_t addr;
+      vm68k_compiled_block func;
+    };
+
+    std::vector<slot> _table;
+  };
+}
+
+#endif
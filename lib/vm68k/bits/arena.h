@@ -0,0 +1,92 @@
+/* -*-c++-*-
+ * arena - arena unit private header for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM68K_ARENA_H
+#define _VM68K_ARENA_H 1
+
+#include <cstddef>
+#include <new>
+
+namespace vx68k
+{
+  /**
+   * Allocator that takes memory in order from a buffer the caller
+   * supplies.  Nothing is freed until the arena is reset, so objects
+   * of a guest can be created without calling malloc and stay
+   * contiguous.  Buses take their page tables from an arena they are
+   * constructed with, and contexts allocate nothing by themselves.
+   */
+  class VM68K_PUBLIC vm68k_arena
+  {
+  public:
+    /* Alignment of allocated memory.  */
+    static const std::size_t ALIGNMENT = 16;
+
+  public:
+    /* Constructs an arena in SIZE bytes at BUFFER.  The buffer is not
+       owned by the arena.  */
+    vm68k_arena (void *buffer, std::size_t size);
+
+  private:
+    // XXX: These functions are left unimplemented.
+    vm68k_arena (const vm68k_arena &);
+    vm68k_arena &operator= (const vm68k_arena &);
+
+  public:
+    /* Allocates SIZE bytes.  std::bad_alloc is thrown if the arena is
+       full.  */
+    void *allocate (std::size_t size);
+
+    /* Returns the number of bytes allocated.  */
+    std::size_t used () const
+    {
+      return _used;
+    }
+
+    std::size_t size () const
+    {
+      return _size;
+    }
+
+    /* Frees all the memory allocated.  The objects in the arena must
+       be destroyed before.  */
+    void reset ()
+    {
+      _used = 0;
+    }
+
+  private:
+    unsigned char *_buffer;
+    std::size_t _size;
+    std::size_t _used;
+  };
+}
+
+/* Creates an object in arena ARENA as new (arena) T (...).  The object
+   must be destroyed by calling its destructor explicitly.  */
+inline void *operator new (std::size_t size, vx68k::vm68k_arena &arena)
+{
+  return arena.allocate (size);
+}
+
+/* Called only if a constructor throws in the expression above.  */
+inline void operator delete (void *, vx68k::vm68k_arena &)
+{
+}
+
+#endif
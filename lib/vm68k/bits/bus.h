@@ -19,6 +19,7 @@
 #ifndef _VM68K_BUS_H
 #define _VM68K_BUS_H 1
 
+#include <cstdio>
 #include <exception>
 #include <string>
 #include <vector>
@@ -128,18 +129,284 @@ namespace vx68k
                             uint_fast16_t value) throw (vm68k_bus_error);
       virtual void write32 (function_code func, vm68k_address_t addr,
                             uint_fast32_t value) throw (vm68k_bus_error);
+
+      /* Returns a host pointer to the byte at address ADDR, or null if
+         the page cannot be accessed directly.  The memory must hold
+         bytes in the guest order and be valid up to the end of the
+         page.  The default implementation returns null.  */
+      virtual unsigned char *direct (function_code func,
+                                     vm68k_address_t addr);
+    };
+
+    /* Write that is posted to a device.  */
+    struct posted_write
+    {
+      function_code func;
+      vm68k_address_t address;
+      uint_least32_t value;
+      /* Size of the write in bytes, either 1, 2 or 4.  */
+      uint_least8_t size;
+    };
+
+    /**
+     * Object that accepts posted writes.  Writes to this object are
+     * buffered by the bus and delivered in batches either at the end
+     * of an instruction slice, before a read from this object or
+     * before any access to a device mapped without posted writes.
+     * Writes to this object cannot cause a bus error.
+     */
+    class VM68K_PUBLIC posted_mappable : public mappable
+    {
+    public:
+      /* Delivers posted writes in the order they were made.  The
+         default implementation calls write8, write16 or write32 for
+         each of them.  */
+      virtual void write_batch (const posted_write *first,
+                                const posted_write *last);
+    };
+
+    /**
+     * Object that is put in front of the mappable of a page.  A filter
+     * sees every access to the page and forwards it to the next
+     * mappable by default.  Filters are kept when the page is mapped
+     * again.
+     */
+    class VM68K_PUBLIC filter : public mappable
+    {
+    public:
+      filter ();
+
+    public:
+      /* Returns the mappable this filter forwards accesses to.  */
+      mappable *next () const
+      {
+        return _next;
+      }
+
+    public:
+      uint_fast8_t read8 (function_code func, vm68k_address_t addr) const
+        throw (vm68k_bus_error);
+      uint_fast16_t read16 (function_code func, vm68k_address_t addr) const
+        throw (vm68k_bus_error);
+      uint_fast32_t read32 (function_code func, vm68k_address_t addr) const
+        throw (vm68k_bus_error);
+
+      void write8 (function_code func, vm68k_address_t addr,
+                   uint_fast8_t value) throw (vm68k_bus_error);
+      void write16 (function_code func, vm68k_address_t addr,
+                    uint_fast16_t value) throw (vm68k_bus_error);
+      void write32 (function_code func, vm68k_address_t addr,
+                    uint_fast32_t value) throw (vm68k_bus_error);
+
+    private:
+      friend class vm68k_bus;
+      mappable *_next;
+    };
+
+    /* Access types a watchpoint triggers on.  */
+    enum watch_type
+    {
+      WATCH_READ =   1,
+      WATCH_WRITE =  2,
+      WATCH_ACCESS = WATCH_READ | WATCH_WRITE,
+    };
+
+    /**
+     * Receiver of watchpoint hits.
+     */
+    class VM68K_PUBLIC watch_handler
+    {
+    public:
+      virtual ~watch_handler ();
+
+    public:
+      /* Called when an access of SIZE bytes at address ADDR overlaps
+         watchpoint ID.  A read is reported after it is made and a
+         write before it is made; VALUE is the value read or to be
+         written.  Watchpoints must not be removed from this
+         function.  */
+      virtual void hit (int id, function_code func, vm68k_address_t addr,
+                        int size, direction_code dir, uint_fast32_t value)
+        throw (vm68k_bus_error) = 0;
+    };
+
+    /**
+     * Receiver of faults the bus defers.
+     */
+    class VM68K_PUBLIC fault_handler
+    {
+    public:
+      virtual ~fault_handler ();
+
+    public:
+      /* Called on a bus error, or an address error if ADDRESS_ERROR is
+         true, in place of throwing an exception.  */
+      virtual void fault (bool address_error, uint_fast16_t status,
+                          vm68k_address_t addr) = 0;
+    };
+
+    /**
+     * Receiver of writes to code.
+     */
+    class VM68K_PUBLIC code_listener
+    {
+    public:
+      virtual ~code_listener ();
+
+    public:
+      /* Called after SIZE bytes at address ADDR are written over bytes
+         marked as code.  The marks of all the owners on the written
+         words are cleared before the call, so they must be set again
+         for code that is decoded again.  Listeners must not be added
+         or removed from this function.  */
+      virtual void code_written (function_code func, vm68k_address_t addr,
+                                 int size) = 0;
+    };
+
+  private:
+    class device_proxy;
+    class watch_filter;
+    class code_filter;
+    class count_filter;
+
+    /* Mappable for unmapped pages.  */
+    class null_mappable : public mappable
+    {
+    public:
+      explicit null_mappable (vm68k_bus *bus)
+      {
+        _bus = bus;
+      }
+
+    public:
+      uint_fast8_t read8 (function_code func, vm68k_address_t addr) const
+        throw (vm68k_bus_error);
+      uint_fast16_t read16 (function_code func, vm68k_address_t addr) const
+        throw (vm68k_bus_error);
+      uint_fast32_t read32 (function_code func, vm68k_address_t addr) const
+        throw (vm68k_bus_error);
+
+      void write8 (function_code func, vm68k_address_t addr,
+                   uint_fast8_t value) throw (vm68k_bus_error);
+      void write16 (function_code func, vm68k_address_t addr,
+                    uint_fast16_t value) throw (vm68k_bus_error);
+      void write32 (function_code func, vm68k_address_t addr,
+                    uint_fast32_t value) throw (vm68k_bus_error);
+
+    private:
+      vm68k_bus *_bus;
+    };
+
+    struct watchpoint
+    {
+      int id;
+      int func_mask;
+      vm68k_address_t address;
+      uint_fast32_t size;
+      int type;
+      watch_handler *handler;
     };
 
   public:
     vm68k_bus ();
+
+    /* Constructs a bus that takes its page tables from arena ARENA,
+       so that its construction allocates nothing from the heap.  */
+    explicit vm68k_bus (vm68k_arena *arena);
+
     ~vm68k_bus ();
 
+  private:
+    // XXX: These functions are left unimplemented.
+    vm68k_bus (const vm68k_bus &);
+    vm68k_bus &operator= (const vm68k_bus &);
+
   protected:
-    typedef std::vector<mappable *> page_table_type;
+    /* Table of the mappables of all the pages for a function code.
+       An empty table is for an unused function code.  */
+    class page_table_type
+    {
+    public:
+      typedef mappable **iterator;
+      typedef mappable *const *const_iterator;
+
+    public:
+      page_table_type ()
+      {
+        _pages = NULL;
+      }
+
+    public:
+      bool empty () const
+      {
+        return _pages == NULL;
+      }
+
+      iterator begin ()
+      {
+        return _pages;
+      }
+
+      iterator end ()
+      {
+        return _pages != NULL ? _pages + NPAGES : NULL;
+      }
+
+      const_iterator begin () const
+      {
+        return _pages;
+      }
+
+      const_iterator end () const
+      {
+        return _pages != NULL ? _pages + NPAGES : NULL;
+      }
+
+    private:
+      friend class vm68k_bus;
+      mappable **_pages;
+    };
+
   private:
-    mappable null_accessible;
+    /* Sets up the page tables with storage from ARENA, or from the
+       heap if it is null.  */
+    void initialize (vm68k_arena *arena);
+
+  private:
+    null_mappable null_accessible;
     page_table_type page_table[7];
 
+    /* Storage of the page tables, and the arena it came from or
+       null.  */
+    mappable **_page_storage;
+    vm68k_arena *_arena;
+
+    /* Handler of deferred faults, or null if faults throw.  */
+    fault_handler *_fault_handler;
+
+    /* Proxies of the devices, one for each.  */
+    std::vector<device_proxy *> _proxies;
+
+    /* Posted writes and their targets.  */
+    std::vector<posted_write> _posted;
+    std::vector<posted_mappable *> _posted_targets;
+    std::vector<posted_write>::size_type _posted_limit;
+
+    /* Watchpoints and the filters installed for them.  */
+    std::vector<watchpoint> _watchpoints;
+    std::vector<watch_filter *> _watch_filters;
+    int _last_watch_id;
+
+    /* Code listeners and the filters of the pages with code.  */
+    std::vector<code_listener *> _code_listeners;
+    std::vector<code_filter *> _code_filters;
+
+    /* Access counts for each page, and the filters installed while
+       counting.  */
+    std::vector<unsigned long> _read_counts[7];
+    std::vector<unsigned long> _write_counts[7];
+    std::vector<count_filter *> _count_filters;
+
   protected:
     /* Finds a page that contains address ADDR.  */
     page_table_type::iterator find_page (function_code func,
@@ -160,7 +427,152 @@ namespace vx68k
                     mappable *p);
     void unmap_pages (int func_mask, vm68k_address_t addr, uint_fast32_t size);
 
+    /* Fills an address range with a device that does not accept
+       posted writes.  The posted writes are delivered before each
+       access to it.  */
+    void map_device_pages (int func_mask, vm68k_address_t addr,
+                           uint_fast32_t size, mappable *p);
+
+    /* Fills an address range with a device that accepts posted
+       writes.  */
+    void map_posted_pages (int func_mask, vm68k_address_t addr,
+                           uint_fast32_t size, posted_mappable *p);
+
   public:
+    /* Delivers all the posted writes to their devices.  */
+    void flush_posted_writes ()
+    {
+      if (!_posted.empty ())
+        {
+          this->deliver_posted_writes ();
+        }
+    }
+
+    /* Sets the number of writes to buffer before they are delivered.
+       The default is 64.  */
+    void set_posted_write_limit (std::size_t limit);
+
+    /* Puts filter F in front of the page that contains address ADDR.
+       The filter is not owned by the bus.  */
+    void attach_filter (function_code func, vm68k_address_t addr, filter *f);
+
+    /* Removes filter F from the page that contains address ADDR.  */
+    void detach_filter (function_code func, vm68k_address_t addr, filter *f);
+
+    /* Sets a watchpoint on SIZE bytes at address ADDR for the function
+       codes in FUNC_MASK.  Only the pages the range covers are
+       filtered; accesses to other pages take no extra cost.  Returns
+       the watchpoint identifier.  */
+    int set_watchpoint (int func_mask, vm68k_address_t addr,
+                        uint_fast32_t size, int type, watch_handler *h);
+
+    /* Removes watchpoint ID.  */
+    void remove_watchpoint (int id);
+
+    /* Adds listener L of writes to code.  The listener is not owned by
+       the bus.  */
+    void add_code_listener (code_listener *l);
+
+    /* Removes listener L.  */
+    void remove_code_listener (code_listener *l);
+
+    /* Marks SIZE bytes at address ADDR as code for the function codes
+       in FUNC_MASK, which are usually the data ones that may write the
+       code.  Marks are kept for each word, so that a page can mix code
+       and data; only the pages with marks are filtered.  The marks
+       are also kept for each OWNER, which may be null, so that owners
+       can mark the same words.  */
+    void mark_code (int func_mask, vm68k_address_t addr, uint_fast32_t size,
+                    const code_listener *owner = NULL);
+
+    /* Clears the marks of OWNER on SIZE bytes at address ADDR.  The
+       marks of other owners are kept.  */
+    void unmark_code (int func_mask, vm68k_address_t addr,
+                      uint_fast32_t size, const code_listener *owner = NULL);
+
+    /* Returns true if the page that contains address ADDR has any word
+       marked as code.  */
+    bool code_page (function_code func, vm68k_address_t addr) const;
+
+    /* Tells the code listeners that SIZE bytes at address ADDR were
+       changed for the function codes in FUNC_MASK without a write
+       through the bus, as when memory is restored from a snapshot.
+       The marks are cleared and the listeners are called only for the
+       pages with words marked as code in the range.  */
+    void code_changed (int func_mask, vm68k_address_t addr,
+                       uint_fast32_t size);
+
+    /* Starts or stops counting the reads and writes to each page.
+       Counting filters are put on all the pages only while counting,
+       so that nothing is added to accesses otherwise.  The counts are
+       kept when counting stops.  */
+    void set_access_counting (bool counting);
+
+    bool access_counting () const
+    {
+      return !_count_filters.empty ();
+    }
+
+    /* Clears the access counts.  */
+    void reset_access_counts ();
+
+    /* Returns the number of reads from the page that contains address
+       ADDR.  */
+    unsigned long read_count (function_code func, vm68k_address_t addr) const;
+
+    /* Returns the number of writes to the page.  */
+    unsigned long write_count (function_code func,
+                               vm68k_address_t addr) const;
+
+    /* Writes the access counts to STREAM as a heatmap of text lines,
+       one for each page accessed, with the function code, the page
+       address, and the numbers of reads and writes.  */
+    void write_heatmap (std::FILE *stream) const;
+
+    /* Sets the handler of deferred faults.  While a handler is set,
+       unmapped pages and unaligned accesses report faults to it
+       instead of throwing exceptions; reads from unmapped pages return
+       zero and writes to them are dropped.  The handler must make the
+       instruction stop at the fault, as vm68k_context does, since the
+       value read is not data.  Faults thrown by devices are not
+       deferred.  A null pointer restores the default.  */
+    void set_fault_handler (fault_handler *h)
+    {
+      _fault_handler = h;
+    }
+
+  private:
+    /* Reports a fault to the handler if any, or throws it.  */
+    void fault (bool address_error, uint_fast16_t status,
+                vm68k_address_t addr) const;
+
+    void check_watchpoints (function_code func, vm68k_address_t addr,
+                            int size, direction_code dir, uint_fast32_t value)
+      throw (vm68k_bus_error);
+    bool watched (function_code func, std::size_t page) const;
+
+    code_filter *find_code_filter (function_code func,
+                                   std::size_t page) const;
+    void code_written (function_code func, vm68k_address_t addr, int size);
+
+    /* Returns the proxy of device P, which accepts posted writes if
+       POSTED is not null.  */
+    device_proxy *proxy (mappable *p, posted_mappable *posted);
+
+    void post (posted_mappable *p, function_code func, vm68k_address_t addr,
+               uint_fast32_t value, int size);
+    void deliver_posted_writes ();
+
+  public:
+    /* Returns a host pointer to the byte at address ADDR if its page
+       can be accessed directly, or null.  Filters, watchpoints and
+       posted writes make a page indirect.  */
+    unsigned char *direct (function_code func, vm68k_address_t addr)
+    {
+      mappable *p = *(this->find_page (func, addr));
+      return p->direct (func, addr);
+    }
+
     /* Returns one byte at address ADDR in this address space.  */
     uint_fast8_t read8 (function_code func, vm68k_address_t addr) const
       throw (vm68k_bus_error)
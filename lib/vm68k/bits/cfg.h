@@ -0,0 +1,144 @@
+/* -*-c++-*-
+ * cfg - control flow graph private header for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM68K_CFG_H
+#define _VM68K_CFG_H 1
+
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace vx68k
+{
+  /**
+   * Static control flow graph of guest code.  The code is copied from
+   * a bus and walked from the entry points with the disassembler, so
+   * only the instructions the decoder knows are followed.  Blocks end
+   * at branches, calls and returns, and before the targets of
+   * branches.  The targets of calls are taken as function entries.
+   * The graph can mark the code on the bus and give the operation word
+   * pairs to fuse before the guest runs.
+   */
+  class VM68K_PUBLIC vm68k_control_flow_graph
+  {
+  public:
+    /* Basic block.  FLOW is the control flow after the last
+       instruction, which is FLOW_NEXT if the block ends before the
+       target of a branch.  TARGET is only valid for the flows with a
+       target.  */
+    struct block
+    {
+      vm68k_address_t start;
+      vm68k_address_t end;
+      vm68k_address_t last;
+      vm68k_address_t target;
+      uint_least32_t size;
+      vm68k_instruction::flow_type flow;
+    };
+
+    typedef std::map<vm68k_address_t, block> block_map;
+
+  public:
+    /* Constructs an empty graph.  D is not owned by the graph.  */
+    explicit vm68k_control_flow_graph (const vm68k_disassembler *d);
+
+  public:
+    const vm68k_disassembler *disassembler () const
+    {
+      return _disassembler;
+    }
+
+    /* Copies SIZE bytes at address ADDR from BUS as code to walk.
+       Code outside the copied ranges is not followed.  */
+    void add_code (const vm68k_bus *bus, vm68k_bus::function_code func,
+                   vm68k_address_t addr, uint_fast32_t size);
+
+    /* Same as above but copies from host memory.  */
+    void add_code (vm68k_address_t addr, const unsigned char *data,
+                   std::size_t size);
+
+    /* Adds an entry point, which starts a function.  */
+    void add_entry (vm68k_address_t addr);
+
+    /* Walks the code from the entry points and builds the blocks and
+       functions anew.  */
+    void build ();
+
+    const block_map &blocks () const
+    {
+      return _blocks;
+    }
+
+    /* Returns the function entries, which are the entry points and the
+       targets of calls.  */
+    const std::set<vm68k_address_t> &functions () const
+    {
+      return _functions;
+    }
+
+    /* Appends the successors of block B to SUCCESSORS.  Calls are not
+       followed but their return is.  */
+    void successors (const block &b,
+                     std::vector<vm68k_address_t> &successors) const;
+
+    /* Appends the start addresses of the blocks of the function at
+       ENTRY to STARTS, in the order they are reached.  */
+    void function_blocks (vm68k_address_t entry,
+                          std::vector<vm68k_address_t> &starts) const;
+
+    /* Marks the code of the blocks on BUS for the function codes in
+       FUNC_MASK, so that writes to it are reported to the code
+       listeners.  */
+    void mark_code (vm68k_bus *bus, int func_mask) const;
+
+    /* Appends to PAIRS the operation words that follow each other in
+       the blocks, with the number of places each pair occurs at.  The
+       result can be given to vm68k_instruction_decoder::fuse to fuse
+       them before any profile is taken.  */
+    void pair_counts (std::vector<vm68k_instruction_decoder::pair_count>
+                      &pairs) const;
+
+    /* Writes the graph to STREAM in the DOT language of Graphviz.  The
+       blocks have their instructions as labels if TEXT is true.  */
+    void write_dot (std::FILE *stream, bool text) const;
+
+    /* Returns the image of the copied code that holds the word at
+       ADDR, which is empty if there is none.  */
+    vm68k_code_image find_image (vm68k_address_t addr) const;
+
+  private:
+    const vm68k_disassembler *_disassembler;
+
+    /* Copied code.  */
+    struct region
+    {
+      vm68k_address_t base;
+      std::vector<unsigned char> data;
+    };
+
+    std::vector<region> _code;
+
+    std::vector<vm68k_address_t> _entries;
+    block_map _blocks;
+    std::set<vm68k_address_t> _functions;
+  };
+}
+
+#endif
@@ -20,10 +20,12 @@
 #define _VM68K_CONTEXT_H 1
 
 #include <vector>
-#include <queue>
+#include <pthread.h>
 
 namespace vx68k
 {
+  class vm68k_journal;
+
   /* Abstruct base class for condition testers.  */
   class condition_tester
   {
@@ -136,6 +138,18 @@ namespace vx68k
 
     void set_cc_cmp(int_fast32_t, int_fast32_t, int_fast32_t);
     void set_cc_sub(int_fast32_t, int_fast32_t, int_fast32_t);
+
+    /* Sets only the X flag as ADD.  */
+    void set_x_as_add(int_fast32_t r, int_fast32_t d, int_fast32_t s)
+    {
+      x_eval = add_condition_tester;
+      x_values[0] = r;
+      x_values[1] = d;
+      x_values[2] = s;
+    }
+
+    /* Sets only the X flag as SUB.  */
+    void set_x_sub(int_fast32_t, int_fast32_t, int_fast32_t);
     void set_cc_asr(int_fast32_t, int_fast32_t, int_fast32_t);
     void set_cc_lsr(int_fast32_t r, int_fast32_t d, int_fast32_t s)
       {set_cc_asr(r, d, s);}
@@ -153,12 +167,19 @@ namespace vx68k
 
   /* Context of execution.  A context represents all the state of
      execution.  See also `class processor'.  */
-  class VM68K_PUBLIC vm68k_context
+  class VM68K_PUBLIC vm68k_context : private vm68k_bus::fault_handler
   {
   public:
     explicit vm68k_context (vm68k_bus *bus);
     ~vm68k_context ();
 
+  public:
+    /* Returns the bus of this context.  */
+    vm68k_bus *bus () const
+    {
+      return _bus;
+    }
+
   public:
     static vm68k_context *current_context ();
     static void set_current_context (vm68k_context *context);
@@ -256,32 +277,63 @@ namespace vx68k
     void store (const Size &, vm68k_address_t addr,
                 typename Size::udata_type value)
     {
+      ++_store_count;
+      if (_store_trace != NULL)
+        {
+          _store_trace->append (vm68k_trace_record::STORE,
+                                Size::data_size (), addr, value);
+        }
       return Size::write (_bus, dfc_cache, addr, value);
     }
 
+    /* The stack operations leave the stack pointer unchanged if a
+       deferred fault is pending after the access.  */
     template<class Size>
-    typename Size::udata_type pop_unsigned (const Size &) const
+    typename Size::udata_type pop_unsigned (const Size &)
     {
-      typename Size::uint_type value =
+      typename Size::udata_type value =
         Size::read_unsigned (_bus, dfc_cache, _named_reg.sp);
-      _named_reg.sp += Size::aligned_data_size ();
+      if (!this->fault_pending ())
+        {
+          _named_reg.sp += Size::aligned_data_size ();
+        }
       return value;
     }
 
     template<class Size>
-    typename Size::data_type pop (const Size &) const
+    typename Size::data_type pop (const Size &)
     {
       typename Size::data_type value =
         Size::read (_bus, dfc_cache, _named_reg.sp);
-      _named_reg.sp += Size::aligned_data_size ();
+      if (!this->fault_pending ())
+        {
+          _named_reg.sp += Size::aligned_data_size ();
+        }
       return value;
     }
 
     template<class Size>
     void push (const Size &, typename Size::udata_type value)
     {
-      _named_reg.sp -= Size::aligned_data_size ();
-      Size::write (_bus, dfc_cache, _named_reg.sp);
+      ++_store_count;
+      uint_least32_t sp = _named_reg.sp - Size::aligned_data_size ();
+      if (_store_trace != NULL)
+        {
+          _store_trace->append (vm68k_trace_record::STORE,
+                                Size::data_size (), sp, value);
+        }
+      Size::write (_bus, dfc_cache, sp, value);
+      if (!this->fault_pending ())
+        {
+          _named_reg.sp = sp;
+        }
+    }
+
+    /* Returns the number of stores made in this context.  It is used
+       to tell an idle loop from a busy one.  */
+    uint_fast32_t store_count () const
+    {
+      return _store_count;
     }
 
     template<class Size>
@@ -298,27 +350,414 @@ namespace vx68k
       return Size::read_inst (_bus, pfc_cache, addr);
     }
 
+    /* Returns the function code of data accesses.  */
+    vm68k_bus::function_code data_function_code () const
+    {
+      return dfc_cache;
+    }
+
   private:
     vm68k_bus *_bus;
 
     /* Cache values for program and data FC's.  */
     vm68k_bus::function_code dfc_cache, pfc_cache;
 
+    uint_least32_t _store_count;
+
+  public:			// trace
+    /* Returns the trace buffer of this context.  */
+    vm68k_trace_buffer *trace () const
+    {
+      return _trace;
+    }
+
+    /* Sets the trace buffer of this context.  A null pointer stops
+       tracing.  */
+    void set_trace (vm68k_trace_buffer *buffer);
+
+  private:
+    vm68k_trace_buffer *_trace;
+
+    /* Same as _trace if stores are traced, or null.  */
+    vm68k_trace_buffer *_store_trace;
+
+  public:
+    /* Returns the performance counter profile of this context.  */
+    vm68k_perf_profile *perf_profile () const
+    {
+      return _perf_profile;
+    }
+
+    /* Sets the performance counter profile of this context.  The
+       profile must be opened in the thread that runs the context.
+       It is not updated while tracing.  A null pointer stops
+       profiling.  */
+    void set_perf_profile (vm68k_perf_profile *profile)
+    {
+      _perf_profile = profile;
+    }
+
+  private:
+    vm68k_perf_profile *_perf_profile;
+
+  public:
+    /* Returns the journal of this context.  */
+    vm68k_journal *journal () const
+    {
+      return _journal;
+    }
+
+    /* Sets the journal of this context.  The journal must not be
+       changed while the context is running.  A null pointer stops
+       recording or replaying.  */
+    void set_journal (vm68k_journal *journal)
+    {
+      _journal = journal;
+    }
+
+  private:
+    vm68k_journal *_journal;
+
+  public:			// snapshot
+    /* Saved state of the processor.  */
+    struct snapshot
+    {
+      uint_least32_t reg[REGISTER_MAX];
+      uint_least32_t usp;
+      uint_least32_t ssp;
+      uint_least16_t status;
+      bool stopped;
+      uint_least32_t store_count;
+    };
+
+    /* Saves the registers and the stopped state to S.  Queued
+       interrupts are not saved.  */
+    void save (snapshot &s) const;
+
+    /* Restores the state saved to S, and drops queued interrupts.  */
+    void restore (const snapshot &s);
+
+  public:
+    /* Bits of the pending state.  The run loop tests them all at
+       once before each instruction.  */
+    enum
+    {
+      INTERRUPTED = 1U << 0,
+      STOPPED =     1U << 1,
+      STOP_REQUEST = 1U << 3,
+      FAULT =       1U << 4,
+      HOST_CALL =   1U << 5,
+    };
+
+    /* Returns the pending state bits.  */
+    unsigned int pending () const
+    {
+      return _pending;
+    }
+
+  private:
+    volatile unsigned int _pending;
+
   private:			// interrupt
-    /* True if the thread in this context is interrupted.  */
-    bool a_interrupted;
+    /* Mutex and condition for the interrupt queues and the pending
+       state.  */
+    pthread_mutex_t _mutex;
+    pthread_cond_t _cond;
+
+    /* Number of interrupts each priority level can queue.  */
+    static const unsigned int INTERRUPT_RING_SIZE = 16;
 
-    std::queue<uint_least8_t> interrupt_queue[7];
+    /* Fixed-capacity queue of the vector numbers of interrupts.  */
+    class interrupt_ring
+    {
+    public:
+      interrupt_ring ()
+      {
+        _head = 0;
+        _count = 0;
+      }
+
+    public:
+      bool empty () const
+      {
+        return _count == 0;
+      }
+
+      bool full () const
+      {
+        return _count == INTERRUPT_RING_SIZE;
+      }
+
+      uint_fast8_t front () const
+      {
+        return _vecno[_head];
+      }
+
+      void push (uint_fast8_t vecno)
+      {
+        _vecno[(_head + _count++) % INTERRUPT_RING_SIZE] = vecno;
+      }
+
+      void pop ()
+      {
+        _head = (_head + 1) % INTERRUPT_RING_SIZE;
+        --_count;
+      }
+
+      void clear ()
+      {
+        _head = 0;
+        _count = 0;
+      }
+
+    private:
+      uint_least8_t _vecno[INTERRUPT_RING_SIZE];
+      unsigned int _head;
+      unsigned int _count;
+    };
+
+    interrupt_ring interrupt_queue[7];
+
+    /* Number of interrupts dropped as their queue was full.  */
+    unsigned long _lost_interrupts;
+
+    /* Returns true if an interrupt can be accepted now.  The caller
+       must hold the mutex.  */
+    bool interrupt_acceptable () const;
 
   public:			// interrupt
     /* Returns true if the thread in this context is interrupted.  */
     bool interrupted () const
     {
-      return a_interrupted;
+      return (_pending & INTERRUPTED) != 0;
     }
 
-    /* Interrupts.  */
+    /* Interrupts.  This function can be called from any thread.
+       Interrupts are ignored while the journal is replaying.  */
     void interrupt (int priority, uint_fast8_t vecno);
+
+    /* Same as interrupt, but not ignored while replaying.  The
+       journal uses this function to replay interrupts.  */
+    void queue_interrupt (int priority, uint_fast8_t vecno);
+
+    /* Returns the number of interrupts dropped because
+       INTERRUPT_RING_SIZE interrupts were already queued at their
+       priority level.  */
+    unsigned long lost_interrupts () const
+    {
+      return _lost_interrupts;
+    }
+
+    /* Accepts the highest priority interrupt if the interrupt mask
+       allows, and returns the address to continue from.  */
+    vm68k_address_t handle_interrupts (vm68k_address_t pc);
+
+    /* Blocks the calling thread until an interrupt that can be
+       accepted arrives or a stop is requested.  While the journal is
+       replaying, a stop is requested instead of blocking, as no
+       interrupt can arrive.  */
+    void wait_interrupt ();
+
+  public:			// stop
+    /* Returns true if the processor is stopped by a STOP
+       instruction.  */
+    bool stopped () const
+    {
+      return (_pending & STOPPED) != 0;
+    }
+
+    /* Stops the processor until the next interrupt.  */
+    void stop ();
+
+  public:			// breakpoint
+    /* Reasons why a run returned.  */
+    enum stop_reason_type
+    {
+      STOP_NONE,
+      STOP_BREAKPOINT,
+      STOP_REQUESTED,
+      STOP_FAULT,
+    };
+
+    /* Returns the reason why the last run returned.  STOP_NONE means
+       the run used up its instruction count.  */
+    stop_reason_type stop_reason () const
+    {
+      return _stop_reason;
+    }
+
+    void set_stop_reason (stop_reason_type reason)
+    {
+      _stop_reason = reason;
+    }
+
+    /* Notes that a host call stub was executed.  */
+    void trap_host_call ();
+
+    /* Returns true and clears the note if a host call stub was
+       executed.  */
+    bool host_call_trapped ();
+
+    /* Requests the run loop to return before the next instruction
+       with the stop reason STOP_REQUESTED.  This function can be
+       called from any thread.  */
+    void request_stop ();
+
+    /* Returns true and clears the request if a stop is requested.  */
+    bool stop_requested ();
+
+  private:
+    stop_reason_type _stop_reason;
+
+  public:			// fusion
+    /* Returns true if a fused instruction handler may execute the
+       following instruction in the same dispatch.  The run loop
+       clears it while tracing, while breakpoints are set, and for the
+       last instruction of a slice.  */
+    bool fusible () const
+    {
+      return _fusible;
+    }
+
+    void set_fusible (bool fusible)
+    {
+      _fusible = fusible;
+    }
+
+  private:
+    bool _fusible;
+
+  public:			// fault
+    /* Makes the bus defer faults to this context while the run loop
+       runs in it.  A deferred fault makes the run loop return with the
+       stop reason STOP_FAULT after the faulting instruction, without a
+       C++ exception.  The instruction stops at the fault and changes
+       no registers, memory or flags after it.  The run returns the
+       address of that instruction.  Accesses the host makes outside
+       the run loop still throw.  */
+    void set_deferred_faults (bool deferred);
+
+    /**
+     * Makes the bus of a context defer faults to it while this object
+     * lives, if the context has deferred faults.  The run loop makes
+     * one for the duration of a run.
+     */
+    class deferred_fault_guard
+    {
+    public:
+      explicit deferred_fault_guard (vm68k_context &c)
+      {
+        _bus = c._deferred_faults ? c._bus : NULL;
+        if (_bus != NULL)
+          {
+            _bus->set_fault_handler (&c);
+          }
+      }
+
+      ~deferred_fault_guard ()
+      {
+        if (_bus != NULL)
+          {
+            _bus->set_fault_handler (NULL);
+          }
+      }
+
+    private:
+      // XXX: These functions are left unimplemented.
+      deferred_fault_guard (const deferred_fault_guard &);
+      deferred_fault_guard &operator= (const deferred_fault_guard &);
+
+    private:
+      vm68k_bus *_bus;
+    };
+
+    /* Returns true and clears the note if a fault was deferred.  */
+    bool faulted ();
+
+    /* Returns true if a fault was deferred and not yet handled.  The
+       instruction handlers test it after their bus accesses.  */
+    bool fault_pending () const
+    {
+      return (_pending & FAULT) != 0;
+    }
+
+    /* Returns true if the last deferred fault was an address error.  */
+    bool fault_address_error () const
+    {
+      return _fault_address_error;
+    }
+
+    /* Returns the status of the last deferred fault.  */
+    uint_fast16_t fault_status () const
+    {
+      return _fault_status;
+    }
+
+    /* Returns the access address of the last deferred fault.  */
+    vm68k_address_t fault_address () const
+    {
+      return _fault_address;
+    }
+
+  private:
+    void fault (bool address_error, uint_fast16_t status,
+                vm68k_address_t addr);
+
+  public:			// exception
+    /* Makes the run loop process exceptions in this context as the
+       processor does instead of letting them escape as C++
+       exceptions.  */
+    void set_exception_processing (bool processing)
+    {
+      _exception_processing = processing;
+    }
+
+    bool exception_processing () const
+    {
+      return _exception_processing;
+    }
+
+    /* Processes exception VECNO with PC as the return address, and
+       returns the address of the exception handler.  */
+    vm68k_address_t take_exception (uint_fast16_t vecno, vm68k_address_t pc);
+
+    /* Processes a bus or address error with the extended frame.  PC
+       and IR are the address and operation word of the instruction,
+       and STATUS and ADDR are of the faulting access.  */
+    vm68k_address_t take_group0_exception (uint_fast16_t vecno,
+                                           vm68k_address_t pc,
+                                           uint_fast16_t ir,
+                                           uint_fast16_t status,
+                                           vm68k_address_t addr);
+
+    /* Makes vector fetches use a copy of the vector table.  The copy
+       is invalidated on any write to page 0 through the bus.  */
+    void set_vector_cache (bool cached);
+
+    /* Invalidates the copy of the vector table.  It must be called
+       after page 0 is changed without the bus.  */
+    void invalidate_vectors ()
+    {
+      _vectors_valid = false;
+    }
+
+  private:
+    class vector_filter;
+
+    /* Returns exception vector VECNO.  */
+    vm68k_address_t vector (uint_fast16_t vecno);
+
+  private:
+    bool _exception_processing;
+    vector_filter *_vector_filters[7];
+    bool _vectors_valid;
+    uint_least32_t _vectors[256];
+
+  private:
+    bool _deferred_faults;
+    bool _fault_address_error;
+    uint_least16_t _fault_status;
+    vm68k_address_t _fault_address;
   };
 }
 
@@ -0,0 +1,181 @@
+/* -*-c++-*-
+ * disasm - disassembler private header for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM68K_DISASM_H
+#define _VM68K_DISASM_H 1
+
+#include <cstddef>
+
+namespace vx68k
+{
+  /**
+   * Guest code copied into host memory, such as a memory dump that
+   * goes with a saved trace.  Words outside the image read as zero.
+   */
+  class VM68K_PUBLIC vm68k_code_image
+  {
+  public:
+    vm68k_code_image (vm68k_address_t base, const unsigned char *data,
+                      std::size_t size)
+      : _base (base),
+        _data (data),
+        _size (size)
+    {
+    }
+
+  public:
+    vm68k_address_t base () const
+    {
+      return _base;
+    }
+
+    const unsigned char *data () const
+    {
+      return _data;
+    }
+
+    std::size_t size () const
+    {
+      return _size;
+    }
+
+    /* Returns true if the image holds the SIZE bytes at ADDR.  */
+    bool contains (vm68k_address_t addr, std::size_t size) const
+    {
+      vm68k_address_t offset = (addr - _base) & 0xffffffffU;
+      return offset <= _size && _size - offset >= size;
+    }
+
+    /* Returns the unsigned word at ADDR.  */
+    uint_fast16_t fetch_word (vm68k_address_t addr) const
+    {
+      if (!this->contains (addr, 2))
+        {
+          return 0;
+        }
+      const unsigned char *p = _data + ((addr - _base) & 0xffffffffU);
+      return uint_fast16_t (p[0]) << 8 | p[1];
+    }
+
+    /* Returns the unsigned long word at ADDR.  */
+    uint_fast32_t fetch_long_word (vm68k_address_t addr) const
+    {
+      return uint_fast32_t (this->fetch_word (addr)) << 16
+        | this->fetch_word (addr + 2);
+    }
+
+  private:
+    vm68k_address_t _base;
+    const unsigned char *_data;
+    std::size_t _size;
+  };
+
+  /**
+   * Disassembler that writes instructions as text in the MIT syntax of
+   * GNU as.  It is built from the same instruction tables as the
+   * decoder, so it knows exactly the instructions the executor runs;
+   * the other operation words are written as data.  Nothing is
+   * allocated while disassembling.
+   */
+  class VM68K_PUBLIC vm68k_disassembler
+  {
+  public:
+    /* Size of a buffer that holds the text of any instruction with
+       the terminating null character.  */
+    static const std::size_t TEXT_MAX = 80;
+
+  private:
+    static void insert_inst1 (vm68k_disassembler *p);
+    static void insert_inst2 (vm68k_disassembler *p);
+    static void insert_inst3 (vm68k_disassembler *p);
+    static void insert_inst4 (vm68k_disassembler *p);
+    static void insert_inst5 (vm68k_disassembler *p);
+    static void insert_inst6 (vm68k_disassembler *p);
+    static void insert_inst10 (vm68k_disassembler *p);
+    static void insert_inst11 (vm68k_disassembler *p);
+    static void insert_inst15 (vm68k_disassembler *p);
+
+  public:
+    vm68k_disassembler ();
+    ~vm68k_disassembler ();
+
+  private:
+    // XXX: These functions are left unimplemented.
+    vm68k_disassembler (const vm68k_disassembler &);
+    vm68k_disassembler &operator= (const vm68k_disassembler &);
+
+  public:
+    void insert (const vm68k_instruction_decoder::spec &s);
+
+    template<typename InputIterator>
+    void insert (InputIterator first, InputIterator last)
+    {
+      while (first != last)
+        {
+          this->insert (*first++);
+        }
+    }
+
+    /* Returns true if operation word W is a known instruction.  */
+    bool known (uint_fast16_t w) const
+    {
+      return _text[w & 0xffffU] != NULL;
+    }
+
+    /* Writes the text of the instruction at ADDR in CODE to P, which
+       must have room for TEXT_MAX characters, without the terminating
+       null character.  Returns the address of the next instruction,
+       and advances P past the text.  */
+    vm68k_address_t write (const vm68k_code_image &code,
+                           vm68k_address_t addr, char *&p) const;
+
+    /* Writes the text of the instruction at ADDR in CODE to BUF of
+       SIZE characters, which is null-terminated and truncated if it
+       does not fit.  Returns the address of the next instruction.  */
+    vm68k_address_t disassemble (const vm68k_code_image &code,
+                                 vm68k_address_t addr,
+                                 char *buf, std::size_t size) const;
+
+    /* Writes a line for each instruction from ADDR up to END in CODE
+       to BUF of SIZE characters, with the address, a tab and the
+       text.  It stops before the instruction whose line may not fit,
+       and sets *LENGTH to the number of characters written, without
+       the terminating null character.  Returns the address of the
+       first instruction that is not written.  */
+    vm68k_address_t disassemble_range (const vm68k_code_image &code,
+                                       vm68k_address_t addr,
+                                       vm68k_address_t end,
+                                       char *buf, std::size_t size,
+                                       std::size_t *length) const;
+
+    /* Returns the control flow after the instruction at ADDR in CODE.
+       NEXT is set to the address of the next instruction, and TARGET
+       to the address the flow goes to if it is known before run
+       time.  */
+    vm68k_instruction::flow_type flow (const vm68k_code_image &code,
+                                       vm68k_address_t addr,
+                                       vm68k_address_t &next,
+                                       vm68k_address_t &target) const;
+
+  private:
+    vm68k_instruction::text_function *_text;
+    vm68k_instruction::flow_function *_flow;
+  };
+}
+
+#endif
@@ -0,0 +1,105 @@
+/* -*-c++-*-
+ * gdbstub - debugger stub private header for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM68K_GDBSTUB_H
+#define _VM68K_GDBSTUB_H 1
+
+#include <string>
+#include <map>
+
+namespace vx68k
+{
+  /**
+   * Stub for the GDB remote serial protocol.  A debugger connects to
+   * the stub through a TCP socket on the loopback interface or a
+   * Unix-domain socket.  The program runs at full speed while the
+   * debugger lets it continue; only a separate thread watches the
+   * connection for a break.
+   */
+  class VM68K_PUBLIC vm68k_gdbstub : private vm68k_bus::watch_handler
+  {
+  public:
+    /* Register numbers in the protocol.  */
+    enum
+    {
+      REGISTER_SR = 16,
+      REGISTER_PC = 17,
+      REGISTER_COUNT
+    };
+
+  public:
+    vm68k_gdbstub (vm68k_instruction_decoder *decoder, vm68k_context *c);
+    ~vm68k_gdbstub ();
+
+  private:
+    // XXX: These functions are left unimplemented.
+    vm68k_gdbstub (const vm68k_gdbstub &);
+    vm68k_gdbstub &operator= (const vm68k_gdbstub &);
+
+  public:
+    /* Listens on TCP port PORT of the loopback interface.  Returns
+       false on failure.  */
+    bool listen_tcp (int port);
+
+    /* Listens on the Unix-domain socket at PATH.  Returns false on
+       failure.  */
+    bool listen_unix (const char *path);
+
+    /* Accepts a debugger and serves it with the program stopped at
+       PC.  Returns the address to continue from when the debugger
+       detaches or kills the program, or when the connection is
+       lost.  */
+    vm68k_address_t serve (vm68k_address_t pc);
+
+  private:
+    /* Handles a packet and returns the reply.  Returns false when the
+       session ends.  */
+    bool handle (const std::string &packet, std::string &reply);
+
+    /* Runs the program and returns the stop reply.  */
+    std::string resume (bool step);
+
+    bool receive (std::string &packet);
+    bool send (const std::string &packet);
+
+    uint_fast32_t read_register (int regno) const;
+    void write_register (int regno, uint_fast32_t value);
+
+    void hit (int id, vm68k_bus::function_code func, vm68k_address_t addr,
+              int size, vm68k_bus::direction_code dir, uint_fast32_t value)
+      throw (vm68k_bus_error);
+
+  private:
+    vm68k_instruction_decoder *_decoder;
+    vm68k_context *_context;
+
+    int _listener;
+    int _connection;
+    std::string _path;
+
+    vm68k_address_t _pc;
+    bool _running;
+
+    /* Watchpoints by their kind and address, and the last hit.  */
+    std::map<std::pair<int, vm68k_address_t>, int> _watchpoints;
+    int _watch_kind;
+    vm68k_address_t _watch_address;
+  };
+}
+
+#endif
@@ -0,0 +1,200 @@
+/* -*-c++-*-
+ * history - reverse execution private header for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM68K_HISTORY_H
+#define _VM68K_HISTORY_H 1
+
+#include <cstddef>
+#include <ctime>
+#include <deque>
+#include <vector>
+
+namespace vx68k
+{
+  /**
+   * Execution history of a context that can be stepped back.  Runs
+   * through the history take checkpoints of the context and of the
+   * memory pages written since the last checkpoint, and record device
+   * reads and interrupts in a journal.  Going back restores the
+   * nearest earlier checkpoint and replays forward from it.  The
+   * checkpoint interval follows the measured speed so that any step
+   * back replays for about the step time at most.
+   *
+   * The history sets its journal to the context while it exists.
+   */
+  class VM68K_PUBLIC vm68k_history
+  {
+  public:
+    /* Default step time in seconds.  */
+    static const double DEFAULT_STEP_TIME;
+
+    /* Default limit of the memory for saved pages.  */
+    static const std::size_t DEFAULT_MEMORY_LIMIT = 256U << 20;
+
+    /* Bounds of the checkpoint interval in instructions.  */
+    static const unsigned long MIN_INTERVAL = 1000;
+    static const unsigned long MAX_INTERVAL = 100000000;
+
+  private:
+    class page_filter;
+    class watch_recorder;
+
+    /* Memory page that is saved before its first write after a
+       checkpoint.  */
+    struct memory_page
+    {
+      vm68k_address_t address;
+      /* Mappable of the memory under the filters of the bus.  */
+      vm68k_bus::mappable *base;
+      std::vector<page_filter *> filters;
+      bool armed;
+    };
+
+    struct checkpoint
+    {
+      unsigned long long count;
+      std::vector<vm68k_journal::event>::size_type position;
+      vm68k_address_t pc;
+      vm68k_context::snapshot state;
+      /* Indices and contents of the pages first written after this
+         checkpoint.  */
+      std::vector<std::size_t> pages;
+      std::vector<unsigned char> data;
+    };
+
+  public:
+    vm68k_history (const vm68k_instruction_decoder *decoder,
+                   vm68k_context *c);
+    ~vm68k_history ();
+
+  private:
+    // XXX: These functions are left unimplemented.
+    vm68k_history (const vm68k_history &);
+    vm68k_history &operator= (const vm68k_history &);
+
+  public:
+    const vm68k_journal &journal () const
+    {
+      return _journal;
+    }
+
+    /* Adds SIZE bytes of RAM at address ADDR for the function codes
+       in FUNC_MASK, which must all map the same memory.  Only the
+       added memory is restored when going back.  The memory must not
+       be mapped again while the history exists.  */
+    void add_memory (int func_mask, vm68k_address_t addr,
+                     uint_fast32_t size);
+
+    /* Adds SIZE bytes of a device at address ADDR for the function
+       codes in FUNC_MASK.  Reads from it are recorded.  */
+    void add_device (int func_mask, vm68k_address_t addr,
+                     uint_fast32_t size)
+    {
+      _journal.add_device (_context->bus (), func_mask, addr, size);
+    }
+
+    /* Sets the time a step back may take for replaying.  */
+    void set_step_time (double seconds)
+    {
+      _step_time = seconds;
+    }
+
+    /* Sets the limit of the memory for saved pages.  The oldest
+       checkpoints are dropped to keep under it.  */
+    void set_memory_limit (std::size_t limit)
+    {
+      _memory_limit = limit;
+    }
+
+    /* Returns the current checkpoint interval in instructions.  */
+    unsigned long interval () const
+    {
+      return _interval;
+    }
+
+    std::size_t checkpoint_count () const
+    {
+      return _checkpoints.size ();
+    }
+
+    /* Returns the number of instructions executed in the history.  */
+    unsigned long long position () const
+    {
+      return _journal.instruction_count ();
+    }
+
+    /* Returns the earliest position that can be gone back to.  */
+    unsigned long long first_position () const
+    {
+      return _checkpoints.empty () ? 0 : _checkpoints.front ().count;
+    }
+
+    /* Runs as vm68k_instruction_decoder::run, taking checkpoints.  */
+    vm68k_address_t run (vm68k_address_t pc, unsigned long count);
+
+    /* Goes back N instructions, or to the first position, and returns
+       the address of the next instruction.  */
+    vm68k_address_t step_back (unsigned long long n);
+
+    /* Goes back to just before the last access of TYPE to SIZE bytes
+       at address ADDR for the function codes in FUNC_MASK, and sets PC
+       to the address of the instruction that made it.  Returns false
+       at the first position if no access is found.  */
+    bool reverse_to_watchpoint (int func_mask, vm68k_address_t addr,
+                                uint_fast32_t size, int type,
+                                vm68k_address_t &pc);
+
+  protected:
+    /* Saves page I to the last checkpoint before it is written.  */
+    void page_written (std::size_t i);
+
+    void arm (std::size_t i);
+
+    void take_checkpoint (vm68k_address_t pc);
+
+    /* Restores checkpoint K and drops the later ones.  */
+    void restore (std::deque<checkpoint>::size_type k);
+
+    /* Runs forward to position TARGET.  */
+    void replay_to (unsigned long long target);
+
+  private:
+    const vm68k_instruction_decoder *_decoder;
+    vm68k_context *_context;
+    vm68k_journal _journal;
+
+    std::vector<memory_page> _pages;
+
+    /* Pages written since the last checkpoint.  */
+    std::vector<std::size_t> _dirty;
+
+    std::deque<checkpoint> _checkpoints;
+    std::size_t _saved_bytes;
+    std::size_t _memory_limit;
+
+    vm68k_address_t _pc;
+    unsigned long _interval;
+    double _step_time;
+
+    /* Instructions and processor time since the last checkpoint.  */
+    unsigned long long _run_count;
+    std::clock_t _run_time;
+  };
+}
+
+#endif
@@ -0,0 +1,251 @@
+/* -*-c++-*-
+ * journal - record and replay private header for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM68K_JOURNAL_H
+#define _VM68K_JOURNAL_H 1
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace vx68k
+{
+  /**
+   * Log of the nondeterministic inputs to a run, which are reads from
+   * devices, accepted interrupts and the effects of host calls, keyed
+   * by the number of instructions executed.  A run with a recording
+   * journal can be reproduced exactly by a run from the same state
+   * with the journal replaying.  While replaying, device pages are
+   * not read, interrupts from outside are ignored, and host functions
+   * are not called.
+   *
+   * Host functions must write guest memory through the context for
+   * their stores to be recorded.  Fused handlers are not used, and
+   * tracing and profiling are not done, while a journal is set to the
+   * context.
+   */
+  class VM68K_PUBLIC vm68k_journal
+  {
+  public:
+    enum mode_type
+    {
+      RECORDING = 0,
+      REPLAYING = 1,
+    };
+
+    /* Kinds of events.  */
+    enum kind_type
+    {
+      /* ADDRESS and VALUE are of a read of SIZE bytes from a
+         device.  */
+      READ =          0,
+      /* ADDRESS is the priority and VALUE is the vector number.  */
+      INTERRUPT =     1,
+      /* ADDRESS and VALUE are of a store of SIZE bytes by a host
+         function.  */
+      HOST_STORE =    2,
+      /* ADDRESS is the register number and VALUE is the new value
+         after a host function.  Register number
+         vm68k_trace_record::REGISTER_SR is for the status register.  */
+      HOST_REGISTER = 3,
+      /* VALUE is the address a host function returned.  */
+      HOST_RETURN =   4,
+      /* ADDRESS is of a read of SIZE bytes from a device that caused
+         a bus error.  */
+      READ_ERROR =    5,
+      /* VALUE is the number of stores a host function made beyond
+         HOST_STORE_MAX.  It comes first among the events of the call,
+         which has no HOST_STORE or HOST_REGISTER events, and the host
+         function is called again when it is replayed.  */
+      HOST_LOST =     6,
+    };
+
+    /* Number of stores of a host function that can be replayed.  */
+    static const std::size_t HOST_STORE_MAX = 1U << 16;
+
+    struct event
+    {
+      unsigned long long count;
+      uint_least32_t address;
+      uint_least32_t value;
+      uint_least8_t kind;
+      uint_least8_t size;
+    };
+
+  private:
+    class device_filter;
+
+  public:
+    /* Constructs an empty journal that is recording.  */
+    vm68k_journal ();
+    ~vm68k_journal ();
+
+  private:
+    // XXX: These functions are left unimplemented.
+    vm68k_journal (const vm68k_journal &);
+    vm68k_journal &operator= (const vm68k_journal &);
+
+  public:
+    mode_type mode () const
+    {
+      return _mode;
+    }
+
+    bool replaying () const
+    {
+      return _mode == REPLAYING;
+    }
+
+    /* Clears the events and starts recording.  */
+    void start_recording ();
+
+    /* Starts replaying the events from the first one.  */
+    void start_replay ();
+
+    /* Replays the events from the one at POSITION with the
+       instruction count set to COUNT, which must be the position and
+       the count at an earlier point of the run.  If the journal was
+       recording, it goes back to recording where the events end.  */
+    void rewind (std::vector<event>::size_type position,
+                 unsigned long long count);
+
+    /* Returns the number of events recorded or replayed.  */
+    std::vector<event>::size_type position () const
+    {
+      return _mode == RECORDING ? _events.size () : _next;
+    }
+
+    /* Returns the number of instructions executed since recording or
+       replaying started.  */
+    unsigned long long instruction_count () const
+    {
+      return _count;
+    }
+
+    /* Returns true if a replayed run did not match the events.  */
+    bool diverged () const
+    {
+      return _diverged;
+    }
+
+    const std::vector<event> &events () const
+    {
+      return _events;
+    }
+
+    /* Puts filters on the pages in SIZE bytes at address ADDR of BUS,
+       so that the reads from them are recorded or replayed.  The
+       filters are removed when the journal is destroyed.  */
+    void add_device (vm68k_bus *bus, int func_mask, vm68k_address_t addr,
+                     uint_fast32_t size);
+
+    /* Removes all the device filters.  */
+    void remove_devices ();
+
+    /* Writes the events to STREAM in a compact binary form.  */
+    bool save (std::FILE *stream) const;
+
+    /* Reads events written by save from STREAM.  The journal is left
+       recording; start_replay must be called to replay them.  */
+    bool load (std::FILE *stream);
+
+  public:
+    /* Counts an instruction executed in context C, and queues the
+       interrupts due after it.  Called by the run loop.  */
+    void instruction (vm68k_context &c)
+    {
+      ++_count;
+      this->resume (c);
+    }
+
+    /* Queues the interrupts due before the next instruction in context
+       C.  Called at the start of a run.  */
+    void resume (vm68k_context &c)
+    {
+      if (_count == _next_interrupt)
+        {
+          this->deliver_interrupts (c);
+        }
+    }
+
+    /* Records an interrupt accepted by a context.  */
+    void interrupt_accepted (int priority, uint_fast8_t vecno)
+    {
+      if (_mode == RECORDING)
+        {
+          this->append (INTERRUPT, 0, priority, vecno);
+        }
+    }
+
+    /* Calls host function CALL for operation word W at PC in context
+       C, recording its effects, or replays them without calling it.
+       Reads from devices by the host function are recorded among its
+       events and skipped when they are replayed.  Returns the address
+       of the next instruction.  */
+    vm68k_address_t call_host (vm68k_host_call &call, vm68k_address_t pc,
+                               uint_fast16_t w, vm68k_context &c);
+
+  protected:
+    void append (int kind, int size, uint_fast32_t address,
+                 uint_fast32_t value)
+    {
+      event e;
+      e.count = _count;
+      e.address = address;
+      e.value = value;
+      e.kind = kind;
+      e.size = size;
+      _events.push_back (e);
+    }
+
+    /* Returns the value of a read of SIZE bytes from DEVICE, recording
+       it or taking it from the events.  */
+    uint_fast32_t read (const vm68k_bus::mappable *device,
+                        vm68k_bus::function_code func, vm68k_address_t addr,
+                        int size);
+
+    /* Returns the next event if it is of kind KIND, or null.  A
+       mismatch makes the replay diverged.  */
+    const event *next_event (int kind);
+
+    void deliver_interrupts (vm68k_context &c);
+
+    /* Sets _next_interrupt to the count of the next interrupt, or of
+       the end of a rewound recording.  */
+    void find_next_interrupt ();
+
+  private:
+    mode_type _mode;
+    std::vector<event> _events;
+    std::vector<event>::size_type _next;
+    unsigned long long _count;
+    unsigned long long _next_interrupt;
+    bool _diverged;
+
+    /* True if recording is resumed at count _end.  */
+    bool _rewound;
+    unsigned long long _end;
+
+    std::vector<device_filter *> _filters;
+
+    /* Records stores by host functions.  */
+    vm68k_trace_buffer _stores;
+  };
+}
+
+#endif
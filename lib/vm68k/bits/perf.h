@@ -0,0 +1,147 @@
+/* -*-c++-*-
+ * perf - host performance counter private header for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM68K_PERF_H
+#define _VM68K_PERF_H 1
+
+#include <cstddef>
+#include <cstdio>
+
+namespace vx68k
+{
+  /**
+   * Host performance counters attributed to the groups of instruction
+   * handlers, which are selected by the high four bits of the
+   * operation word.  The counters are read with one system call
+   * where the group changes, so that a run of instructions of the same
+   * group is counted as a whole, with the run loop between them.  Only
+   * the host user mode is counted, and the absolute numbers include
+   * some cost of the reads themselves and are best compared between
+   * groups.  Only Linux perf events are supported.
+   */
+  class VM68K_PUBLIC vm68k_perf_profile
+  {
+  public:
+    /* Counted events.  */
+    enum event_type
+    {
+      CYCLES =        0,
+      INSTRUCTIONS =  1,
+      BRANCH_MISSES = 2,
+      L1D_MISSES =    3,
+      EVENT_MAX
+    };
+
+    /* Number of handler groups.  */
+    static const int GROUP_MAX = 16;
+
+  public:
+    vm68k_perf_profile ();
+    ~vm68k_perf_profile ();
+
+  private:
+    // XXX: These functions are left unimplemented.
+    vm68k_perf_profile (const vm68k_perf_profile &);
+    vm68k_perf_profile &operator= (const vm68k_perf_profile &);
+
+  public:
+    /* Opens the counters for the calling thread.  Returns false if
+       the host cannot count the cycles, in which case the profile
+       stays closed.  The other events are left out if they are not
+       available.  */
+    bool open ();
+
+    /* Closes the counters.  */
+    void close ();
+
+    bool is_open () const
+    {
+      return _fds[CYCLES] >= 0;
+    }
+
+    /* Returns true if event E is counted.  */
+    bool counted (event_type e) const
+    {
+      return _fds[e] >= 0;
+    }
+
+    /* Clears the counts.  */
+    void reset ();
+
+    /* Counts an instruction of operation word W.  The counters are
+       read only if its group differs from that of the last one.  */
+    void start (uint_fast16_t w)
+    {
+      int group = w >> 12 & 0xf;
+      if (group != _group)
+        {
+          this->switch_group (group);
+        }
+      ++_span;
+    }
+
+    /* Reads the counters and adds the differences to the group of the
+       last instructions.  Called at the end of a run.  */
+    void stop ()
+    {
+      this->switch_group (-1);
+    }
+
+    /* Returns the number of instructions counted for group G.  */
+    unsigned long long count (int group) const
+    {
+      return _count[group];
+    }
+
+    /* Returns the counted value of event E for group G.  */
+    unsigned long long value (int group, event_type e) const
+    {
+      return _values[group][e];
+    }
+
+    /* Writes a report to STREAM with the groups that caused the most
+       cycles first.  */
+    void report (std::FILE *stream) const;
+
+  protected:
+    /* Reads the current values into V.  Returns false on error.  */
+    bool read (unsigned long long *v) const;
+
+    /* Adds the counts since the last read to the current group, and
+       starts counting for GROUP, or stops if it is -1.  */
+    void switch_group (int group);
+
+  private:
+    int _fds[EVENT_MAX];
+
+    /* Index of each event in a group read.  */
+    int _index[EVENT_MAX];
+    int _nr;
+
+    /* Group of the last instructions, or -1, the number of them, and
+       the values read before the first.  */
+    int _group;
+    unsigned long long _span;
+    unsigned long long _start[EVENT_MAX];
+
+    unsigned long long _count[GROUP_MAX];
+    unsigned long long _values[GROUP_MAX][EVENT_MAX];
+  };
+}
+
+#endif
@@ -19,10 +19,19 @@
 #ifndef _VM68K_PROCESSOR_H
 #define _VM68K_PROCESSOR_H 1
 
+#include <cstddef>
+#include <cstdio>
 #include <exception>
+#include <map>
+#include <set>
+#include <vector>
 
 namespace vx68k
 {
+  class vm68k_code_image;
+  class vm68k_compiled_code;
+  class vm68k_translation_cache;
+
   /* Base class of processor exceptions.  */
   class VM68K_PUBLIC vm68k_exception : public std::exception
   {
@@ -132,6 +141,25 @@ namespace vx68k
   {
   }
 
+  /* Exception an instruction takes by itself, such as TRAP.  */
+  class VM68K_PUBLIC vm68k_trap_exception : public vm68k_exception
+  {
+  public:
+    vm68k_trap_exception (vm68k_address_t pc, uint_fast16_t vecno)
+      : vm68k_exception (pc)
+    {
+      _vecno = vecno;
+    }
+
+    uint_fast16_t vecno () const throw ()
+    {
+      return _vecno;
+    }
+
+  private:
+    uint_least16_t _vecno;
+  };
+
   class VM68K_PUBLIC vm68k_instruction
   {
   public:
@@ -140,6 +168,35 @@ namespace vx68k
                                          uint_fast16_t w,
                                          vm68k_context *c);
 
+    /* Type of a text writer of an instruction.  It writes the text of
+       operation word W at PC - 2 in CODE to P, and returns the address
+       of the next instruction.  */
+    typedef vm68k_address_t (*text_function) (vm68k_address_t pc,
+                                              uint_fast16_t w,
+                                              const vm68k_code_image &code,
+                                              char *&p);
+
+    /* Control flow after an instruction.  */
+    enum flow_type
+    {
+      FLOW_NEXT,                /* to the next instruction */
+      FLOW_BRANCH,              /* to the target */
+      FLOW_CONDITIONAL,         /* to the target or the next one */
+      FLOW_CALL,                /* to the target, returning to the next */
+      FLOW_INDIRECT_CALL,       /* to anywhere, returning to the next */
+      FLOW_INDIRECT,            /* to an address known only at run time */
+      FLOW_RETURN,              /* back from an exception */
+      FLOW_ILLEGAL              /* to the illegal instruction exception */
+    };
+
+    /* Type of a control flow function of an instruction.  It returns
+       the control flow after operation word W at PC - 2 in CODE, and
+       sets TARGET if the flow has a target known before run time.  */
+    typedef flow_type (*flow_function) (vm68k_address_t pc,
+                                        uint_fast16_t w,
+                                        const vm68k_code_image &code,
+                                        vm68k_address_t &target);
+
   public:
     friend bool operator== (const vm68k_instruction &x,
                             const vm68k_instruction &y)
@@ -152,6 +209,11 @@ namespace vx68k
     vm68k_instruction (function func);
 
   public:
+    function func () const
+    {
+      return _func;
+    }
+
     vm68k_address_t operator() (vm68k_address_t pc, uint_fast16_t w,
                                 vm68k_context *c) const
     {
@@ -168,6 +230,22 @@ namespace vx68k
     return !(x == y);
   }
 
+  /**
+   * Host function that stands for guest instructions, such as the
+   * TRAP or line A instructions of an emulated operating system.
+   */
+  class VM68K_PUBLIC vm68k_host_call
+  {
+  public:
+    virtual ~vm68k_host_call ();
+
+  public:
+    /* Executes operation word W.  PC is the address after the
+       operation word.  Returns the address of the next instruction.  */
+    virtual vm68k_address_t operator() (vm68k_address_t pc, uint_fast16_t w,
+                                        vm68k_context &c) = 0;
+  };
+
   /* Decodes and executes an instruction sequence.  */
   class VM68K_PUBLIC vm68k_instruction_decoder
   {
@@ -177,6 +255,37 @@ namespace vx68k
       uint_least16_t code;
       uint_least16_t mask;
       vm68k_instruction::function func;
+      vm68k_instruction::text_function text;
+
+      /* Control flow function, or null for FLOW_NEXT.  */
+      vm68k_instruction::flow_function flow;
+    };
+
+    /* Handler for a pair of instructions.  FUNC replaces FIRST for the
+       operation words that match CODE outside MASK, and executes the
+       next instruction too if its operation word matches NEXT_CODE
+       outside NEXT_MASK.  */
+    struct fused_spec
+    {
+      uint_least16_t code;
+      uint_least16_t mask;
+      vm68k_instruction::function first;
+      uint_least16_t next_code;
+      uint_least16_t next_mask;
+      vm68k_instruction::function func;
+    };
+
+    /* Number of low bits of the operation word that select an entry in
+       a block of the compact dispatch tables.  */
+    static const int COMPACT_SHIFT = 6;
+
+    /* Number of times an operation word was followed by another, as
+       printed by vm68k-trace -p.  */
+    struct pair_count
+    {
+      uint_least16_t first;
+      uint_least16_t second;
+      unsigned long count;
     };
 
   private:
@@ -197,6 +306,14 @@ namespace vx68k
     static void insert_inst14 (vm68k_instruction_decoder *p);
     static void insert_inst15 (vm68k_instruction_decoder *p);
 
+    /* Inserts the handlers specialized for single operation words if
+       they are enabled at build time.  */
+    static void insert_special (vm68k_instruction_decoder *p);
+
+    /* Fused handlers.  */
+    static const fused_spec fused[];
+    static const std::size_t fused_size;
+
   public:
     vm68k_instruction_decoder ();
     virtual ~vm68k_instruction_decoder ();
@@ -216,10 +333,122 @@ namespace vx68k
         }
     }
 
-    /* Starts the program.  */
+    /* Sets the idle loop detection.  A backward branch within SIZE
+       bytes that is taken COUNT times in a row without any change to
+       the registers or memory is taken as an idle loop, and the run
+       loop waits for an interrupt there.  Zero SIZE disables the
+       detection, which is the default.  */
+    void set_idle_loop (uint_fast16_t size, unsigned int count);
+
+    /* Binds the operation words that match CODE outside MASK to host
+       function CALL.  The call is made directly from the run loop
+       without a C++ exception.  CALL is not owned by the decoder.  */
+    void insert_host_call (uint_fast16_t code, uint_fast16_t mask,
+                           vm68k_host_call *call);
+
+    /* Installs fused handlers for the operation word pairs in the
+       range [FIRST, LAST) that were counted at least MIN_COUNT times.
+       Only the pairs of the built-in catalogue whose first handler is
+       still in place are fused.  Returns the number of operation words
+       newly fused.  */
+    std::size_t fuse (const pair_count *first, const pair_count *last,
+                      unsigned long min_count);
+
+    /* Same as above but reads the pairs as text from STREAM.  */
+    std::size_t fuse (std::FILE *stream, unsigned long min_count);
+
+    /* Restores the handlers replaced by fused ones.  */
+    void unfuse ();
+
+    /* Switches between the flat dispatch table, which has a handler
+       for each operation word, and the compact dispatch tables.  The
+       compact ones index a block of handler numbers by the high bits
+       of the operation word, and blocks with the same contents are
+       shared, so they take tens of kilobytes instead of the hundreds
+       of the flat table.  Handlers set later are kept in both, and
+       switching to the compact tables again shares the blocks anew.
+       The flat table is the default, as the compact tables save memory
+       but run slower even over many operation words.  */
+    void set_compact (bool compact);
+
+    bool compact () const
+    {
+      return _compact;
+    }
+
+    /* Returns the size in bytes of the compact dispatch tables, or
+       zero if they are not used.  */
+    std::size_t compact_size () const;
+
+    /* Sets a breakpoint at address ADDR.  While any breakpoint is set,
+       the run loop checks the address of each instruction before it
+       is dispatched, so the breakpoint holds for whatever code is at
+       ADDR when it is reached.  A run returns at a breakpoint with the
+       stop reason STOP_BREAKPOINT, and the next run from there
+       executes the instruction.  C is not used.  */
+    void set_breakpoint (const vm68k_context &c, vm68k_address_t addr);
+
+    /* Removes the breakpoint at address ADDR.  */
+    void remove_breakpoint (vm68k_address_t addr);
+
+    /* Returns true if a breakpoint is set at address ADDR.  */
+    bool breakpoint (vm68k_address_t addr) const
+    {
+      return _breakpoints.find (addr) != _breakpoints.end ();
+    }
+
+    /* Sets the code compiled ahead of time that runs in place of the
+       instructions it has blocks for.  It is used only without
+       breakpoints, trace buffers, performance profiles or journals.
+       CODE is not owned by the decoder and may be null.  */
+    void set_compiled_code (const vm68k_compiled_code *code)
+    {
+      _compiled = code;
+    }
+
+    const vm68k_compiled_code *compiled_code () const
+    {
+      return _compiled;
+    }
+
+    /* Sets the cache of decoded blocks that runs in place of the
+       instructions it has blocks for, under the same conditions as the
+       compiled code, which is used instead if both are set.  CACHE is
+       not owned by the decoder and may be null.  */
+    void set_translation_cache (const vm68k_translation_cache *cache)
+    {
+      _cache = cache;
+    }
+
+    const vm68k_translation_cache *translation_cache () const
+    {
+      return _cache;
+    }
+
+    /* Starts the program.  The program runs until it stops at a
+       breakpoint or a stop is requested.  */
     vm68k_address_t run (vm68k_address_t pc, vm68k_context &c) const
       throw (vm68k_exception);
 
+    /* Runs the program for a slice of at most COUNT instructions and
+       returns the address of the next instruction.  Posted writes are
+       delivered at the end of the slice.  A fused pair counts as one
+       instruction.  */
+    vm68k_address_t run (vm68k_address_t pc, vm68k_context &c,
+                         unsigned long count) const
+      throw (vm68k_exception);
+
+  private:
+    /* Runs a slice with the loop that checks breakpoints only if any
+       is set.  */
+    template<class Tracer, bool Compact>
+    vm68k_address_t run_tracer (vm68k_address_t pc, vm68k_context &c,
+                                unsigned long count, Tracer &t) const;
+
+    template<class Tracer, bool Compact, bool Breakpoints>
+    vm68k_address_t run_slice (vm68k_address_t pc, vm68k_context &c,
+                               unsigned long count, Tracer &t) const;
+
   protected:
     /* Dispatches for instruction handlers.  */
     vm68k_address_t dispatch (vm68k_address_t pc, uint_fast16_t w,
@@ -228,8 +457,67 @@ namespace vx68k
       return _instruction[w] (pc, w, c);
     }
 
+    /* Same as above but with the compact dispatch tables.  */
+    vm68k_address_t dispatch_compact (vm68k_address_t pc, uint_fast16_t w,
+                                      vm68k_context *c) const
+    {
+      uint_fast32_t i = _block_offset[w >> COMPACT_SHIFT]
+        + (w & ((1U << COMPACT_SHIFT) - 1));
+      return _handlers[_blocks[i]] (pc, w, c);
+    }
+
+    /* Calls the host function for an operation word.  */
+    vm68k_address_t call_host (vm68k_address_t pc, uint_fast16_t w,
+                               vm68k_context *c) const;
+
+  private:
+    /* Stores handler I for operation word CODE in the dispatch
+       tables.  */
+    void store (uint_fast16_t code, const vm68k_instruction &i);
+
+    /* Returns the number of handler I in the compact tables, adding it
+       if not there.  */
+    uint_fast16_t handler_number (const vm68k_instruction &i);
+
+    /* Replaces GENERIC for operation word CODE with FUNC, which is
+       specialized for the word.  Nothing is done if GENERIC is not
+       the handler.  */
+    void specialize (uint_fast16_t code, vm68k_instruction::function generic,
+                     vm68k_instruction::function func);
+
+    /* Fuses operation word W1 for W2.  Returns true if newly fused.  */
+    bool fuse_pair (uint_fast16_t w1, uint_fast16_t w2);
+
   private:
     vm68k_instruction _instruction[0x10000];
+
+    /* Compact dispatch tables.  _block_offset has the offset of the
+       block in _blocks for each value of the high bits, and
+       _block_refs has the number of references to each block.  */
+    bool _compact;
+    std::vector<vm68k_instruction> _handlers;
+    std::map<vm68k_instruction::function, uint_least16_t> _handler_numbers;
+    std::vector<uint_least16_t> _blocks;
+    std::vector<uint_least32_t> _block_offset;
+    std::vector<unsigned int> _block_refs;
+
+    /* Handlers replaced by fused ones.  */
+    std::map<uint_least16_t, vm68k_instruction> _unfused;
+
+    /* Generic handlers replaced by specialized ones.  */
+    std::map<uint_least16_t, vm68k_instruction> _specialized;
+
+    /* Host functions by operation word.  */
+    std::map<uint_least16_t, vm68k_host_call *> _host_calls;
+
+    /* Breakpoint addresses.  */
+    std::set<vm68k_address_t> _breakpoints;
+
+    uint_least16_t _idle_loop_size;
+    unsigned int _idle_loop_count;
+
+    const vm68k_compiled_code *_compiled;
+    const vm68k_translation_cache *_cache;
   };
 }
 
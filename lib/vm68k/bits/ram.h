@@ -0,0 +1,157 @@
+/* -*-c++-*-
+ * ram - memory unit private header for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM68K_RAM_H
+#define _VM68K_RAM_H 1
+
+#include <cstddef>
+
+namespace vx68k
+{
+  /**
+   * Random access memory for a range of guest addresses.  The bytes
+   * are allocated with huge host pages if possible, which reduces
+   * host TLB misses on random guest accesses, and with normal pages
+   * or from the heap otherwise.  All the pages can be accessed
+   * directly.
+   */
+  class VM68K_PUBLIC vm68k_ram : public vm68k_bus::mappable
+  {
+  public:
+    /* How the bytes were allocated.  */
+    enum allocation_type
+    {
+      /* From the heap.  */
+      HEAP =        0,
+      /* Mapped with normal pages and huge pages advised to the host,
+         which may back some of them transparently.  */
+      MAPPED =      1,
+      /* Mapped with huge pages reserved on the host.  */
+      HUGE_PAGES =  2,
+    };
+
+    /* Size of huge pages that are tried.  */
+    static const std::size_t HUGE_PAGE_SIZE = (std::size_t) 1 << 21;
+
+  public:
+    /* Constructs memory for SIZE bytes at guest address BASE.  BASE
+       and SIZE must be multiples of the page size of the bus.  The
+       bytes are cleared.  */
+    vm68k_ram (vm68k_address_t base, std::size_t size);
+    ~vm68k_ram ();
+
+  private:
+    // XXX: These functions are left unimplemented.
+    vm68k_ram (const vm68k_ram &);
+    vm68k_ram &operator= (const vm68k_ram &);
+
+  public:
+    vm68k_address_t base () const
+    {
+      return _base;
+    }
+
+    std::size_t size () const
+    {
+      return _size;
+    }
+
+    allocation_type allocation () const
+    {
+      return _allocation;
+    }
+
+    /* Returns the number of bytes the host currently backs with huge
+       pages.  For memory mapped with normal pages, this is read from
+       the host at each call and may change over time.  */
+    std::size_t huge_page_bytes () const;
+
+  public:
+    uint_fast8_t read8 (vm68k_bus::function_code,
+                        vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      return _bytes[this->offset (addr)];
+    }
+
+    uint_fast16_t read16 (vm68k_bus::function_code,
+                          vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      const unsigned char *p = _bytes + this->offset (addr);
+      return (uint_fast16_t) p[0] << 8 | p[1];
+    }
+
+    uint_fast32_t read32 (vm68k_bus::function_code,
+                          vm68k_address_t addr) const
+      throw (vm68k_bus_error)
+    {
+      const unsigned char *p = _bytes + this->offset (addr);
+      return (uint_fast32_t) p[0] << 24 | (uint_fast32_t) p[1] << 16
+        | (uint_fast32_t) p[2] << 8 | p[3];
+    }
+
+    void write8 (vm68k_bus::function_code, vm68k_address_t addr,
+                 uint_fast8_t value) throw (vm68k_bus_error)
+    {
+      _bytes[this->offset (addr)] = value;
+    }
+
+    void write16 (vm68k_bus::function_code, vm68k_address_t addr,
+                  uint_fast16_t value) throw (vm68k_bus_error)
+    {
+      unsigned char *p = _bytes + this->offset (addr);
+      p[0] = value >> 8;
+      p[1] = value;
+    }
+
+    void write32 (vm68k_bus::function_code, vm68k_address_t addr,
+                  uint_fast32_t value) throw (vm68k_bus_error)
+    {
+      unsigned char *p = _bytes + this->offset (addr);
+      p[0] = value >> 24;
+      p[1] = value >> 16;
+      p[2] = value >> 8;
+      p[3] = value;
+    }
+
+    unsigned char *direct (vm68k_bus::function_code,
+                           vm68k_address_t addr)
+    {
+      return _bytes + this->offset (addr);
+    }
+
+  protected:
+    /* Returns the offset of address ADDR in the bytes.  The bus only
+       passes addresses of the pages this memory is mapped to.  */
+    std::size_t offset (vm68k_address_t addr) const
+    {
+      return (addr & ((1UL << ADDRESS_BIT) - 1)) - _base;
+    }
+
+  private:
+    vm68k_address_t _base;
+    std::size_t _size;
+
+    unsigned char *_bytes;
+    std::size_t _mapped_size;
+    allocation_type _allocation;
+  };
+}
+
+#endif
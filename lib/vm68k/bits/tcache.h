@@ -0,0 +1,184 @@
+/* -*-c++-*-
+ * tcache - translation cache private header for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM68K_TCACHE_H
+#define _VM68K_TCACHE_H 1
+
+#include <cstddef>
+#include <vector>
+
+namespace vx68k
+{
+  /**
+   * Cache of decoded blocks of guest code that can be saved to a file
+   * and mapped by later processes running the same code, so that they
+   * skip walking it.  Each block has the operation words of its
+   * instructions, which index the dispatch table of the decoder, and
+   * their lengths.  A block is used only if the code on the bus has
+   * the same hash as when cached, and it is dropped when the code is
+   * written.  The file is in the byte order and layout of the host
+   * and is rejected by others.
+   */
+  class VM68K_PUBLIC vm68k_translation_cache :
+    public vm68k_bus::code_listener
+  {
+  public:
+    /* Suffix of a cache file added to the name of the guest image.  */
+    static const char *const SUFFIX;
+
+    /* Cached block.  The instructions are COUNT records from FIRST,
+       and HASH is that of the bytes from START to END given by
+       vm68k_compiled_code::hash.  */
+    struct block_record
+    {
+      uint_least32_t start;
+      uint_least32_t end;
+      uint_least32_t first;
+      uint_least32_t count;
+      unsigned long long hash;
+    };
+
+    /* Cached instruction.  */
+    struct instruction_record
+    {
+      uint_least16_t word;
+      uint_least16_t length;
+    };
+
+  public:
+    vm68k_translation_cache ();
+    ~vm68k_translation_cache ();
+
+  private:
+    // XXX: These functions are left unimplemented.
+    vm68k_translation_cache (const vm68k_translation_cache &);
+    vm68k_translation_cache &operator= (const vm68k_translation_cache &);
+
+  public:
+    /* Fills the cache anew with the blocks of G.  The code must have
+       been added to G.  */
+    void build (const vm68k_control_flow_graph &g);
+
+    /* Writes the blocks to file NAME.  */
+    bool save (const char *name) const;
+
+    /* Maps file NAME written by save, or reads it if it cannot be
+       mapped.  Returns false if it cannot be read or is not a valid
+       cache for this host.  */
+    bool open (const char *name);
+
+    /* Unbinds and empties the cache.  */
+    void close ();
+
+    std::size_t block_count () const
+    {
+      return _block_count;
+    }
+
+    /* Enables the blocks whose code in function code FUNC on BUS has
+       the same hash as when cached and decodes to their instruction
+       records, and marks the code of the blocks so that writes drop
+       them.  Returns the number of blocks enabled.  BUS must outlive
+       the binding.  */
+    std::size_t bind (vm68k_bus *bus, vm68k_bus::function_code func);
+
+    /* Disables all the blocks.  */
+    void unbind ();
+
+    /* Returns the number of blocks enabled.  */
+    std::size_t enabled_block_count () const
+    {
+      return _enabled.size ();
+    }
+
+    /* Runs the enabled block at PC with HANDLERS, the dispatch table
+       of the decoder, and sets NEXT to the address of the next
+       instruction.  Returns false if there is no block at PC.  */
+    bool run (vm68k_address_t pc, vm68k_context *c,
+              const vm68k_instruction *handlers, vm68k_compiled_frame *f,
+              vm68k_address_t &next) const
+    {
+      if (_table.empty ())
+        {
+          return false;
+        }
+
+      std::size_t mask = _table.size () - 1;
+      for (std::size_t i = (pc >> 1) * 0x9e3779b1U & mask; ;
+           i = (i + 1) & mask)
+        {
+          const block_record *b = _table[i];
+          if (b == NULL)
+            {
+              return false;
+            }
+          if (b->start == pc)
+            {
+              f->enter (&_drops);
+              next = this->run_block (*b, c, handlers, f);
+              return true;
+            }
+        }
+    }
+
+    void code_written (vm68k_bus::function_code func, vm68k_address_t addr,
+                       int size);
+
+  protected:
+    /* Runs block B.  */
+    vm68k_address_t run_block (const block_record &b, vm68k_context *c,
+                               const vm68k_instruction *handlers,
+                               vm68k_compiled_frame *f) const;
+
+    /* Returns true if the instruction records of block B are those
+       that D decodes from CODE.  */
+    bool decoded_as (const vm68k_disassembler &d,
+                     const vm68k_code_image &code,
+                     const block_record &b) const;
+
+    /* Sets the records to those in SIZE bytes at DATA.  Returns false
+       if they are not valid.  */
+    bool set_records (const unsigned char *data, std::size_t size);
+
+    /* Rebuilds the lookup table from the enabled blocks.  */
+    void rehash ();
+
+  private:
+    /* Records built or read, or the mapped file.  */
+    std::vector<block_record> _built_blocks;
+    std::vector<instruction_record> _built_instructions;
+    std::vector<unsigned char> _data;
+    void *_mapping;
+    std::size_t _mapping_size;
+
+    const block_record *_blocks;
+    std::size_t _block_count;
+    const instruction_record *_instructions;
+
+    vm68k_bus *_bus;
+
+    /* Indices of the enabled blocks.  */
+    std::vector<uint_least32_t> _enabled;
+    unsigned long _drops;
+
+    /* Open addressing table of the enabled blocks.  */
+    std::vector<const block_record *> _table;
+  };
+}
+
+#endif
@@ -0,0 +1,145 @@
+/* -*-c++-*-
+ * trace - trace unit private header for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM68K_TRACE_H
+#define _VM68K_TRACE_H 1
+
+#include <cstddef>
+#include <cstdio>
+
+namespace vx68k
+{
+  /**
+   * Binary trace record.
+   */
+  struct vm68k_trace_record
+  {
+    enum kind_type
+    {
+      /* ADDRESS is the PC and VALUE is the operation word.  */
+      INSTRUCTION = 0,
+      /* ADDRESS is the register number and VALUE is the new value.
+         Register number REGISTER_SR is for the status register.  */
+      REGISTER =    1,
+      /* ADDRESS and VALUE are of a store of SIZE bytes.  */
+      STORE =       2,
+    };
+
+    static const uint_fast32_t REGISTER_SR = 16;
+
+    uint_least32_t address;
+    uint_least32_t value;
+    uint_least8_t kind;
+    uint_least8_t size;
+  };
+
+  /**
+   * Lock-free ring buffer of trace records.  Only the running thread
+   * may append records, and only one other thread may read them at
+   * the same time.  The oldest records are overwritten when the
+   * buffer is full.
+   */
+  class VM68K_PUBLIC vm68k_trace_buffer
+  {
+  public:
+    /* Options.  */
+    enum
+    {
+      /* Records changed registers after each instruction.  */
+      REGISTERS = 1U << 0,
+      /* Records stores to memory.  */
+      STORES =    1U << 1,
+    };
+
+    /* Size of a record in a trace file.  */
+    static const std::size_t RECORD_SIZE = 12;
+
+  public:
+    /* Constructs a buffer that holds CAPACITY records.  CAPACITY is
+       rounded up to a power of two, one record of which is kept for
+       the one being appended.  */
+    explicit vm68k_trace_buffer (std::size_t capacity,
+                                 unsigned int options = 0);
+    ~vm68k_trace_buffer ();
+
+  private:
+    // XXX: These functions are left unimplemented.
+    vm68k_trace_buffer (const vm68k_trace_buffer &);
+    vm68k_trace_buffer &operator= (const vm68k_trace_buffer &);
+
+  public:
+    unsigned int options () const
+    {
+      return _options;
+    }
+
+    /* Appends a record.  */
+    void append (int kind, int size, uint_fast32_t address,
+                 uint_fast32_t value)
+    {
+      vm68k_trace_record *r = _records + (_head & _mask);
+      r->address = address;
+      r->value = value;
+      r->kind = kind;
+      r->size = size;
+#if defined __ATOMIC_RELEASE
+      __atomic_store_n (&_head, _head + 1, __ATOMIC_RELEASE);
+#else
+#if __GNUC__
+      __sync_synchronize ();
+#endif
+      _head = _head + 1;
+#endif
+    }
+
+    /* Reads at most N records into the array starting at FIRST, and
+       returns the number of records read.  */
+    std::size_t read (vm68k_trace_record *first, std::size_t n);
+
+    /* Returns the number of records that were overwritten before they
+       were read.  */
+    unsigned long lost () const
+    {
+      return _lost;
+    }
+
+    /* Reads all the records and writes them to STREAM in the trace
+       file format.  Returns the number of records written.  */
+    std::size_t save (std::FILE *stream);
+
+  private:
+    vm68k_trace_record *_records;
+    unsigned long _mask;
+    volatile unsigned long _head;
+    unsigned long _tail;
+    unsigned long _lost;
+    unsigned int _options;
+  };
+
+  /* Writes the header of a trace file to STREAM.  */
+  VM68K_PUBLIC bool vm68k_write_trace_header (std::FILE *stream);
+
+  /* Reads and checks the header of a trace file from STREAM.  */
+  VM68K_PUBLIC bool vm68k_read_trace_header (std::FILE *stream);
+
+  /* Reads a record from a trace file.  */
+  VM68K_PUBLIC bool vm68k_read_trace_record (std::FILE *stream,
+                                             vm68k_trace_record *r);
+}
+
+#endif
@@ -0,0 +1,291 @@
+/* vm68k-bench - dispatch benchmark for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <vm68k/processor>
+#include <vm68k/disasm>
+#include <vm68k/ram>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+using namespace std;
+using namespace vx68k;
+
+namespace
+{
+  using vx68k::uint_fast16_t;   // avoid ambiguity
+
+  /* Bus with memory in the whole address space.  */
+  class memory_bus : public vm68k_bus
+  {
+  public:
+    memory_bus ()
+      : _ram (0, PAGE_SIZE * NPAGES)
+    {
+      this->map_pages (0x66, 0, PAGE_SIZE * NPAGES, &_ram);
+    }
+
+    const vm68k_ram &ram () const
+    {
+      return _ram;
+    }
+
+  private:
+    vm68k_ram _ram;
+  };
+
+  /* Names of the RAM allocations.  */
+  const char *const allocation_names[] =
+    {
+      "heap", "normal pages", "huge pages",
+    };
+
+  /* Result of a run.  */
+  struct result
+  {
+    double seconds;
+    unsigned long count;
+    vm68k_address_t pc;
+    uint_least32_t reg[vm68k_context::REGISTER_MAX];
+    bool failed;
+    vm68k_ram::allocation_type allocation;
+    size_t huge_page_bytes;
+  };
+
+  /* Returns the length of the instruction at ADDR in CODE if it goes
+     to the next one and has only register and immediate operands, so
+     that it neither touches memory nor raises an exception, or zero
+     otherwise.  */
+  size_t register_only_length (const vm68k_disassembler &disassembler,
+                               const vm68k_code_image &code,
+                               vm68k_address_t addr)
+  {
+    // STOP is left out as it waits for an interrupt that never comes.
+    uint_fast16_t w = code.fetch_word (addr);
+    vm68k_address_t next, target;
+    if (!disassembler.known (w) || w == 0x4e72
+        || disassembler.flow (code, addr, next, target)
+           != vm68k_instruction::FLOW_NEXT)
+      {
+        return 0;
+      }
+
+    // Memory operands are written with '@' or as bare addresses.
+    char text[vm68k_disassembler::TEXT_MAX];
+    disassembler.disassemble (code, addr, text, sizeof text);
+    const char *p = strchr (text, ' ');
+    if (p == NULL || strchr (p, '@') != NULL)
+      {
+        return 0;
+      }
+    while (p != NULL)
+      {
+        ++p;
+        if (*p != '%' && *p != '#')
+          {
+            return 0;
+          }
+        p = strchr (p, ',');
+      }
+    return next - addr;
+  }
+
+  /* Makes an image of about SIZE bytes at address ADDR.  It has random
+     instructions from register_only_length, followed by a jump back to
+     ADDR, so that the run spreads over many operation words instead of
+     the few of a short loop.  */
+  vector<unsigned char> random_image (vm68k_address_t addr, size_t size)
+  {
+    vm68k_disassembler disassembler;
+    vector<unsigned char> image;
+    srand (1);
+    for (;;)
+      {
+        unsigned char buf[10];
+        for (size_t i = 0; i != sizeof buf; ++i)
+          {
+            buf[i] = rand () >> 4;
+          }
+        vm68k_code_image code (addr + image.size (), buf, sizeof buf);
+        size_t length = register_only_length (disassembler, code,
+                                              code.base ());
+        if (image.size () + length + 6 > size)
+          {
+            break;
+          }
+        image.insert (image.end (), buf + 0, buf + length);
+      }
+
+    // JMP (xxx).L to the start.
+    image.push_back (0x4e);
+    image.push_back (0xf9);
+    for (int shift = 24; shift >= 0; shift -= 8)
+      {
+        image.push_back (addr >> shift);
+      }
+    return image;
+  }
+
+  /* Runs COUNT instructions of IMAGE at address ADDR.  */
+  result run (const vm68k_instruction_decoder &decoder,
+              const vector<unsigned char> &image, vm68k_address_t addr,
+              unsigned long count)
+  {
+    memory_bus bus;
+    if (!image.empty ())
+      {
+        bus.write (vm68k_bus::SUPER_DATA, addr, &image[0], image.size ());
+      }
+
+    vm68k_context c (&bus);
+    c.set_exception_processing (true);
+    c.write_reg (vm68k_data_size::LONG_WORD, vm68k_context::SP, addr);
+
+    result r;
+    r.count = 0;
+    r.failed = false;
+    vm68k_address_t pc = addr;
+    clock_t start = clock ();
+    try
+      {
+        pc = decoder.run (pc, c, count);
+        r.count = count;
+      }
+    catch (const vm68k_exception &e)
+      {
+        fprintf (stderr, "vm68k-bench: exception %u at %#lx\n",
+                 (unsigned int) e.vecno (), (unsigned long) e.pc ());
+        r.failed = true;
+        pc = e.pc ();
+      }
+    r.seconds = (double) (clock () - start) / CLOCKS_PER_SEC;
+    r.allocation = bus.ram ().allocation ();
+    r.huge_page_bytes = bus.ram ().huge_page_bytes ();
+
+    r.pc = pc;
+    for (int i = 0; i != vm68k_context::REGISTER_MAX; ++i)
+      {
+        r.reg[i] = c.read_reg_unsigned (vm68k_data_size::LONG_WORD, i);
+      }
+    return r;
+  }
+
+  void print_result (const char *name, size_t table_size, const result &r)
+  {
+    printf ("%-8s %8lu %12lu %9.3f %9.2f\n", name,
+            (unsigned long) (table_size + 1023) / 1024, r.count, r.seconds,
+            r.seconds > 0.0 ? r.count / r.seconds / 1e6 : 0.0);
+  }
+
+  bool same (const result &x, const result &y)
+  {
+    return x.pc == y.pc
+      && memcmp (x.reg, y.reg, sizeof x.reg) == 0;
+  }
+
+  void usage ()
+  {
+    fprintf (stderr, "usage: vm68k-bench [-n COUNT] [-a ADDRESS] FILE\n");
+    fprintf (stderr, "       vm68k-bench [-n COUNT] [-a ADDRESS] -r SIZE\n");
+  }
+}
+
+int main (int argc, char **argv)
+{
+  unsigned long count = 10000000;
+  vm68k_address_t addr = 0x1000;
+  size_t random_size = 0;
+
+  int i = 1;
+  for (; i + 1 < argc && argv[i][0] == '-'; i += 2)
+    {
+      if (strcmp (argv[i], "-n") == 0)
+        {
+          count = strtoul (argv[i + 1], NULL, 0);
+        }
+      else if (strcmp (argv[i], "-a") == 0)
+        {
+          addr = strtoul (argv[i + 1], NULL, 0) & ~1UL;
+        }
+      else if (strcmp (argv[i], "-r") == 0)
+        {
+          random_size = strtoul (argv[i + 1], NULL, 0);
+        }
+      else
+        {
+          usage ();
+          return EXIT_FAILURE;
+        }
+    }
+  if (i + (random_size == 0) != argc)
+    {
+      usage ();
+      return EXIT_FAILURE;
+    }
+
+  vector<unsigned char> image;
+  if (random_size != 0)
+    {
+      image = random_image (addr, random_size);
+    }
+  else
+    {
+      // The file is a raw image of the code to run.
+      FILE *stream = fopen (argv[i], "rb");
+      if (stream == NULL)
+        {
+          perror (argv[i]);
+          return EXIT_FAILURE;
+        }
+      int c;
+      while ((c = getc (stream)) != EOF)
+        {
+          image.push_back (c);
+        }
+      fclose (stream);
+    }
+
+  vm68k_instruction_decoder decoder;
+  size_t flat_size = sizeof (vm68k_instruction) * 0x10000;
+  result flat = run (decoder, image, addr, count);
+
+  decoder.set_compact (true);
+  size_t compact_size = decoder.compact_size ();
+  result compact = run (decoder, image, addr, count);
+
+  printf ("%-8s %8s %12s %9s %9s\n", "dispatch", "KiB", "instructions",
+          "seconds", "Minst/s");
+  print_result ("flat", flat_size, flat);
+  print_result ("compact", compact_size, compact);
+  printf ("RAM: %s, %lu KiB in huge pages\n",
+          allocation_names[compact.allocation],
+          (unsigned long) compact.huge_page_bytes / 1024);
+
+  if (!same (flat, compact))
+    {
+      fprintf (stderr, "vm68k-bench: runs ended in different states\n");
+      return EXIT_FAILURE;
+    }
+  return flat.failed || compact.failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
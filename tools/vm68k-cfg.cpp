@@ -0,0 +1,164 @@
+/* vm68k-cfg - control flow graph builder for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <vm68k/aot>
+#include <vm68k/tcache>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace vx68k;
+
+namespace
+{
+  /* Reads the whole of file NAME into DATA.  */
+  bool read_file (const char *name, vector<unsigned char> &data)
+  {
+    FILE *stream = fopen (name, "rb");
+    if (stream == NULL)
+      {
+        perror (name);
+        return false;
+      }
+
+    unsigned char buf[4096];
+    size_t n;
+    while ((n = fread (buf, 1, sizeof buf, stream)) != 0)
+      {
+        data.insert (data.end (), buf, buf + n);
+      }
+    bool ok = !ferror (stream);
+    if (!ok)
+      {
+        perror (name);
+      }
+    fclose (stream);
+    return ok;
+  }
+
+  void usage ()
+  {
+    fprintf (stderr,
+             "usage: vm68k-cfg [-t | -p | -s | -c] FILE BASE [ENTRY...]\n");
+  }
+}
+
+/* Builds the control flow graph of a raw code image loaded at BASE,
+   walking from the entries or BASE if none.  It writes the graph in
+   DOT, with the instructions if -t is given, or the operation word
+   pairs in the format vm68k_instruction_decoder::fuse reads if -p is
+   given, or the source of the blocks compiled ahead of time for
+   vm68k_compiled_code if -s is given.  With -c it writes the blocks
+   to a translation cache file next to FILE instead.  */
+int main (int argc, char **argv)
+{
+  bool text = false;
+  bool pairs = false;
+  bool source = false;
+  bool cache = false;
+  int first = 1;
+  if (argc > 1 && strcmp (argv[1], "-t") == 0)
+    {
+      text = true;
+      ++first;
+    }
+  else if (argc > 1 && strcmp (argv[1], "-p") == 0)
+    {
+      pairs = true;
+      ++first;
+    }
+  else if (argc > 1 && strcmp (argv[1], "-s") == 0)
+    {
+      source = true;
+      ++first;
+    }
+  else if (argc > 1 && strcmp (argv[1], "-c") == 0)
+    {
+      cache = true;
+      ++first;
+    }
+
+  if (argc - first < 2)
+    {
+      usage ();
+      return EXIT_FAILURE;
+    }
+
+  vector<unsigned char> data;
+  if (!read_file (argv[first], data))
+    {
+      return EXIT_FAILURE;
+    }
+  vm68k_address_t base = strtoul (argv[first + 1], NULL, 0);
+
+  vm68k_disassembler d;
+  vm68k_control_flow_graph g (&d);
+  g.add_code (base, data.empty () ? NULL : &data[0], data.size ());
+  if (argc - first == 2)
+    {
+      g.add_entry (base);
+    }
+  for (int i = first + 2; i < argc; ++i)
+    {
+      g.add_entry (strtoul (argv[i], NULL, 0));
+    }
+  g.build ();
+
+  if (pairs)
+    {
+      vector<vm68k_instruction_decoder::pair_count> v;
+      g.pair_counts (v);
+      for (vector<vm68k_instruction_decoder::pair_count>::const_iterator i
+             = v.begin (); i != v.end (); ++i)
+        {
+          printf ("%04x %04x %lu\n", (unsigned int) i->first,
+                  (unsigned int) i->second, i->count);
+        }
+    }
+  else if (source)
+    {
+      vm68k_compiled_code::write_source (stdout, g);
+    }
+  else if (cache)
+    {
+      string name = string (argv[first]) + vm68k_translation_cache::SUFFIX;
+      vm68k_translation_cache c;
+      c.build (g);
+      if (!c.save (name.c_str ()))
+        {
+          perror (name.c_str ());
+          return EXIT_FAILURE;
+        }
+    }
+  else
+    {
+      g.write_dot (stdout, text);
+    }
+
+  fprintf (stderr, "%lu blocks, %lu functions\n",
+           (unsigned long) g.blocks ().size (),
+           (unsigned long) g.functions ().size ());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,232 @@
+/* vm68k-trace - trace file decoder for Virtual M68000 Toolkit
+ * Copyright (C) 1998-2008 Hypercore Software Design, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <vm68k/trace>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace vx68k;
+
+namespace
+{
+  const char *const register_names[] =
+    {
+      "d0", "d1", "d2", "d3", "d4", "d5", "d6", "d7",
+      "a0", "a1", "a2", "a3", "a4", "a5", "a6", "sp",
+      "sr",
+    };
+
+  /* Prints a trace record as text.  */
+  void print_record (const vm68k_trace_record &r)
+  {
+    switch (r.kind)
+      {
+      case vm68k_trace_record::INSTRUCTION:
+        printf ("%08lx  %04lx\n", (unsigned long) r.address,
+                (unsigned long) r.value);
+        break;
+
+      case vm68k_trace_record::REGISTER:
+        if (r.address <= vm68k_trace_record::REGISTER_SR)
+          {
+            printf ("\t%%%s = %#lx\n", register_names[r.address],
+                    (unsigned long) r.value);
+          }
+        break;
+
+      case vm68k_trace_record::STORE:
+        printf ("\t%#lx <- %#lx (%u)\n", (unsigned long) r.address,
+                (unsigned long) r.value, (unsigned int) r.size);
+        break;
+
+      default:
+        printf ("\t? kind %u\n", (unsigned int) r.kind);
+        break;
+      }
+  }
+
+  /* Operation word pair counts.  */
+  typedef map<pair<unsigned int, unsigned int>, unsigned long> pair_map;
+
+  /* True if pairs are counted instead of printing records.  */
+  bool count_pairs = false;
+
+  pair_map pairs;
+
+  /* Operation word counts.  */
+  typedef map<unsigned int, unsigned long> word_map;
+
+  /* True if operation words are counted instead of printing records.  */
+  bool count_words = false;
+
+  word_map words;
+
+  /* Counts consecutive instruction records.  */
+  void count_record (const vm68k_trace_record &r, long *last)
+  {
+    if (r.kind != vm68k_trace_record::INSTRUCTION)
+      {
+        return;
+      }
+
+    unsigned int w = r.value & 0xffffU;
+    if (count_words)
+      {
+        ++words[w];
+        return;
+      }
+    if (*last >= 0)
+      {
+        ++pairs[make_pair ((unsigned int) *last, w)];
+      }
+    *last = w;
+  }
+
+  template<class T>
+  bool more_frequent (const T *x, const T *y)
+  {
+    return x->second > y->second;
+  }
+
+  /* Prints the pair counts in the format vm68k_instruction_decoder::fuse
+     reads, most frequent first.  */
+  void print_pairs ()
+  {
+    vector<const pair_map::value_type *> v;
+    for (pair_map::const_iterator i = pairs.begin (); i != pairs.end (); ++i)
+      {
+        v.push_back (&*i);
+      }
+    stable_sort (v.begin (), v.end (), &more_frequent<pair_map::value_type>);
+
+    for (vector<const pair_map::value_type *>::const_iterator i = v.begin ();
+         i != v.end (); ++i)
+      {
+        printf ("%04x %04x %lu\n", (*i)->first.first, (*i)->first.second,
+                (*i)->second);
+      }
+  }
+
+  /* Prints the operation word counts, most frequent first, to choose
+     the words to specialize.  */
+  void print_words ()
+  {
+    vector<const word_map::value_type *> v;
+    for (word_map::const_iterator i = words.begin (); i != words.end (); ++i)
+      {
+        v.push_back (&*i);
+      }
+    stable_sort (v.begin (), v.end (), &more_frequent<word_map::value_type>);
+
+    for (vector<const word_map::value_type *>::const_iterator i = v.begin ();
+         i != v.end (); ++i)
+      {
+        printf ("%04x %lu\n", (*i)->first, (*i)->second);
+      }
+  }
+
+  void print_counts ()
+  {
+    if (count_pairs)
+      {
+        print_pairs ();
+      }
+    if (count_words)
+      {
+        print_words ();
+      }
+  }
+
+  int decode (FILE *stream, const char *name)
+  {
+    if (!vm68k_read_trace_header (stream))
+      {
+        fprintf (stderr, "%s: not a trace file\n", name);
+        return EXIT_FAILURE;
+      }
+
+    long last = -1;
+    vm68k_trace_record r;
+    while (vm68k_read_trace_record (stream, &r))
+      {
+        if (count_pairs || count_words)
+          {
+            count_record (r, &last);
+          }
+        else
+          {
+            print_record (r);
+          }
+      }
+
+    return EXIT_SUCCESS;
+  }
+}
+
+int main (int argc, char **argv)
+{
+  int first = 1;
+  if (argc > 1 && strcmp (argv[1], "-p") == 0)
+    {
+      count_pairs = true;
+      ++first;
+    }
+  else if (argc > 1 && strcmp (argv[1], "-c") == 0)
+    {
+      count_words = true;
+      ++first;
+    }
+
+  if (first == argc)
+    {
+      int status = decode (stdin, "(stdin)");
+      print_counts ();
+      return status;
+    }
+
+  int status = EXIT_SUCCESS;
+  for (int i = first; i != argc; ++i)
+    {
+      FILE *stream = fopen (argv[i], "rb");
+      if (stream == NULL)
+        {
+          perror (argv[i]);
+          status = EXIT_FAILURE;
+          continue;
+        }
+
+      if (decode (stream, argv[i]) != EXIT_SUCCESS)
+        {
+          status = EXIT_FAILURE;
+        }
+      fclose (stream);
+    }
+
+  print_counts ();
+  return status;
+}